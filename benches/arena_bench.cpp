@@ -0,0 +1,46 @@
+#include "bench.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+
+using namespace mu;
+
+struct Small {
+  u64 a;
+  u64 b;
+  u32 c;
+};
+
+/// Number of small objects allocated per simulated request.
+static constexpr usize OBJECTS = 4096;
+static constexpr usize ITERS   = 500;
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  Small*          objs[OBJECTS];
+
+  bench::run("CAllocator: create/destroy small objects", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      objs[i]    = c_allocator.create<Small>();
+      objs[i]->a = i;
+    }
+    for (usize i = 0; i < OBJECTS; i++) {
+      bench::doNotOptimize(objs[i]->a);
+      c_allocator.destroy(objs[i]);
+    }
+  });
+
+  mem::ArenaAllocator arena{&c_allocator};
+  bench::run("ArenaAllocator: create small objects + reset", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      objs[i]    = arena.create<Small>();
+      objs[i]->a = i;
+    }
+    for (usize i = 0; i < OBJECTS; i++) {
+      bench::doNotOptimize(objs[i]->a);
+    }
+    arena.reset();
+  });
+
+  return 0;
+}
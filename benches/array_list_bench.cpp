@@ -0,0 +1,60 @@
+#include "bench.h"
+#include "mu/array_list.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+#include <string>
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize LEN   = 100000;
+static constexpr usize ITERS = 500;
+
+int main(void) {
+  bench::run("std::vector<u64>: push_back", ITERS, [] {
+    std::vector<u64> vec{};
+    for (u64 i = 0; i < LEN; i++) {
+      vec.push_back(i);
+    }
+    bench::doNotOptimize(vec.data());
+  });
+
+  bench::run("ArrayList<u64>: append", ITERS, [] {
+    ArrayList<u64> list{};
+    for (u64 i = 0; i < LEN; i++) {
+      list.append(i);
+    }
+    bench::doNotOptimize(list.begin());
+  });
+
+  // The arena grows the list in place, so it is never copied
+  mem::CAllocator backing{};
+  bench::run("ArrayList<u64> (arena): append", ITERS, [&] {
+    mem::ArenaAllocator            arena{&backing, LEN * sizeof(u64) * 2};
+    ArrayList<u64, mem::Allocator> list{&arena};
+    for (u64 i = 0; i < LEN; i++) {
+      list.append(i);
+    }
+    bench::doNotOptimize(list.begin());
+  });
+
+  // Non-trivially copyable items are moved when growing
+  bench::run("std::vector<std::string>: push_back", ITERS / 10, [] {
+    std::vector<std::string> vec{};
+    for (u64 i = 0; i < LEN; i++) {
+      vec.push_back(std::string(1, 'x'));
+    }
+    bench::doNotOptimize(vec.data());
+  });
+
+  bench::run("ArrayList<std::string>: append", ITERS / 10, [] {
+    ArrayList<std::string> list{};
+    for (u64 i = 0; i < LEN; i++) {
+      list.append(std::string(1, 'x'));
+    }
+    bench::doNotOptimize(list.begin());
+  });
+
+  return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef MU_BENCH_H
+#define MU_BENCH_H
+
+#include "mu/primitives.h" // usize, f64, const_cstr
+#include <chrono>          // steady_clock
+#include <cstdio>          // printf
+
+namespace mu::bench {
+
+/// Prevents the compiler from optimizing away `val`.
+template <typename T> inline auto doNotOptimize(T const& val) -> void {
+  asm volatile("" : : "r,m"(val) : "memory");
+}
+
+/// Runs `func` `iters` times and prints the average time per iteration.
+///
+/// Returns the average number of nanoseconds per iteration.
+template <typename F>
+auto run(const_cstr name, usize iters, F&& func) -> f64 {
+  func(); // Warm up
+
+  auto start = std::chrono::steady_clock::now();
+  for (usize i = 0; i < iters; i++) {
+    func();
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  f64  ns  = std::chrono::duration<f64, std::nano>(end - start).count() /
+           static_cast<f64>(iters);
+  std::printf("%-48s %14.2f ns/iter\n", name, ns);
+  return ns;
+}
+
+} // namespace mu::bench
+
+#endif // !MU_BENCH_H
@@ -0,0 +1,128 @@
+#include "bench.h"
+#include "mu/btree_map.h"
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <algorithm>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize KEYS  = usize(1) << 17;
+static constexpr usize SCANS = 1000;
+static constexpr usize WIDTH = 256;
+static constexpr usize ITERS = 5;
+
+using Map = BTreeMap<u64, u64, mem::Allocator>;
+
+/// Inserts `keys` into a `BTreeMap` whose nodes come from a pool.
+static auto buildBTree(const std::vector<u64>& keys) -> void {
+  mem::CAllocator                    backing{};
+  mem::PoolAllocator<Map::NodeBlock> pool{&backing};
+  Map                                map{&pool};
+  for (u64 key : keys) {
+    map.put(key, key);
+  }
+  bench::doNotOptimize(map.len());
+}
+
+static auto buildStd(const std::vector<u64>& keys) -> void {
+  std::map<u64, u64> map{};
+  for (u64 key : keys) {
+    map.emplace(key, key);
+  }
+  bench::doNotOptimize(map.size());
+}
+
+int main(void) {
+  // Distinct keys (spread out, so lookups can miss), in random order
+  std::mt19937_64  rng{42};
+  std::vector<u64> keys(KEYS);
+  for (usize i = 0; i < KEYS; i++) {
+    keys[i] = i * 4;
+  }
+  std::vector<u64> sorted = keys;
+  std::shuffle(keys.begin(), keys.end(), rng);
+
+  std::vector<u64>                   lookups(KEYS);
+  std::vector<u64>                   starts(SCANS);
+  std::uniform_int_distribution<u64> dist{0, KEYS * 4};
+  for (u64& key : lookups) {
+    key = dist(rng);
+  }
+  for (u64& key : starts) {
+    key = dist(rng);
+  }
+
+  bench::run("BTreeMap<u64, u64>: insert 128k random", ITERS,
+             [&] { buildBTree(keys); });
+  bench::run("std::map<u64, u64>: insert 128k random", ITERS,
+             [&] { buildStd(keys); });
+
+  std::vector<Map::Entry> entries{};
+  for (u64 key : sorted) {
+    entries.push_back(Map::Entry{key, key});
+  }
+  Slice<Map::Entry> slice(entries.data(), entries.size());
+  mem::CAllocator   backing{};
+  bench::run("BTreeMap<u64, u64>: bulk load 128k", ITERS, [&] {
+    Map map = Map::fromSorted(&backing, slice);
+    bench::doNotOptimize(map.len());
+  });
+  bench::run("std::map<u64, u64>: insert 128k sorted (hinted)", ITERS, [&] {
+    std::map<u64, u64> map{};
+    for (u64 key : sorted) {
+      map.emplace_hint(map.end(), key, key);
+    }
+    bench::doNotOptimize(map.size());
+  });
+
+  mem::PoolAllocator<Map::NodeBlock> pool{&backing};
+  Map                                btree{&pool};
+  std::map<u64, u64>                 ordered{};
+  for (u64 key : keys) {
+    btree.put(key, key);
+    ordered.emplace(key, key);
+  }
+
+  bench::run("BTreeMap<u64, u64>: 128k lookups", ITERS, [&] {
+    u64 found = 0;
+    for (u64 key : lookups) {
+      found += btree.contains(key);
+    }
+    bench::doNotOptimize(found);
+  });
+  bench::run("std::map<u64, u64>: 128k lookups", ITERS, [&] {
+    u64 found = 0;
+    for (u64 key : lookups) {
+      found += ordered.count(key);
+    }
+    bench::doNotOptimize(found);
+  });
+
+  // Each scan covers `WIDTH` keys' worth of the key space
+  bench::run("BTreeMap<u64, u64>: 1000 range scans", ITERS, [&] {
+    u64 sum = 0;
+    for (u64 start : starts) {
+      for (auto entry : btree.range(start, start + WIDTH * 4)) {
+        sum += entry.val;
+      }
+    }
+    bench::doNotOptimize(sum);
+  });
+  bench::run("std::map<u64, u64>: 1000 range scans", ITERS, [&] {
+    u64 sum = 0;
+    for (u64 start : starts) {
+      auto end = ordered.lower_bound(start + WIDTH * 4);
+      for (auto it = ordered.lower_bound(start); it != end; ++it) {
+        sum += it->second;
+      }
+    }
+    bench::doNotOptimize(sum);
+  });
+  return 0;
+}
@@ -0,0 +1,88 @@
+#include "bench.h"
+#include "mu/bytes.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace mu;
+using namespace mu::internal::bytes;
+
+static constexpr usize LEN   = usize(1) << 20;
+static constexpr usize ITERS = 200;
+
+/// Runs `func` (which scans `LEN` bytes) and prints its throughput.
+template <typename F> static auto throughput(const_cstr name, F&& func) {
+  f64 ns = bench::run(name, ITERS, func);
+  std::printf("%-48s %14.2f GB/s\n", "", static_cast<f64>(LEN) / ns);
+}
+
+int main(void) {
+  // Lines of lowercase words, with no '#', '<' or '>' in them
+  std::mt19937_64   rng{42};
+  std::vector<char> text(LEN + 1);
+  for (usize i = 0; i < LEN; i++) {
+    u64 roll = rng() % 64;
+    text[i]  = (roll == 0)  ? '\n'
+               : (roll < 8) ? ' '
+                            : static_cast<char>('a' + roll % 26);
+  }
+  text[LEN] = '\0';
+  Slice<u8> str(text.data(), LEN);
+
+  throughput("indexOf (not found)", [&] {
+    bench::doNotOptimize(str.indexOf('#').isValid());
+  });
+  throughput("memchr (not found)", [&] {
+    bench::doNotOptimize(std::memchr(text.data(), '#', LEN));
+  });
+  const_cstr names[] = {"indexOf, scalar", "indexOf, SSE2", "indexOf, AVX2",
+                        "indexOf, AVX-512"};
+  for (Isa isa : {Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+    if (isSupported(isa)) {
+      throughput(names[static_cast<usize>(isa)], [&] {
+        bench::doNotOptimize(indexOf(isa, text.data(), LEN, '#'));
+      });
+    }
+  }
+
+  throughput("indexOfAny, 3 bytes (not found)", [&] {
+    bench::doNotOptimize(str.indexOfAny(Slice<u8>("#<>")).isValid());
+  });
+  throughput("strcspn, 3 bytes (not found)", [&] {
+    bench::doNotOptimize(std::strcspn(text.data(), "#<>"));
+  });
+
+  throughput("count('\\n')", [&] { bench::doNotOptimize(str.count('\n')); });
+  throughput("std::count('\\n')", [&] {
+    bench::doNotOptimize(std::count(text.begin(), text.end() - 1, '\n'));
+  });
+
+  throughput("split('\\n')", [&] {
+    usize lines = 0;
+    for (Slice<u8> line : str.split('\n')) {
+      lines += line.len() != 0;
+    }
+    bench::doNotOptimize(lines);
+  });
+  throughput("memchr loop over '\\n'", [&] {
+    usize       lines = 0;
+    const char* pos   = text.data();
+    const char* end   = pos + LEN;
+    for (;;) {
+      auto found = static_cast<const char*>(
+          std::memchr(pos, '\n', usize(end - pos)));
+      if (found == nullptr) {
+        lines += end != pos;
+        break;
+      }
+      lines += found != pos;
+      pos    = found + 1;
+    }
+    bench::doNotOptimize(lines);
+  });
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "bench.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/combinators.h"
+#include "mu/mem/page_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/primitives.h"
+#include <tuple>
+#include <utility>
+
+using namespace mu;
+
+struct alignas(16) Small {
+  u8 bytes[32];
+};
+
+/// small -> pool, medium -> arena, large -> pages
+using SmallAlloc =
+    mem::FallbackAllocator<mem::PoolAllocator<Small>, mem::CAllocator>;
+using MediumAlloc =
+    mem::Segregator<64 * 1024, mem::ArenaAllocator, mem::PageAllocator>;
+using Composed = mem::Segregator<sizeof(Small), SmallAlloc, MediumAlloc>;
+
+/// Number of live allocations per iteration.
+static constexpr usize ALLOCS = 1024;
+static constexpr usize ITERS  = 2000;
+
+/// Returns the size of the `idx`th allocation: mostly small objects, some
+/// medium buffers and the occasional large buffer.
+static auto sizeOf(usize idx) -> usize {
+  if ((idx % 256) == 255) {
+    return 256 * 1024;
+  }
+  if ((idx % 8) == 7) {
+    return 512 + (idx % 7) * 512;
+  }
+  return sizeof(Small);
+}
+
+/// Allocates `ALLOCS` blocks of mixed sizes and frees them in reverse order
+/// (through the static type `A`, so calls can be inlined).
+template <class A> static auto churn(A& allocator) -> void {
+  void* ptrs[ALLOCS];
+  for (usize i = 0; i < ALLOCS; i++) {
+    ptrs[i]                         = allocator.rawAlloc(sizeOf(i), 16);
+    *reinterpret_cast<u8*>(ptrs[i]) = static_cast<u8>(i);
+  }
+  for (usize i = ALLOCS; i > 0; i--) {
+    bench::doNotOptimize(*reinterpret_cast<u8*>(ptrs[i - 1]));
+    allocator.rawFree(ptrs[i - 1], sizeOf(i - 1), 16);
+  }
+}
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  bench::run("CAllocator: mixed sizes", ITERS, [&] { churn(c_allocator); });
+
+  auto     args = std::make_tuple(
+      std::piecewise_construct, std::make_tuple(&c_allocator), std::tuple<>{});
+  Composed composed{std::piecewise_construct, args, args};
+  bench::run("Pool/Arena/Page Segregator: mixed sizes", ITERS, [&] {
+    churn(composed);
+    // The arena only reclaims frees within its current chunk
+    composed.large().small().reset();
+  });
+  return 0;
+}
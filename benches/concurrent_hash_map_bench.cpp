@@ -0,0 +1,139 @@
+#include "bench.h"
+#include "mu/concurrent_hash_map.h"
+#include "mu/hash.h"
+#include "mu/hash_map.h"
+#include "mu/mem/thread_safe_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+/// The naive concurrent map: a `HashMap` behind a single mutex.
+class LockedHashMap {
+public:
+  auto get(u64 key) -> u64 {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    u64*                              val = this->map.get(key);
+    return (val == nullptr) ? 0 : *val;
+  }
+
+  auto put(u64 key, u64 val) -> void {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    this->map.put(key, val);
+  }
+
+private:
+  std::mutex        mutex;
+  HashMap<u64, u64> map;
+};
+
+using Concurrent = ConcurrentHashMap<u64, u64, mem::Allocator>;
+
+static constexpr usize KEYS           = 1 << 18;
+static constexpr usize OPS_PER_THREAD = 1 << 20;
+static constexpr usize BATCH          = 64;
+
+/// Runs `OPS_PER_THREAD` operations on each of `threads` threads, returning
+/// millions of operations per second.
+///
+/// `op(rng)` runs one batch of `BATCH` operations on random keys.
+template <typename F> static auto measure(usize threads, F&& op) -> f64 {
+  std::vector<std::thread> workers;
+  auto                     start = std::chrono::steady_clock::now();
+  for (usize t = 0; t < threads; t++) {
+    workers.emplace_back([&op, t] {
+      u64 rng = mix64(t + 1);
+      for (usize i = 0; i < OPS_PER_THREAD; i += BATCH) {
+        op(rng);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  auto end  = std::chrono::steady_clock::now();
+  f64  secs = std::chrono::duration<f64>(end - start).count();
+  return static_cast<f64>(threads * OPS_PER_THREAD) / secs / 1e6;
+}
+
+/// Returns the next pseudo-random number of `rng`.
+static auto next(u64& rng) -> u64 {
+  rng = rng * 6364136223846793005 + 1442695040888963407;
+  return rng >> 20;
+}
+
+int main(void) {
+  usize max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0) {
+    max_threads = 4;
+  }
+
+  mem::ThreadSafeAllocator allocator{};
+  LockedHashMap            locked{};
+  Concurrent               concurrent{&allocator};
+  for (u64 key = 0; key < KEYS; key++) {
+    locked.put(key, key);
+    concurrent.put(key, key);
+  }
+
+  for (u64 read_pct : {100, 90, 50}) {
+    std::printf("reads/writes: %zu/%zu\n", usize(read_pct),
+                usize(100 - read_pct));
+    std::printf("%8s %18s %18s %18s\n", "threads", "LockedHashMap",
+                "ConcurrentHashMap", "getMany/putMany");
+
+    for (usize threads = 1; threads <= max_threads; threads *= 2) {
+      f64 locked_ops = measure(threads, [&](u64& rng) {
+        u64 sum = 0;
+        for (usize i = 0; i < BATCH; i++) {
+          u64 key = next(rng) % KEYS;
+          if (next(rng) % 100 < read_pct) {
+            sum += locked.get(key);
+          } else {
+            locked.put(key, i);
+          }
+        }
+        bench::doNotOptimize(sum);
+      });
+
+      f64 concurrent_ops = measure(threads, [&](u64& rng) {
+        u64 sum = 0;
+        for (usize i = 0; i < BATCH; i++) {
+          u64 key = next(rng) % KEYS;
+          if (next(rng) % 100 < read_pct) {
+            sum += concurrent.get(key).unwrapOr(0);
+          } else {
+            concurrent.put(key, i);
+          }
+        }
+        bench::doNotOptimize(sum);
+      });
+
+      // Batches of reads and writes, in the same proportions
+      f64 batched_ops = measure(threads, [&](u64& rng) {
+        u64   keys[BATCH];
+        u64   vals[BATCH];
+        bool  found[BATCH];
+        usize reads = (BATCH * read_pct) / 100;
+        for (usize i = 0; i < BATCH; i++) {
+          keys[i] = next(rng) % KEYS;
+          vals[i] = i;
+        }
+        concurrent.getMany(Slice<u64>(keys, reads), Slice<u64>(vals, reads),
+                           Slice<bool>(found, reads));
+        concurrent.putMany(Slice<u64>(keys + reads, BATCH - reads),
+                           Slice<u64>(vals + reads, BATCH - reads));
+        bench::doNotOptimize(vals[0]);
+      });
+
+      std::printf("%8zu %12.2f Mop/s %12.2f Mop/s %12.2f Mop/s\n", threads,
+                  locked_ops, concurrent_ops, batched_ops);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,93 @@
+#include "bench.h"
+#include "mu/crc32c.h"
+#include "mu/io/checksum_writer.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+using namespace mu;
+using internal::crc32c::Impl;
+
+/// Checksums are timed over buffers of `len` bytes, up to `MAX_LEN`.
+static constexpr usize MAX_LEN = usize(1) << 20;
+
+/// The number of bytes checksummed per size (so small inputs are repeated).
+static constexpr usize TOTAL_LEN = usize(1) << 28;
+
+static auto implName(Impl impl) -> const_cstr {
+  switch (impl) {
+  case Impl::Table:
+    return "table";
+  case Impl::Sse42:
+    return "sse4.2";
+  case Impl::Pclmul:
+    return "sse4.2 x3 + pclmul";
+  }
+  return "?";
+}
+
+/// Prints the throughput of `ns` nanoseconds per `len` bytes.
+static auto printRate(f64 ns, usize len) -> void {
+  std::printf("%-48s %14.2f GB/s\n", "", static_cast<f64>(len) / ns);
+}
+
+/// A writer that copies into a fixed buffer (like a page cache would).
+struct BufferWriter {
+  u8*   buf;
+  usize len;
+
+  auto  write(Slice<u8> bytes) -> usize {
+    std::memcpy(this->buf, bytes.ptr(), bytes.len());
+    return bytes.len();
+  }
+
+  auto formatV(const_cstr /*fmt*/, va_list /*args*/) -> void {}
+};
+
+int main(void) {
+  std::vector<u8> data(MAX_LEN);
+  std::vector<u8> sink(MAX_LEN);
+  for (usize i = 0; i < data.size(); i++) {
+    data[i] = static_cast<u8>(i * 131 + 7);
+  }
+
+  for (usize len : {usize(16), usize(64), usize(256), usize(4096),
+                    usize(65536), MAX_LEN}) {
+    usize iters = TOTAL_LEN / len;
+    std::printf("%zu bytes:\n", len);
+    for (Impl impl : {Impl::Table, Impl::Sse42, Impl::Pclmul}) {
+      if (!internal::crc32c::isSupported(impl)) {
+        continue;
+      }
+      f64 ns = bench::run(implName(impl), iters, [&] {
+        u32 crc = internal::crc32c::crc32c(impl, data.data(), len, 0);
+        bench::doNotOptimize(crc);
+      });
+      printRate(ns, len);
+    }
+
+    // Writing with and without the checksum, to see what it adds
+    cstr ptr = reinterpret_cast<cstr>(data.data());
+    f64  ns  = bench::run("write", iters, [&] {
+      BufferWriter writer{sink.data(), sink.size()};
+      usize        written = writer.write(Slice<u8>(ptr, len));
+      bench::doNotOptimize(written);
+      bench::doNotOptimize(sink.data());
+    });
+    printRate(ns, len);
+    ns = bench::run("write through ChecksumWriter", iters, [&] {
+      io::ChecksumWriter<BufferWriter> writer{
+          BufferWriter{sink.data(), sink.size()}};
+      usize written = writer.write(Slice<u8>(ptr, len));
+      bench::doNotOptimize(written);
+      bench::doNotOptimize(writer.checksum());
+      bench::doNotOptimize(sink.data());
+    });
+    printRate(ns, len);
+  }
+  return 0;
+}
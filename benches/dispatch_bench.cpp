@@ -0,0 +1,62 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/unique_ptr.h"
+#include "mu/primitives.h"
+
+using namespace mu;
+
+struct Small {
+  u64 a = 1;
+  u64 b = 2;
+};
+
+static constexpr usize OBJECTS = 1024;
+static constexpr usize ITERS   = 2000;
+
+/// Hides the dynamic type of `allocator` from the optimizer, as is the case for
+/// any allocator passed around as a `mem::Allocator*`.
+[[gnu::noinline]] static auto opaque(mem::Allocator* allocator)
+    -> mem::Allocator* {
+  bench::doNotOptimize(allocator);
+  return allocator;
+}
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  mem::Allocator* dynamic = opaque(&c_allocator);
+  Small*          objs[OBJECTS];
+
+  bench::run("create/destroy: virtual dispatch", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      objs[i] = dynamic->create<Small>();
+    }
+    for (usize i = 0; i < OBJECTS; i++) {
+      dynamic->destroy(objs[i]);
+    }
+  });
+
+  bench::run("create/destroy: static dispatch", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      objs[i] = mem::CAllocator().create<Small>();
+    }
+    for (usize i = 0; i < OBJECTS; i++) {
+      mem::CAllocator().destroy(objs[i]);
+    }
+  });
+
+  bench::run("UniquePtr<T, mem::Allocator>::create", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      auto ptr = UniquePtr<Small, mem::Allocator>::create(dynamic);
+      bench::doNotOptimize(ptr->a);
+    }
+  });
+
+  bench::run("UniquePtr<T, mem::CAllocator>::create", ITERS, [&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      auto ptr = UniquePtr<Small>::create();
+      bench::doNotOptimize(ptr->a);
+    }
+  });
+
+  return 0;
+}
@@ -0,0 +1,79 @@
+#include "bench.h"
+#include "mu/bytes.h"
+#include "mu/hash.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string_view>
+#include <vector>
+
+using namespace mu;
+using internal::bytes::Isa;
+
+/// The number of bytes hashed per measurement.
+static constexpr usize TOTAL = usize(1) << 24;
+
+/// The longest input.
+static constexpr usize MAX_LEN = usize(1) << 20;
+
+/// Runs `func` (which hashes `TOTAL` bytes) and prints its throughput.
+template <typename F> static auto throughput(const_cstr name, F&& func) {
+  f64 ns = bench::run(name, 5, func);
+  std::printf("%-48s %14.2f GB/s\n", "", static_cast<f64>(TOTAL) / ns);
+}
+
+int main(void) {
+  std::mt19937_64 rng{42};
+  std::vector<u8> data(MAX_LEN + 64); // Inputs start at offsets up to 63
+  for (u8& byte : data) {
+    byte = static_cast<u8>(rng());
+  }
+
+  char name[64];
+  for (usize len : {usize(8), usize(16), usize(64), usize(256), usize(4096),
+                    MAX_LEN}) {
+    usize count = TOTAL / len;
+    std::snprintf(name, sizeof(name), "hash64, %zu bytes", len);
+    throughput(name, [&] {
+      for (usize i = 0; i < count; i++) {
+        // Different offsets, so calls don't just repeat
+        bench::doNotOptimize(hash64(data.data() + (i & 63), len, i));
+      }
+    });
+    std::snprintf(name, sizeof(name), "std::hash<string_view>, %zu bytes",
+                  len);
+    throughput(name, [&] {
+      for (usize i = 0; i < count; i++) {
+        std::string_view view(
+            reinterpret_cast<const char*>(data.data() + (i & 63)), len);
+        bench::doNotOptimize(std::hash<std::string_view>()(view));
+      }
+    });
+  }
+
+  const_cstr names[] = {"hash64 (1 MiB), scalar", "hash64 (1 MiB), SSE2",
+                        "hash64 (1 MiB), AVX2", "hash64 (1 MiB), AVX-512"};
+  for (Isa isa : {Isa::Scalar, Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+    if (internal::bytes::isSupported(isa)) {
+      throughput(names[static_cast<usize>(isa)], [&] {
+        for (usize i = 0; i < TOTAL / MAX_LEN; i++) {
+          bench::doNotOptimize(
+              internal::hash::hash64(isa, data.data(), MAX_LEN, i));
+        }
+      });
+    }
+  }
+
+  throughput("Hasher (1 MiB in 4 KiB chunks)", [&] {
+    for (usize i = 0; i < TOTAL / MAX_LEN; i++) {
+      Hasher hasher{i};
+      for (usize at = 0; at < MAX_LEN; at += 4096) {
+        hasher.update(data.data() + at, 4096);
+      }
+      bench::doNotOptimize(hasher.finish());
+    }
+  });
+  return 0;
+}
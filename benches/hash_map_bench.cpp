@@ -0,0 +1,112 @@
+#include "bench.h"
+#include "mu/hash.h"
+#include "mu/hash_map.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+
+using namespace mu;
+
+/// The smallest table size, and the default largest one (pass a larger one,
+/// e.g. 100000000, as the first argument; it needs a lot of memory).
+static constexpr usize MIN_LEN     = 1000;
+static constexpr usize MAX_LEN     = 1000000;
+
+/// The number of operations each benchmark iteration does (at least).
+static constexpr usize OPS_PER_RUN = 2000000;
+
+/// Fills `keys` with pseudo-random (distinct with high probability) keys.
+static auto randomKeys(Slice<u64> keys) -> void {
+  u64 state = 0x2545F4914F6CDD1D;
+  for (usize i = 0; i < keys.len(); i++) {
+    state         = state * 6364136223846793005 + 1442695040888963407;
+    keys.ptr()[i]  = mix64(state);
+  }
+}
+
+/// Runs the insert/lookup/erase benchmarks for tables of `len` entries.
+static auto runWith(Slice<u64> keys) -> void {
+  usize len   = keys.len();
+  usize iters = (OPS_PER_RUN + len - 1) / len;
+  u64*  ptr   = keys.ptr();
+  char  name[64];
+
+  std::snprintf(name, sizeof(name), "std::unordered_map %zu: insert", len);
+  bench::run(name, iters, [&] {
+    std::unordered_map<u64, u64> map{};
+    for (usize i = 0; i < len; i++) {
+      map[ptr[i]] = i;
+    }
+    bench::doNotOptimize(map.size());
+  });
+
+  std::snprintf(name, sizeof(name), "HashMap %zu: insert", len);
+  bench::run(name, iters, [&] {
+    HashMap<u64, u64> map{};
+    for (usize i = 0; i < len; i++) {
+      map.put(ptr[i], i);
+    }
+    bench::doNotOptimize(map.len());
+  });
+
+  std::unordered_map<u64, u64> std_map{};
+  HashMap<u64, u64>            map{};
+  for (usize i = 0; i < len; i++) {
+    std_map[ptr[i]] = i;
+    map.put(ptr[i], i);
+  }
+
+  std::snprintf(name, sizeof(name), "std::unordered_map %zu: lookup", len);
+  bench::run(name, iters, [&] {
+    u64 sum = 0;
+    for (usize i = 0; i < len; i++) {
+      sum += std_map.find(ptr[i])->second + std_map.count(ptr[i] + 1);
+    }
+    bench::doNotOptimize(sum);
+  });
+
+  std::snprintf(name, sizeof(name), "HashMap %zu: lookup", len);
+  bench::run(name, iters, [&] {
+    u64 sum = 0;
+    for (usize i = 0; i < len; i++) {
+      sum += *map.get(ptr[i]) + map.contains(ptr[i] + 1);
+    }
+    bench::doNotOptimize(sum);
+  });
+
+  // Erases and re-inserts every key, so the tables keep their size
+  std::snprintf(name, sizeof(name), "std::unordered_map %zu: erase", len);
+  bench::run(name, iters, [&] {
+    for (usize i = 0; i < len; i++) {
+      std_map.erase(ptr[i]);
+      std_map[ptr[i]] = i;
+    }
+    bench::doNotOptimize(std_map.size());
+  });
+
+  std::snprintf(name, sizeof(name), "HashMap %zu: erase", len);
+  bench::run(name, iters, [&] {
+    for (usize i = 0; i < len; i++) {
+      map.remove(ptr[i]);
+      map.put(ptr[i], i);
+    }
+    bench::doNotOptimize(map.len());
+  });
+}
+
+int main(int argc, char** argv) {
+  usize           max_len = (argc > 1) ? std::strtoull(argv[1], nullptr, 10)
+                                       : MAX_LEN;
+
+  mem::CAllocator allocator{};
+  Slice<u64>      keys = allocator.alloc<u64>(max_len);
+  randomKeys(keys);
+  for (usize len = MIN_LEN; len <= max_len; len *= 10) {
+    runWith(Slice<u64>(keys.ptr(), len));
+  }
+  allocator.free(keys);
+  return 0;
+}
@@ -0,0 +1,81 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/multi_array_list.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+
+using namespace mu;
+
+static constexpr usize LEN   = 1000000;
+static constexpr usize ITERS = 200;
+
+struct Particle {
+  f32 x;
+  f32 y;
+  f32 z;
+  f32 vx;
+  f32 vy;
+  f32 vz;
+  f32 mass;
+  u32 id;
+};
+
+int main(void) {
+  mem::CAllocator          allocator{};
+  Slice<Particle>          aos = allocator.alloc<Particle>(LEN);
+  MultiArrayList<Particle> soa{};
+  for (u32 i = 0; i < LEN; i++) {
+    Particle p{f32(i), 0, 0, 1, 2, 3, f32(i % 7), i};
+    aos[i] = p;
+    soa.append(p);
+  }
+
+  // Reads one field: the AoS loop loads every item's 32 bytes to use 4
+  // (counting, rather than summing floats, lets both loops vectorize without
+  // `-ffast-math`)
+  bench::run("Slice<Particle>: count heavy", ITERS, [&] {
+    u32 heavy = 0;
+    for (usize i = 0; i < LEN; i++) {
+      heavy += (aos.ptr()[i].mass > 3);
+    }
+    bench::doNotOptimize(heavy);
+  });
+
+  bench::run("MultiArrayList<Particle>: count heavy", ITERS, [&] {
+    Slice<f32> masses = soa.items<6>();
+    u32        heavy  = 0;
+    for (usize i = 0; i < LEN; i++) {
+      heavy += (masses.ptr()[i] > 3);
+    }
+    bench::doNotOptimize(heavy);
+  });
+
+  // Updates two fields from two others
+  bench::run("Slice<Particle>: integrate x, y", ITERS, [&] {
+    for (usize i = 0; i < LEN; i++) {
+      aos.ptr()[i].x += aos.ptr()[i].vx;
+      aos.ptr()[i].y += aos.ptr()[i].vy;
+    }
+    bench::doNotOptimize(aos.ptr());
+  });
+
+  bench::run("MultiArrayList<Particle>: integrate x, y", ITERS, [&] {
+    f32*       x  = soa.items<0>().ptr();
+    f32*       y  = soa.items<1>().ptr();
+    const f32* vx = soa.items<3>().ptr();
+    const f32* vy = soa.items<4>().ptr();
+    for (usize i = 0; i < LEN; i++) {
+      x[i] += vx[i];
+      y[i] += vy[i];
+    }
+    bench::doNotOptimize(x);
+  });
+
+  bench::run("MultiArrayList<Particle>: sortBy mass, id", 10, [&] {
+    soa.sortBy<6>();
+    soa.sortBy<7>();
+  });
+
+  allocator.free(aos);
+  return 0;
+}
@@ -0,0 +1,48 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/page_allocator.h"
+#include "mu/primitives.h"
+
+using namespace mu;
+
+/// Size of the buffer that is randomly accessed (large enough to overflow the
+/// TLB reach of regular pages).
+static constexpr usize BUFFER_SIZE = 256 * 1024 * 1024;
+static constexpr usize LEN         = BUFFER_SIZE / sizeof(u64);
+static constexpr usize ACCESSES    = 1 << 22;
+static constexpr usize ITERS       = 10;
+
+/// Sums `ACCESSES` pseudo-random elements of `slice`.
+static auto randomAccess(Slice<u64>& slice) -> void {
+  u64* data  = slice.ptr();
+  u64  state = 0x2545F4914F6CDD1D;
+  u64  sum   = 0;
+  for (usize i = 0; i < ACCESSES; i++) {
+    state  = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    sum   += data[(state >> 16) % LEN];
+  }
+  bench::doNotOptimize(sum);
+}
+
+static auto runWith(const_cstr name, mem::Allocator& allocator) -> void {
+  Slice<u64> slice = allocator.alloc<u64>(LEN);
+  for (usize i = 0; i < LEN; i++) {
+    slice.ptr()[i] = i;
+  }
+  bench::run(name, ITERS, [&] { randomAccess(slice); });
+  allocator.free(slice);
+}
+
+int main(void) {
+  mem::CAllocator    c_allocator{};
+  mem::PageAllocator pages{};
+  mem::PageAllocator thp{mem::PageAllocator::HugePages::Transparent};
+  mem::PageAllocator hugetlb{mem::PageAllocator::HugePages::Explicit};
+
+  runWith("CAllocator: random access (256 MiB)", c_allocator);
+  runWith("PageAllocator: random access (256 MiB)", pages);
+  runWith("PageAllocator (THP): random access (256 MiB)", thp);
+  runWith("PageAllocator (HugeTLB): random access (256 MiB)", hugetlb);
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/primitives.h"
+
+using namespace mu;
+
+struct Node {
+  Node* next;
+  u64   key;
+  u64   val;
+};
+
+static constexpr usize OBJECTS = 4096;
+static constexpr usize ITERS   = 500;
+
+/// Creates `OBJECTS` nodes, then destroys every other one and recreates it, to
+/// mimic objects with interleaved lifetimes.
+template <class A> static auto churn(A& allocator, Node** nodes) -> void {
+  for (usize i = 0; i < OBJECTS; i++) {
+    nodes[i]      = allocator.template create<Node>();
+    nodes[i]->key = i;
+  }
+  for (usize i = 0; i < OBJECTS; i += 2) {
+    allocator.destroy(nodes[i]);
+    nodes[i]      = allocator.template create<Node>();
+    nodes[i]->key = i;
+  }
+  for (usize i = 0; i < OBJECTS; i++) {
+    bench::doNotOptimize(nodes[i]->key);
+    allocator.destroy(nodes[i]);
+  }
+}
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  Node*           nodes[OBJECTS];
+
+  bench::run("CAllocator: create/destroy churn", ITERS,
+             [&] { churn(c_allocator, nodes); });
+
+  mem::PoolAllocator<Node> pool{&c_allocator};
+  bench::run("PoolAllocator: create/destroy churn", ITERS,
+             [&] { churn(pool, nodes); });
+
+  return 0;
+}
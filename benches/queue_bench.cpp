@@ -0,0 +1,231 @@
+#include "bench.h"
+#include "mu/mpmc_queue.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/spsc_queue.h"
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+static constexpr u64   ITEMS       = 1 << 20;
+static constexpr usize CAPACITY    = 1024;
+static constexpr usize BATCH       = 64;
+static constexpr u64   ROUND_TRIPS = 1 << 16;
+
+/// The naive queue: a `std::deque` behind a single mutex.
+class LockedQueue {
+public:
+  auto tryPush(u64 val) -> bool {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->items.size() == CAPACITY) {
+      return false;
+    }
+    this->items.push_back(val);
+    return true;
+  }
+
+  auto tryPop(u64& out) -> bool {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    if (this->items.empty()) {
+      return false;
+    }
+    out = this->items.front();
+    this->items.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex      mutex;
+  std::deque<u64> items;
+};
+
+/// Returns the size of the next batch, when `left` items are left.
+static auto batchLen(u64 left) -> usize {
+  return (left < BATCH) ? usize(left) : BATCH;
+}
+
+/// Calls `func` until it returns `true`, spinning at first and then yielding
+/// (so that the benchmark also terminates on a single core).
+template <typename F> static auto retry(F&& func) -> void {
+  for (u32 spins = 0; !func(); spins++) {
+    if (spins >= 64) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+/// Passes `ITEMS` items from `producers` threads to as many consumer threads,
+/// returning millions of items per second.
+///
+/// `push(i)` and `pop()` move (up to) a batch of items, and return the number
+/// of items moved.
+template <typename Push, typename Pop>
+static auto throughput(usize producers, Push&& push, Pop&& pop) -> f64 {
+  u64                      per_thread = ITEMS / producers;
+  std::vector<std::thread> workers;
+  auto                     start = std::chrono::steady_clock::now();
+  for (usize t = 0; t < producers; t++) {
+    workers.emplace_back([&] {
+      for (u64 i = 0; i < per_thread;) {
+        usize pushed = 0;
+        retry([&] { return (pushed = push(i, per_thread - i)) != 0; });
+        i += pushed;
+      }
+    });
+    workers.emplace_back([&] {
+      for (u64 i = 0; i < per_thread;) {
+        usize popped = 0;
+        retry([&] { return (popped = pop(per_thread - i)) != 0; });
+        i += popped;
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  auto end  = std::chrono::steady_clock::now();
+  f64  secs = std::chrono::duration<f64>(end - start).count();
+  return static_cast<f64>(per_thread * producers) / secs / 1e6;
+}
+
+/// Bounces an item between two threads through `ping` and `pong`, returning
+/// the average round-trip time in nanoseconds.
+template <typename Queue> static auto latency(Queue& ping, Queue& pong) -> f64 {
+  std::thread echo([&] {
+    for (u64 i = 0; i < ROUND_TRIPS; i++) {
+      u64 val;
+      retry([&] { return ping.tryPop(val); });
+      retry([&] { return pong.tryPush(val); });
+    }
+  });
+
+  auto        start = std::chrono::steady_clock::now();
+  for (u64 i = 0; i < ROUND_TRIPS; i++) {
+    u64 val = i;
+    retry([&] { return ping.tryPush(val); });
+    retry([&] { return pong.tryPop(val); });
+    bench::doNotOptimize(val);
+  }
+  auto end = std::chrono::steady_clock::now();
+  echo.join();
+  return std::chrono::duration<f64, std::nano>(end - start).count() /
+         static_cast<f64>(ROUND_TRIPS);
+}
+
+int main(void) {
+  usize max_threads = std::thread::hardware_concurrency();
+  if (max_threads < 2) {
+    max_threads = 2;
+  }
+
+  // Single producer, single consumer
+  {
+    LockedQueue    locked{};
+    SpscQueue<u64> spsc{nullptr, CAPACITY};
+    MpmcQueue<u64> mpmc{nullptr, CAPACITY};
+    u64            batch[BATCH];
+
+    std::printf("1 producer, 1 consumer (Mitems/s):\n");
+    std::printf("  %-32s %10.2f\n", "LockedQueue",
+                throughput(
+                    1, [&](u64 i, u64) { return usize(locked.tryPush(i)); },
+                    [&](u64) {
+                      u64 val;
+                      return usize(locked.tryPop(val));
+                    }));
+    std::printf("  %-32s %10.2f\n", "SpscQueue: tryPush/tryPop",
+                throughput(
+                    1, [&](u64 i, u64) { return usize(spsc.tryPush(i)); },
+                    [&](u64) {
+                      u64 val;
+                      return usize(spsc.tryPop(val));
+                    }));
+    std::printf(
+        "  %-32s %10.2f\n", "SpscQueue: pushMany/popMany",
+        throughput(
+            1,
+            [&](u64 i, u64 left) {
+              usize len = batchLen(left);
+              for (usize j = 0; j < len; j++) {
+                batch[j] = i + j;
+              }
+              return spsc.pushMany(Slice<u64>(batch, len));
+            },
+            [&](u64 left) {
+              u64 out[BATCH];
+              return spsc.popMany(Slice<u64>(out, batchLen(left)));
+            }));
+    std::printf("  %-32s %10.2f\n", "MpmcQueue: tryPush/tryPop",
+                throughput(
+                    1, [&](u64 i, u64) { return usize(mpmc.tryPush(i)); },
+                    [&](u64) {
+                      u64 val;
+                      return usize(mpmc.tryPop(val));
+                    }));
+  }
+
+  // Many producers, many consumers (a batch buffer per producer thread)
+  std::printf("\n%10s %14s %14s %20s (Mitems/s)\n", "producers",
+              "LockedQueue", "MpmcQueue", "pushMany/popMany");
+  for (usize producers = 1; producers <= max_threads / 2; producers *= 2) {
+    LockedQueue    locked{};
+    MpmcQueue<u64> mpmc{nullptr, CAPACITY};
+
+    std::printf("%10zu", producers);
+    std::printf(" %14.2f",
+                throughput(
+                    producers,
+                    [&](u64 i, u64) { return usize(locked.tryPush(i)); },
+                    [&](u64) {
+                      u64 val;
+                      return usize(locked.tryPop(val));
+                    }));
+    std::printf(" %14.2f",
+                throughput(
+                    producers,
+                    [&](u64 i, u64) { return usize(mpmc.tryPush(i)); },
+                    [&](u64) {
+                      u64 val;
+                      return usize(mpmc.tryPop(val));
+                    }));
+    std::printf(" %20.2f\n",
+                throughput(
+                    producers,
+                    [&](u64 i, u64 left) {
+                      u64   batch[BATCH];
+                      usize len = batchLen(left);
+                      for (usize j = 0; j < len; j++) {
+                        batch[j] = i + j;
+                      }
+                      return mpmc.pushMany(Slice<u64>(batch, len));
+                    },
+                    [&](u64 left) {
+                      u64 out[BATCH];
+                      return mpmc.popMany(Slice<u64>(out, batchLen(left)));
+                    }));
+  }
+
+  // Round trips between two threads
+  {
+    LockedQueue    locked_ping{};
+    LockedQueue    locked_pong{};
+    SpscQueue<u64> spsc_ping{nullptr, CAPACITY};
+    SpscQueue<u64> spsc_pong{nullptr, CAPACITY};
+    MpmcQueue<u64> mpmc_ping{nullptr, CAPACITY};
+    MpmcQueue<u64> mpmc_pong{nullptr, CAPACITY};
+
+    std::printf("\nround trip latency (ns):\n");
+    std::printf("  %-32s %10.2f\n", "LockedQueue",
+                latency(locked_ping, locked_pong));
+    std::printf("  %-32s %10.2f\n", "SpscQueue",
+                latency(spsc_ping, spsc_pong));
+    std::printf("  %-32s %10.2f\n", "MpmcQueue",
+                latency(mpmc_ping, mpmc_pong));
+  }
+  return 0;
+}
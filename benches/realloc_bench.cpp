@@ -0,0 +1,61 @@
+#include "bench.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cstring>
+
+using namespace mu;
+
+static constexpr usize ITEMS = 1 << 16;
+static constexpr usize ITERS = 200;
+
+/// Appends `ITEMS` items one at a time, growing the buffer by 1.5x with
+/// allocate + copy + free.
+static auto growByCopy(mem::Allocator& allocator) -> void {
+  Slice<u32> buf = allocator.alloc<u32>(8);
+  for (usize i = 0; i < ITEMS; i++) {
+    if (i == buf.len()) {
+      Slice<u32> grown = allocator.alloc<u32>(buf.len() + buf.len() / 2);
+      std::memcpy(grown.ptr(), buf.ptr(), buf.len() * sizeof(u32));
+      allocator.free(buf);
+      buf = grown;
+    }
+    buf.ptr()[i] = static_cast<u32>(i);
+  }
+  bench::doNotOptimize(buf.ptr()[ITEMS - 1]);
+  allocator.free(buf);
+}
+
+/// Appends `ITEMS` items one at a time, growing the buffer by 1.5x with
+/// `realloc`.
+static auto growByRealloc(mem::Allocator& allocator) -> void {
+  Slice<u32> buf = allocator.alloc<u32>(8);
+  for (usize i = 0; i < ITEMS; i++) {
+    if (i == buf.len()) {
+      buf = allocator.realloc(buf, buf.len() + buf.len() / 2);
+    }
+    buf.ptr()[i] = static_cast<u32>(i);
+  }
+  bench::doNotOptimize(buf.ptr()[ITEMS - 1]);
+  allocator.free(buf);
+}
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  bench::run("CAllocator: grow by alloc + copy + free", ITERS,
+             [&] { growByCopy(c_allocator); });
+  bench::run("CAllocator: grow by realloc", ITERS,
+             [&] { growByRealloc(c_allocator); });
+
+  mem::ArenaAllocator arena{&c_allocator, 1 << 20};
+  bench::run("ArenaAllocator: grow by alloc + copy + free", ITERS, [&] {
+    growByCopy(arena);
+    arena.reset();
+  });
+  bench::run("ArenaAllocator: grow by realloc", ITERS, [&] {
+    growByRealloc(arena);
+    arena.reset();
+  });
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/scratch.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+
+using namespace mu;
+
+/// Number of temporary buffers per iteration, and their size.
+static constexpr usize BUFFERS = 64;
+static constexpr usize LEN     = 512;
+static constexpr usize ITERS   = 20000;
+
+/// Fills a temporary buffer and returns its checksum.
+static auto useBuffer(Slice<u32>& buf) -> u32 {
+  u32* data = buf.ptr();
+  for (usize i = 0; i < LEN; i++) {
+    data[i] = static_cast<u32>(i);
+  }
+  return data[LEN / 2];
+}
+
+int main(void) {
+  mem::CAllocator c_allocator{};
+  bench::run("CAllocator: temporary buffers", ITERS, [&] {
+    u32 sum = 0;
+    for (usize i = 0; i < BUFFERS; i++) {
+      Slice<u32> buf  = c_allocator.allocUninit<u32>(LEN);
+      sum            += useBuffer(buf);
+      c_allocator.free(buf);
+    }
+    bench::doNotOptimize(sum);
+  });
+
+  bench::run("TempScope: temporary buffers", ITERS, [&] {
+    mem::TempScope scope{};
+    u32            sum = 0;
+    for (usize i = 0; i < BUFFERS; i++) {
+      Slice<u32> buf  = scope.arenaAllocator().allocUninit<u32>(LEN);
+      sum            += useBuffer(buf);
+    }
+    bench::doNotOptimize(sum);
+  });
+
+  mem::ScratchAllocator scratch{};
+  bench::run("ScratchAllocator: temporary buffers", ITERS, [&] {
+    mem::TempScope scope{};
+    u32            sum = 0;
+    for (usize i = 0; i < BUFFERS; i++) {
+      Slice<u32> buf  = scratch.allocUninit<u32>(LEN);
+      sum            += useBuffer(buf);
+      scratch.free(buf);
+    }
+    bench::doNotOptimize(sum);
+  });
+  return 0;
+}
@@ -0,0 +1,64 @@
+#include "bench.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize LEN   = usize(1) << 16;
+static constexpr usize ITERS = 2000;
+
+/// Sums the slice in 8 independent lanes, so the loop can be vectorized
+/// without reassociating floating-point additions.
+template <typename Get>
+static auto sum(Slice<f32> slice, Get&& get) -> f32 {
+  f32 lanes[8] = {};
+  for (usize i = 0; i + 8 <= slice.len(); i += 8) {
+    for (usize j = 0; j < 8; j++) {
+      lanes[j] += get(slice, i + j);
+    }
+  }
+  f32 total = 0;
+  for (f32 lane : lanes) {
+    total += lane;
+  }
+  return total;
+}
+
+int main(void) {
+  std::vector<f32> src(LEN, 1.5f);
+  std::vector<f32> dst(LEN);
+  Slice<f32>       from(src.data(), src.size());
+  Slice<f32>       to(dst.data(), dst.size());
+
+  bench::run("Slice<f32>: sum 64k, operator[]", ITERS, [&] {
+    bench::doNotOptimize(
+        sum(from, [](Slice<f32> slice, usize idx) { return slice[idx]; }));
+  });
+  bench::run("Slice<f32>: sum 64k, getUnchecked", ITERS, [&] {
+    bench::doNotOptimize(sum(from, [](Slice<f32> slice, usize idx) {
+      return slice.getUnchecked(idx);
+    }));
+  });
+
+  bench::run("Slice<f32>: scaled copy 64k, operator[]", ITERS, [&] {
+    for (usize i = 0; i < from.len(); i++) {
+      to[i] = from[i] * 2.0f;
+    }
+    bench::doNotOptimize(to.ptr());
+  });
+  bench::run("Slice<f32>: scaled copy 64k, getUnchecked", ITERS, [&] {
+    for (usize i = 0; i < from.len(); i++) {
+      to.getUnchecked(i) = from.getUnchecked(i) * 2.0f;
+    }
+    bench::doNotOptimize(to.ptr());
+  });
+  bench::run("Slice<f32>: scaled copy 64k, iterators", ITERS, [&] {
+    f32* out = to.begin();
+    for (f32 val : from) {
+      *out++ = val * 2.0f;
+    }
+    bench::doNotOptimize(to.ptr());
+  });
+  return 0;
+}
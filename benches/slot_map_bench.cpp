@@ -0,0 +1,87 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/slot_map.h"
+
+using namespace mu;
+
+/// A typical small object in an object graph.
+struct Particle {
+  f64 pos[3];
+  f64 vel[3];
+};
+
+static constexpr usize COUNT = 100000;
+static constexpr usize ITERS = 200;
+
+/// Advances every particle by one step.
+static auto step(Particle& p) -> void {
+  for (usize i = 0; i < 3; i++) {
+    p.pos[i] += p.vel[i];
+  }
+}
+
+int main(void) {
+  mem::CAllocator    allocator{};
+
+  // Individually allocated objects, interleaved with other allocations and
+  // visited in a shuffled order (as in a long-running program's object graph)
+  Slice<Particle*>   scattered = allocator.alloc<Particle*>(COUNT);
+  Slice<Slice<char>> noise     = allocator.alloc<Slice<char>>(COUNT);
+  u64                rng       = 0x9e3779b97f4a7c15;
+  for (usize i = 0; i < COUNT; i++) {
+    rng           = rng * 6364136223846793005 + 1442695040888963407;
+    scattered[i]  = allocator.create<Particle>();
+    *scattered[i] = Particle{{0, 0, 0}, {1, 1, 1}};
+    noise[i]      = allocator.alloc<char>(16 + (rng >> 58));
+  }
+  for (usize i = COUNT - 1; i > 0; i--) {
+    rng           = rng * 6364136223846793005 + 1442695040888963407;
+    usize     j   = (rng >> 33) % (i + 1);
+    Particle* tmp = scattered[i];
+    scattered[i]  = scattered[j];
+    scattered[j]  = tmp;
+  }
+
+  bench::run("Scattered objects: iterate", ITERS, [&] {
+    Particle** ptrs = scattered.ptr();
+    for (usize i = 0; i < COUNT; i++) {
+      step(*ptrs[i]);
+    }
+    bench::doNotOptimize(ptrs[0]->pos[0]);
+  });
+
+  SlotMap<Particle> map{};
+  for (usize i = 0; i < COUNT; i++) {
+    map.insert(Particle{{0, 0, 0}, {1, 1, 1}});
+  }
+
+  bench::run("SlotMap: iterate", ITERS, [&] {
+    for (Particle& p : map) {
+      step(p);
+    }
+    bench::doNotOptimize(map.begin()->pos[0]);
+  });
+
+  using Key       = SlotMap<Particle>::Key;
+  Slice<Key> keys = allocator.alloc<Key>(COUNT);
+  bench::run("SlotMap: insert + remove", ITERS, [&] {
+    for (usize i = 0; i < COUNT; i++) {
+      keys.ptr()[i] = map.insert(Particle{{0, 0, 0}, {1, 1, 1}});
+    }
+    for (usize i = 0; i < COUNT; i++) {
+      map.remove(keys.ptr()[i]);
+    }
+    bench::doNotOptimize(map.len());
+  });
+
+  allocator.free(keys);
+  for (usize i = 0; i < COUNT; i++) {
+    allocator.destroy(scattered[i]);
+    allocator.free(noise[i]);
+  }
+  allocator.free(noise);
+  allocator.free(scattered);
+  return 0;
+}
@@ -0,0 +1,55 @@
+#include "bench.h"
+#include "mu/array_list.h"
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/small_vector.h"
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize LISTS = 10000;
+static constexpr usize ITERS = 100;
+
+/// Builds `LISTS` lists with the given sizes, and returns the number of
+/// allocations made for them.
+template <typename List>
+static auto buildLists(const std::vector<u8>& sizes) -> u64 {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  for (usize i = 0; i < LISTS; i++) {
+    List list{&tracking};
+    for (u64 j = 0; j < sizes[i]; j++) {
+      list.append(j);
+    }
+    bench::doNotOptimize(list.begin());
+  }
+  return tracking.stats().allocs;
+}
+
+int main(void) {
+  // Most lists are small: sizes are uniform in [0, 12], so ~70% fit in 8
+  std::mt19937_64                    rng{42};
+  std::uniform_int_distribution<u32> dist{0, 12};
+  std::vector<u8>                    sizes(LISTS);
+  for (u8& size : sizes) {
+    size = static_cast<u8>(dist(rng));
+  }
+
+  using List  = ArrayList<u64, mem::Allocator>;
+  using Small = SmallVector<u64, 8, mem::Allocator>;
+
+  bench::run("ArrayList<u64>: small lists", ITERS,
+             [&] { buildLists<List>(sizes); });
+  bench::run("SmallVector<u64, 8>: small lists", ITERS,
+             [&] { buildLists<Small>(sizes); });
+
+  std::printf("allocations per %zu lists: ArrayList = %llu, "
+              "SmallVector<u64, 8> = %llu\n",
+              LISTS, static_cast<unsigned long long>(buildLists<List>(sizes)),
+              static_cast<unsigned long long>(buildLists<Small>(sizes)));
+  return 0;
+}
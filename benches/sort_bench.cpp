@@ -0,0 +1,77 @@
+#include "bench.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/sort.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#ifdef MU_BENCH_HAS_TBB
+#include <execution>
+#endif
+
+using namespace mu;
+
+/// Sorting is timed on inputs of `len` random keys, from 1K up to `MAX_LEN`.
+///
+/// NOTE: 1B `u64`s would need 8 GiB per copy of the input, so larger sizes
+/// have to be run by raising this on a machine with the memory for it.
+static constexpr usize MAX_LEN = usize(1) << 24;
+
+/// The number of keys sorted per size (so small inputs are repeated).
+static constexpr usize TOTAL_LEN = usize(1) << 22;
+
+/// Runs `func` (which sorts `work`, after copying `input` into it) and prints
+/// the time per key.
+template <typename F>
+static auto perKey(const_cstr name, std::vector<u64>& work,
+                   const std::vector<u64>& input, F&& func) {
+  usize len   = input.size();
+  usize iters = std::max(TOTAL_LEN / len, usize(1));
+  f64   ns    = bench::run(name, iters, [&] {
+    std::memcpy(work.data(), input.data(), sizeof(u64) * len);
+    func(Slice<u64>(work.data(), len));
+    bench::doNotOptimize(work.data());
+  });
+  std::printf("%-48s %14.2f ns/key\n", "", ns / static_cast<f64>(len));
+}
+
+int main(void) {
+  std::mt19937_64 rng{42};
+  for (usize len = usize(1) << 10; len <= MAX_LEN; len <<= 2) {
+    std::vector<u64> input(len);
+    std::vector<u64> work(len);
+    for (u64& key : input) {
+      key = rng();
+    }
+    std::printf("%zu random u64s:\n", len);
+
+    perKey("copy only", work, input, [](Slice<u64>) {});
+    perKey("std::sort", work, input, [](Slice<u64> keys) {
+      std::sort(keys.begin(), keys.end());
+    });
+#ifdef MU_BENCH_HAS_TBB
+    perKey("std::sort(std::execution::par)", work, input,
+           [](Slice<u64> keys) {
+             std::sort(std::execution::par, keys.begin(), keys.end());
+           });
+#endif
+    perKey("sort", work, input, [](Slice<u64> keys) { sort(keys); });
+    perKey("radixSort", work, input, [](Slice<u64> keys) { radixSort(keys); });
+    perKey("parallelSort", work, input,
+           [](Slice<u64> keys) { parallelSort(keys); });
+
+    // Keys that fit in 32 bits (like ids), where half the radix passes are
+    // skipped
+    for (u64& key : input) {
+      key >>= 32;
+    }
+    perKey("std::sort, keys < 2^32", work, input, [](Slice<u64> keys) {
+      std::sort(keys.begin(), keys.end());
+    });
+    perKey("radixSort, keys < 2^32", work, input,
+           [](Slice<u64> keys) { radixSort(keys); });
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/thread_safe_allocator.h"
+#include "mu/primitives.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+/// The naive thread-safe allocator: a `CAllocator` behind a global mutex.
+class LockedCAllocator : public mem::Allocator {
+public:
+  std::mutex      mutex;
+  mem::CAllocator inner;
+
+private:
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    return this->inner.rawAlloc(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override {
+    const std::lock_guard<std::mutex> lock(this->mutex);
+    this->inner.rawFree(ptr, byte_size, align);
+  }
+
+  auto native_align_fn() const noexcept -> usize override { return 16; }
+};
+
+static constexpr usize OPS_PER_THREAD = 1 << 20;
+static constexpr usize LIVE_OBJECTS   = 128;
+
+/// Runs alloc/free pairs on `threads` threads, returning millions of
+/// operations per second.
+static auto churn(mem::Allocator& allocator, usize threads) -> f64 {
+  std::vector<std::thread> workers;
+  auto                     start = std::chrono::steady_clock::now();
+  for (usize t = 0; t < threads; t++) {
+    workers.emplace_back([&allocator] {
+      Slice<char> live[LIVE_OBJECTS];
+      for (usize i = 0; i < LIVE_OBJECTS; i++) {
+        live[i] = allocator.alloc<char>(16 + (i % 16) * 8);
+      }
+      for (usize i = 0; i < OPS_PER_THREAD; i++) {
+        usize idx = i % LIVE_OBJECTS;
+        allocator.free(live[idx]);
+        live[idx]          = allocator.alloc<char>(16 + ((i * 7) % 32) * 8);
+        live[idx].ptr()[0] = 1;
+      }
+      for (usize i = 0; i < LIVE_OBJECTS; i++) {
+        allocator.free(live[i]);
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  auto end  = std::chrono::steady_clock::now();
+  f64  secs = std::chrono::duration<f64>(end - start).count();
+  return static_cast<f64>(threads * OPS_PER_THREAD) / secs / 1e6;
+}
+
+int main(void) {
+  usize max_threads = std::thread::hardware_concurrency();
+  if (max_threads == 0) {
+    max_threads = 4;
+  }
+
+  std::printf("%8s %22s %22s\n", "threads", "LockedCAllocator",
+              "ThreadSafeAllocator");
+  for (usize threads = 1; threads <= max_threads; threads *= 2) {
+    LockedCAllocator         locked{};
+    mem::ThreadSafeAllocator thread_safe{};
+    f64                      locked_ops      = churn(locked, threads);
+    f64                      thread_safe_ops = churn(thread_safe, threads);
+    std::printf("%8zu %17.2f Mop/s %17.2f Mop/s\n", threads, locked_ops,
+                thread_safe_ops);
+  }
+  return 0;
+}
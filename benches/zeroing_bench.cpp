@@ -0,0 +1,54 @@
+#include "bench.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/page_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cstring>
+
+using namespace mu;
+
+/// Size of the buffers, large enough to be served by fresh mappings.
+static constexpr usize BUFFER_SIZE = 16 * 1024 * 1024;
+static constexpr usize ITERS       = 50;
+
+/// Allocates a buffer and overwrites all of it (like an I/O buffer).
+static auto fillUninit(mem::Allocator& allocator) -> void {
+  Slice<char> buf = allocator.allocUninit<char>(BUFFER_SIZE);
+  std::memset(buf.ptr(), 'x', buf.len());
+  bench::doNotOptimize(buf.ptr()[BUFFER_SIZE - 1]);
+  allocator.free(buf);
+}
+
+/// Same as `fillUninit`, but pays for zeroing the buffer first.
+static auto fillZeroed(mem::Allocator& allocator) -> void {
+  Slice<char> buf = allocator.allocUninit<char>(BUFFER_SIZE);
+  std::memset(buf.ptr(), 0, buf.len());
+  std::memset(buf.ptr(), 'x', buf.len());
+  bench::doNotOptimize(buf.ptr()[BUFFER_SIZE - 1]);
+  allocator.free(buf);
+}
+
+/// Allocates a zeroed buffer and touches every page.
+static auto touchZeroed(mem::Allocator& allocator) -> void {
+  Slice<char> buf = allocator.allocZeroed<char>(BUFFER_SIZE);
+  for (usize i = 0; i < BUFFER_SIZE; i += 4096) {
+    buf.ptr()[i] = 'x';
+  }
+  bench::doNotOptimize(buf.ptr()[BUFFER_SIZE - 4096]);
+  allocator.free(buf);
+}
+
+int main(void) {
+  mem::CAllocator    c_allocator{};
+  mem::PageAllocator pages{};
+
+  bench::run("CAllocator: allocUninit + fill (16 MiB)", ITERS,
+             [&] { fillUninit(c_allocator); });
+  bench::run("CAllocator: alloc + memset + fill (16 MiB)", ITERS,
+             [&] { fillZeroed(c_allocator); });
+  bench::run("CAllocator: allocZeroed + touch (16 MiB)", ITERS,
+             [&] { touchZeroed(c_allocator); });
+  bench::run("PageAllocator: allocZeroed + touch (16 MiB)", ITERS,
+             [&] { touchZeroed(pages); });
+  return 0;
+}
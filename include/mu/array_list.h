@@ -0,0 +1,329 @@
+#ifndef MU_ARRAY_LIST_H
+#define MU_ARRAY_LIST_H
+
+#include "mu/cloneable.h"         // Copyable
+#include "mu/common.h"            // IndexOutOfBounds, OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/unique_ptr.h"    // UniquePtr
+#include "mu/mem/utils.h"         // TriviallyRelocatable, relocate
+#include "mu/optional.h"          // Optional
+#include "mu/primitives.h"        // usize
+#include "mu/slice.h"             // Slice
+#include <cstring>                // memcpy
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <type_traits>            // is_nothrow_move_constructible_v
+#include <utility>                // forward, move
+
+namespace mu {
+
+/// A contiguous, growable list of items.
+///
+/// The capacity grows geometrically, in place if the allocator allows it.
+/// Items are relocated with `memcpy` if they are `mem::TriviallyRelocatable`,
+/// and are moved otherwise.
+///
+/// ## Note
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, class Allocator = mem::CAllocator> class ArrayList {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "`T` must be nothrow move constructible");
+
+public:
+  ArrayList(const ArrayList&)                    = delete;
+  auto operator=(const ArrayList&) -> ArrayList& = delete;
+
+  /// Creates an empty list that allocates using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit ArrayList(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator}, buf{nullptr, 0} {}
+
+  /// Creates an empty list with room for `capacity` items.
+  static auto withCapacity(Allocator* allocator,
+                           usize      capacity) -> ArrayList {
+    ArrayList list{allocator};
+    list.ensureCapacity(capacity);
+    return list;
+  }
+
+  /// Creates a list by transferring the items from `other`, which is left
+  /// empty.
+  ArrayList(ArrayList&& other) noexcept
+      : allocator{other.allocator}, buf{other.buf}, len_{other.len_} {
+    other.buf  = Slice<T>(nullptr, 0);
+    other.len_ = 0;
+  }
+
+  /// Move assignment operator.
+  auto operator=(ArrayList&& other) noexcept -> ArrayList& {
+    if (this != &other) {
+      this->release();
+      this->allocator = other.allocator;
+      this->buf       = other.buf;
+      this->len_      = other.len_;
+      other.buf       = Slice<T>(nullptr, 0);
+      other.len_      = 0;
+    }
+    return *this;
+  }
+
+  ~ArrayList() noexcept { this->release(); }
+
+  /// Returns the items in the list.
+  ///
+  /// ## Note
+  /// The slice is invalidated when the list grows.
+  auto items() noexcept -> Slice<T> {
+    return Slice<T>(this->buf.ptr(), this->len_);
+  }
+
+  /// Returns the items in the list.
+  auto items() const noexcept -> Slice<const T> {
+    return Slice<const T>(this->buf.ptr(), this->len_);
+  }
+
+  /// Returns the number of items in the list.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Returns the number of items the list can hold without reallocating.
+  auto capacity() const noexcept -> usize { return this->buf.len(); }
+
+  /// Indexes into the list.
+  auto operator[](usize idx) -> T& {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    return this->buf.ptr()[idx];
+  }
+
+  /// Indexes into the list.
+  auto operator[](usize idx) const -> const T& {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    return this->buf.ptr()[idx];
+  }
+
+  auto begin() noexcept -> T* { return this->buf.ptr(); }
+  auto end() noexcept -> T* { return this->buf.ptr() + this->len_; }
+  auto begin() const noexcept -> const T* { return this->buf.ptr(); }
+  auto end() const noexcept -> const T* {
+    return this->buf.ptr() + this->len_;
+  }
+
+  /// Makes sure the list can hold at least `capacity` items in total, growing
+  /// it geometrically if needed.
+  auto ensureCapacity(usize capacity) -> void {
+    if (capacity <= this->buf.len()) {
+      return;
+    }
+
+    usize grown = (this->buf.len() < MIN_CAPACITY) ? MIN_CAPACITY
+                                                   : this->buf.len() * 2;
+    this->setCapacity((grown < capacity) ? capacity : grown);
+  }
+
+  /// Makes sure the list can hold at least `additional` more items.
+  auto ensureUnusedCapacity(usize additional) -> void {
+    if (additional > std::numeric_limits<usize>::max() - this->len_) {
+      throw common::OutOfMemoryException(additional);
+    }
+    this->ensureCapacity(this->len_ + additional);
+  }
+
+  /// Appends `val` to the end of the list.
+  auto append(T val) -> void { this->emplace(std::move(val)); }
+
+  /// Constructs an item from `args` at the end of the list, and returns it.
+  template <typename... Args> auto emplace(Args&&... args) -> T& {
+    if (this->len_ == this->buf.len()) {
+      this->ensureCapacity(this->len_ + 1);
+    }
+    T* item = this->buf.ptr() + this->len_;
+    new (item) T(std::forward<Args>(args)...);
+    this->len_++;
+    return *item;
+  }
+
+  /// Appends copies of `items` to the end of the list.
+  ///
+  /// ## Note
+  /// `items` must not point into the list.
+  auto appendSlice(Slice<T> items) -> void {
+    // `Slice<u8>::ptr` returns a `cstr`
+    const T* src = reinterpret_cast<const T*>(items.ptr());
+    this->ensureUnusedCapacity(items.len());
+    T* dst = this->buf.ptr() + this->len_;
+    if constexpr (Copyable<T>) {
+      if (items.len() != 0) {
+        std::memcpy(dst, src, sizeof(T) * items.len());
+      }
+      this->len_ += items.len();
+    } else {
+      for (usize i = 0; i < items.len(); i++) {
+        new (dst + i) T(src[i]);
+        this->len_++;
+      }
+    }
+  }
+
+  /// Inserts `val` at index `idx`, shifting the following items back.
+  auto insert(usize idx, T val) -> void {
+    if (idx > this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    this->ensureUnusedCapacity(1);
+    T* items = this->buf.ptr();
+    if constexpr (mem::TriviallyRelocatable<T>) {
+      std::memmove(static_cast<void*>(items + idx + 1),
+                   static_cast<const void*>(items + idx),
+                   sizeof(T) * (this->len_ - idx));
+    } else {
+      for (usize i = this->len_; i > idx; i--) {
+        new (items + i) T(std::move(items[i - 1]));
+        items[i - 1].~T();
+      }
+    }
+    new (items + idx) T(std::move(val));
+    this->len_++;
+  }
+
+  /// Removes and returns the item at index `idx`, shifting the following items
+  /// forward (preserving their order).
+  auto orderedRemove(usize idx) -> T {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    T* items = this->buf.ptr();
+    T  res   = std::move(items[idx]);
+    items[idx].~T();
+    if constexpr (mem::TriviallyRelocatable<T>) {
+      std::memmove(static_cast<void*>(items + idx),
+                   static_cast<const void*>(items + idx + 1),
+                   sizeof(T) * (this->len_ - idx - 1));
+    } else {
+      for (usize i = idx + 1; i < this->len_; i++) {
+        new (items + i - 1) T(std::move(items[i]));
+        items[i].~T();
+      }
+    }
+    this->len_--;
+    return res;
+  }
+
+  /// Removes and returns the item at index `idx`, replacing it with the last
+  /// item (in O(1), without preserving the order).
+  auto swapRemove(usize idx) -> T {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    T* items = this->buf.ptr();
+    T  res   = std::move(items[idx]);
+    items[idx].~T();
+    if (idx != this->len_ - 1) {
+      mem::relocate(items + idx, items + this->len_ - 1, 1);
+    }
+    this->len_--;
+    return res;
+  }
+
+  /// Removes and returns the last item, if there is one.
+  auto pop() -> Optional<T> {
+    if (this->len_ == 0) {
+      return Optional<T>();
+    }
+    this->len_--;
+    T* last = this->buf.ptr() + this->len_;
+    T  res  = std::move(*last);
+    last->~T();
+    return Optional<T>(std::move(res));
+  }
+
+  /// Removes all items from the list (keeping its memory).
+  auto clear() noexcept -> void {
+    this->destroyItems();
+    this->len_ = 0;
+  }
+
+  /// Returns the items as an owned slice and leaves the list empty.
+  ///
+  /// The buffer is shrunk to fit the items, in place if the allocator allows
+  /// it, so the items are usually handed over without being copied.
+  ///
+  /// ## Note
+  /// Ownership of the live items moves to the `UniquePtr`, which destroys them
+  /// before freeing the memory.
+  auto toOwnedSlice() -> UniquePtr<Slice<T>, Allocator> {
+    this->setCapacity(this->len_);
+    Slice<T> owned = this->buf;
+    this->buf      = Slice<T>(nullptr, 0);
+    this->len_     = 0;
+    return UniquePtr<Slice<T>, Allocator>::fromSlice(this->allocatorPtr(),
+                                                      owned);
+  }
+
+private:
+  /// The capacity of the first allocation.
+  static constexpr usize MIN_CAPACITY = 8;
+
+  /// Reallocates the buffer to hold exactly `capacity` (>= `len()`) items.
+  auto setCapacity(usize capacity) -> void {
+    if (capacity == this->buf.len()) {
+      return;
+    }
+    if (capacity > std::numeric_limits<usize>::max() / sizeof(T)) {
+      throw common::OutOfMemoryException(capacity);
+    }
+
+    auto&& allocator = this->allocator.get();
+    if constexpr (mem::TriviallyRelocatable<T>) {
+      // Tries to resize in place first
+      this->buf = allocator.realloc(this->buf, capacity);
+    } else {
+      if (allocator.resize(this->buf, capacity)) {
+        return;
+      }
+      Slice<T> moved = allocator.template allocUninit<T>(capacity);
+      mem::relocate(moved.ptr(), this->buf.ptr(), this->len_);
+      allocator.free(this->buf);
+      this->buf = moved;
+    }
+  }
+
+  /// Returns a pointer to the allocator (`nullptr` for static allocators).
+  auto allocatorPtr() noexcept -> Allocator* {
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      return nullptr;
+    } else {
+      return &this->allocator.get();
+    }
+  }
+
+  auto destroyItems() noexcept -> void {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (usize i = 0; i < this->len_; i++) {
+        this->buf.ptr()[i].~T();
+      }
+    }
+  }
+
+  /// Destroys the items and frees the buffer.
+  auto release() noexcept -> void {
+    this->destroyItems();
+    this->allocator.get().free(this->buf);
+    this->buf  = Slice<T>(nullptr, 0);
+    this->len_ = 0;
+  }
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  Slice<T>                                           buf; // `len` is capacity
+  usize                                              len_ = 0;
+};
+
+} // namespace mu
+
+#endif // !MU_ARRAY_LIST_H
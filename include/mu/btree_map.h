@@ -0,0 +1,838 @@
+#ifndef MU_BTREE_MAP_H
+#define MU_BTREE_MAP_H
+
+#include "mu/common.h"            // OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/scratch.h"       // TempScope
+#include "mu/mem/utils.h"         // TriviallyRelocatable, relocate
+#include "mu/primitives.h"        // usize, u8, u16
+#include "mu/slice.h"             // Slice
+#include <cassert>                // assert
+#include <cstddef>                // max_align_t
+#include <cstring>                // memmove, memset
+#include <functional>             // less
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <type_traits>            // is_arithmetic_v, is_same_v
+#include <utility>                // move
+
+namespace mu {
+
+namespace internal::btree {
+/// Moves `items[idx..len]` one place to the right (to `items[idx + 1..len +
+/// 1]`), leaving `items[idx]` uninitialized.
+template <typename T>
+auto shiftRight(T* items, usize idx, usize len) noexcept -> void {
+  if constexpr (mem::TriviallyRelocatable<T>) {
+    std::memmove(static_cast<void*>(items + idx + 1),
+                 static_cast<const void*>(items + idx),
+                 sizeof(T) * (len - idx));
+  } else {
+    for (usize i = len; i > idx; i--) {
+      new (items + i) T(std::move(items[i - 1]));
+      items[i - 1].~T();
+    }
+  }
+}
+
+/// Moves `items[idx + 1..len]` one place to the left (to `items[idx..len -
+/// 1]`), where `items[idx]` must be uninitialized.
+template <typename T>
+auto shiftLeft(T* items, usize idx, usize len) noexcept -> void {
+  if constexpr (mem::TriviallyRelocatable<T>) {
+    std::memmove(static_cast<void*>(items + idx),
+                 static_cast<const void*>(items + idx + 1),
+                 sizeof(T) * (len - idx - 1));
+  } else {
+    for (usize i = idx + 1; i < len; i++) {
+      new (items + i - 1) T(std::move(items[i]));
+      items[i].~T();
+    }
+  }
+}
+
+/// Determines if the keys of a node can be searched with a branchless scan.
+template <typename K, typename Less>
+inline constexpr bool IS_SCANNABLE =
+    std::is_arithmetic_v<K> && std::is_same_v<Less, std::less<K>>;
+
+/// Returns the number of `keys[0..len]` that are less than `key` (if
+/// `OR_EQUAL` is `false`) or not greater than `key` (if it is `true`).
+///
+/// Arithmetic keys are compared all at once, over the node's whole capacity
+/// `CAP`: the fixed trip count and branchless comparisons let the loop be
+/// vectorized. Other keys are binary searched.
+template <usize CAP, bool OR_EQUAL, typename K, typename Less>
+auto rank(const K* keys, usize len, const K& key, const Less& less) noexcept
+    -> usize {
+  if constexpr (IS_SCANNABLE<K, Less>) {
+    usize count = 0;
+    for (usize i = 0; i < CAP; i++) {
+      bool before = OR_EQUAL ? !(key < keys[i]) : (keys[i] < key);
+      count      += (i < len) & before;
+    }
+    return count;
+  } else {
+    usize lo = 0;
+    usize hi = len;
+    while (lo < hi) {
+      usize mid    = lo + (hi - lo) / 2;
+      bool  before = OR_EQUAL ? !less(key, keys[mid]) : less(keys[mid], key);
+      if (before) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+}
+} // namespace internal::btree
+
+/// An ordered map, stored as a B+ tree with wide nodes.
+///
+/// Each node is a fixed-size block of `NODE_SIZE` bytes holding as many keys
+/// as fit, so lookups touch few cache lines, and the keys of a node are
+/// searched with a (vectorizable) scan for arithmetic keys. All entries are
+/// stored in the leaves, which are linked in key order for range scans.
+///
+/// ## Note
+/// Inserting and removing move entries between nodes, and invalidate
+/// pointers and iterators into the map.
+///
+/// All nodes are `NodeBlock`s, so a `mem::PoolAllocator<NodeBlock>` (or an
+/// arena) can serve them.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename K, typename V, class Allocator = mem::CAllocator,
+          class Less = std::less<K>, usize NODE_SIZE = 512>
+class BTreeMap {
+  static_assert(std::is_nothrow_move_constructible_v<K> &&
+                    std::is_nothrow_move_constructible_v<V>,
+                "`K` and `V` must be nothrow move constructible");
+
+  static constexpr bool SCANNABLE = internal::btree::IS_SCANNABLE<K, Less>;
+
+  /// The space in a node taken by its header (and, at worst, padding).
+  static constexpr usize OVERHEAD =
+      2 * sizeof(void*) + alignof(K) + alignof(V) + alignof(std::max_align_t);
+
+  /// The number of entries in a leaf.
+  static constexpr usize LEAF_CAP =
+      (NODE_SIZE - OVERHEAD) / (sizeof(K) + sizeof(V));
+
+  /// The number of keys in an inner node (which has one more child).
+  static constexpr usize INNER_CAP =
+      (NODE_SIZE - OVERHEAD - sizeof(void*)) / (sizeof(K) + sizeof(void*));
+
+  static_assert(NODE_SIZE > OVERHEAD + 4 * (sizeof(K) + sizeof(V)) &&
+                    (INNER_CAP >= 4),
+                "`NODE_SIZE` must fit at least 4 entries per node");
+  static_assert(LEAF_CAP <= std::numeric_limits<u16>::max(),
+                "`NODE_SIZE` is too large");
+
+  static constexpr usize MIN_LEAF  = LEAF_CAP / 2;
+  static constexpr usize MIN_INNER = INNER_CAP / 2;
+
+  /// The maximum height of the tree (inner nodes have at least 2 children).
+  static constexpr usize MAX_DEPTH = 64;
+
+  struct Node {
+    u16  len;
+    bool is_leaf;
+  };
+
+  struct Leaf : Node {
+    Leaf* next = nullptr;
+    alignas(K) u8 key_buf[sizeof(K) * LEAF_CAP];
+    alignas(V) u8 val_buf[sizeof(V) * LEAF_CAP];
+
+    Leaf() noexcept : Node{0, true} {
+      if constexpr (SCANNABLE) {
+        // The scans read the unused keys too
+        std::memset(this->key_buf, 0, sizeof(this->key_buf));
+      }
+    }
+
+    auto keys() noexcept -> K* { return reinterpret_cast<K*>(this->key_buf); }
+    auto vals() noexcept -> V* { return reinterpret_cast<V*>(this->val_buf); }
+  };
+
+  struct Inner : Node {
+    Node* children[INNER_CAP + 1];
+    alignas(K) u8 key_buf[sizeof(K) * INNER_CAP];
+
+    Inner() noexcept : Node{0, false} {
+      if constexpr (SCANNABLE) {
+        std::memset(this->key_buf, 0, sizeof(this->key_buf));
+      }
+    }
+
+    auto keys() noexcept -> K* { return reinterpret_cast<K*>(this->key_buf); }
+  };
+
+  static_assert((sizeof(Leaf) <= NODE_SIZE) && (sizeof(Inner) <= NODE_SIZE));
+
+public:
+  /// A key and its value (used for bulk loading).
+  struct Entry {
+    K key;
+    V val;
+  };
+
+  /// The block of memory each node is allocated as.
+  struct alignas(alignof(Leaf) > alignof(Inner) ? alignof(Leaf)
+                                                : alignof(Inner)) NodeBlock {
+    u8 bytes[NODE_SIZE];
+  };
+
+  /// Iterates over the entries of a `BTreeMap`, in key order.
+  template <typename E> class Iterator {
+  public:
+    /// References to the key and value of an entry.
+    struct Ref {
+      const K& key;
+      E&       val;
+    };
+
+    auto operator*() const noexcept -> Ref {
+      return Ref{this->leaf->keys()[this->idx], this->leaf->vals()[this->idx]};
+    }
+
+    auto operator++() noexcept -> Iterator& {
+      this->idx++;
+      if (this->idx == this->leaf->len) {
+        this->leaf = this->leaf->next;
+        this->idx  = 0;
+      }
+      return *this;
+    }
+
+    auto operator==(const Iterator& other) const noexcept -> bool {
+      return (this->leaf == other.leaf) && (this->idx == other.idx);
+    }
+
+  private:
+    friend class BTreeMap;
+
+    /// Points to entry `idx` of `leaf`, or to the end if `idx` is past the
+    /// leaf's last entry.
+    explicit Iterator(Leaf* leaf, usize idx) noexcept
+        : leaf{leaf}, idx{idx} {
+      if ((this->leaf != nullptr) && (this->idx == this->leaf->len)) {
+        this->leaf = this->leaf->next;
+        this->idx  = 0;
+      }
+    }
+
+    Leaf* leaf;
+    usize idx;
+  };
+
+  /// The entries with keys in a range, in key order.
+  template <typename E> class Range {
+  public:
+    auto begin() const noexcept -> Iterator<E> { return this->first; }
+    auto end() const noexcept -> Iterator<E> { return this->last; }
+
+  private:
+    friend class BTreeMap;
+
+    explicit Range(Iterator<E> first, Iterator<E> last) noexcept
+        : first{first}, last{last} {}
+
+    Iterator<E> first;
+    Iterator<E> last;
+  };
+
+  BTreeMap(const BTreeMap&)                    = delete;
+  auto operator=(const BTreeMap&) -> BTreeMap& = delete;
+
+  /// Creates an empty map that allocates using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit BTreeMap(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator} {}
+
+  /// Creates a map from `entries`, whose keys must be strictly increasing.
+  ///
+  /// The tree is built bottom-up in O(n) (instead of inserting the entries one
+  /// by one), with the entries spread evenly over the leaves and the children
+  /// over the inner nodes.
+  static auto fromSorted(Allocator* allocator, Slice<Entry> entries)
+      -> BTreeMap {
+    BTreeMap map{allocator};
+    map.bulkLoad(entries);
+    return map;
+  }
+
+  /// Creates a map by transferring the entries from `other`, which is left
+  /// empty.
+  BTreeMap(BTreeMap&& other) noexcept
+      : allocator{other.allocator}, root{other.root}, first{other.first},
+        len_{other.len_}, height{other.height} {
+    other.forget();
+  }
+
+  /// Move assignment operator.
+  auto operator=(BTreeMap&& other) noexcept -> BTreeMap& {
+    if (this != &other) {
+      this->release();
+      this->allocator = other.allocator;
+      this->root      = other.root;
+      this->first     = other.first;
+      this->len_      = other.len_;
+      this->height    = other.height;
+      other.forget();
+    }
+    return *this;
+  }
+
+  ~BTreeMap() noexcept { this->release(); }
+
+  /// Returns a pointer to the value of `key`, or `nullptr` if there is none.
+  auto get(const K& key) noexcept -> V* {
+    Leaf* leaf = this->findLeaf(key);
+    if (leaf == nullptr) {
+      return nullptr;
+    }
+    usize idx = lowerBound(leaf, key);
+    return this->isAt(leaf, idx, key) ? &leaf->vals()[idx] : nullptr;
+  }
+
+  /// Returns a pointer to the value of `key`, or `nullptr` if there is none.
+  auto get(const K& key) const noexcept -> const V* {
+    return const_cast<BTreeMap*>(this)->get(key);
+  }
+
+  /// Returns `true` if the map contains `key`.
+  auto contains(const K& key) const noexcept -> bool {
+    return this->get(key) != nullptr;
+  }
+
+  /// Maps `key` to `val`, replacing its previous value if it has one.
+  ///
+  /// Returns `true` if `key` was not in the map.
+  auto put(K key, V val) -> bool {
+    if (this->root == nullptr) {
+      Leaf* leaf  = this->createNode<Leaf>();
+      this->root  = leaf;
+      this->first = leaf;
+    }
+
+    Path  path;
+    Leaf* leaf = this->descend(key, path);
+    usize idx  = lowerBound(leaf, key);
+    if (this->isAt(leaf, idx, key)) {
+      leaf->vals()[idx] = std::move(val);
+      return false;
+    }
+
+    if (leaf->len < LEAF_CAP) {
+      insertIntoLeaf(leaf, idx, std::move(key), std::move(val));
+    } else {
+      Leaf* right = this->splitLeaf(leaf, idx, std::move(key), std::move(val));
+      this->insertIntoParents(path, right->keys()[0], right);
+    }
+    this->len_++;
+    return true;
+  }
+
+  /// Removes `key` from the map.
+  ///
+  /// Returns `false` if `key` was not in the map.
+  auto remove(const K& key) noexcept -> bool {
+    if (this->root == nullptr) {
+      return false;
+    }
+
+    Path  path;
+    Leaf* leaf = this->descend(key, path);
+    usize idx  = lowerBound(leaf, key);
+    if (!this->isAt(leaf, idx, key)) {
+      return false;
+    }
+
+    leaf->keys()[idx].~K();
+    leaf->vals()[idx].~V();
+    internal::btree::shiftLeft(leaf->keys(), idx, leaf->len);
+    internal::btree::shiftLeft(leaf->vals(), idx, leaf->len);
+    leaf->len--;
+    this->len_--;
+    this->rebalance(path, leaf);
+    return true;
+  }
+
+  /// Returns the number of entries in the map.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Removes all entries from the map (and frees all nodes).
+  auto clear() noexcept -> void { this->release(); }
+
+  /// Returns an iterator to the first entry whose key is not less than `key`.
+  auto lowerBound(const K& key) noexcept -> Iterator<V> {
+    Leaf* leaf = this->findLeaf(key);
+    if (leaf == nullptr) {
+      return this->end();
+    }
+    return Iterator<V>(leaf, lowerBound(leaf, key));
+  }
+
+  /// Returns an iterator to the first entry whose key is not less than `key`.
+  auto lowerBound(const K& key) const noexcept -> Iterator<const V> {
+    Iterator<V> it = const_cast<BTreeMap*>(this)->lowerBound(key);
+    return Iterator<const V>(it.leaf, it.idx);
+  }
+
+  /// Returns the entries with keys in `[lo, hi)`, in key order.
+  auto range(const K& lo, const K& hi) noexcept -> Range<V> {
+    if (!Less{}(lo, hi)) {
+      return Range<V>(this->end(), this->end());
+    }
+    return Range<V>(this->lowerBound(lo), this->lowerBound(hi));
+  }
+
+  /// Returns the entries with keys in `[lo, hi)`, in key order.
+  auto range(const K& lo, const K& hi) const noexcept -> Range<const V> {
+    if (!Less{}(lo, hi)) {
+      return Range<const V>(this->end(), this->end());
+    }
+    return Range<const V>(this->lowerBound(lo), this->lowerBound(hi));
+  }
+
+  auto begin() noexcept -> Iterator<V> { return Iterator<V>(this->first, 0); }
+  auto end() noexcept -> Iterator<V> { return Iterator<V>(nullptr, 0); }
+  auto begin() const noexcept -> Iterator<const V> {
+    return Iterator<const V>(this->first, 0);
+  }
+  auto end() const noexcept -> Iterator<const V> {
+    return Iterator<const V>(nullptr, 0);
+  }
+
+private:
+  /// The inner nodes visited on the way to a leaf, and the index of the child
+  /// taken in each.
+  struct Path {
+    Inner* nodes[MAX_DEPTH];
+    usize  idxs[MAX_DEPTH];
+    usize  len = 0;
+  };
+
+  /// Returns the index of the first key of `leaf` that is not less than `key`.
+  static auto lowerBound(Leaf* leaf, const K& key) noexcept -> usize {
+    return internal::btree::rank<LEAF_CAP, false>(leaf->keys(), leaf->len,
+                                                   key, Less{});
+  }
+
+  /// Returns the index of the child of `node` whose subtree holds `key`.
+  static auto childIdx(Inner* node, const K& key) noexcept -> usize {
+    return internal::btree::rank<INNER_CAP, true>(node->keys(), node->len,
+                                                   key, Less{});
+  }
+
+  /// Checks if entry `idx` of `leaf` has key `key`.
+  static auto isAt(Leaf* leaf, usize idx, const K& key) noexcept -> bool {
+    return (idx < leaf->len) && !Less{}(key, leaf->keys()[idx]);
+  }
+
+  /// Returns the leaf whose range holds `key`, or `nullptr` if the map is
+  /// empty.
+  auto findLeaf(const K& key) const noexcept -> Leaf* {
+    Node* node = this->root;
+    if (node == nullptr) {
+      return nullptr;
+    }
+    while (!node->is_leaf) {
+      Inner* inner = static_cast<Inner*>(node);
+      node         = inner->children[childIdx(inner, key)];
+    }
+    return static_cast<Leaf*>(node);
+  }
+
+  /// Returns the leaf whose range holds `key`, recording the way to it in
+  /// `path`.
+  auto descend(const K& key, Path& path) noexcept -> Leaf* {
+    Node* node = this->root;
+    while (!node->is_leaf) {
+      Inner* inner          = static_cast<Inner*>(node);
+      usize  idx            = childIdx(inner, key);
+      path.nodes[path.len]  = inner;
+      path.idxs[path.len]   = idx;
+      path.len++;
+      node = inner->children[idx];
+    }
+    return static_cast<Leaf*>(node);
+  }
+
+  template <typename N> auto createNode() -> N* {
+    void* mem =
+        this->allocator.get().rawAlloc(sizeof(NodeBlock), alignof(NodeBlock));
+    if (mem == nullptr) {
+      throw common::OutOfMemoryException(sizeof(NodeBlock));
+    }
+    return new (mem) N();
+  }
+
+  auto freeNode(Node* node) noexcept -> void {
+    this->allocator.get().rawFree(node, sizeof(NodeBlock), alignof(NodeBlock));
+  }
+
+  /// Inserts an entry at index `idx` of `leaf`, which must not be full.
+  static auto insertIntoLeaf(Leaf* leaf, usize idx, K&& key, V&& val) noexcept
+      -> void {
+    internal::btree::shiftRight(leaf->keys(), idx, leaf->len);
+    internal::btree::shiftRight(leaf->vals(), idx, leaf->len);
+    new (leaf->keys() + idx) K(std::move(key));
+    new (leaf->vals() + idx) V(std::move(val));
+    leaf->len++;
+  }
+
+  /// Inserts `key` at index `idx` of `node` (which must not be full), with
+  /// `child` as the child to its right.
+  static auto insertIntoInner(Inner* node, usize idx, const K& key,
+                              Node* child) -> void {
+    internal::btree::shiftRight(node->keys(), idx, node->len);
+    internal::btree::shiftRight(node->children, idx + 1, node->len + 1);
+    new (node->keys() + idx) K(key);
+    node->children[idx + 1] = child;
+    node->len++;
+  }
+
+  /// Splits the full `leaf` in two while inserting an entry at index `idx`,
+  /// and returns the new right half.
+  auto splitLeaf(Leaf* leaf, usize idx, K&& key, V&& val) -> Leaf* {
+    Leaf* right = this->createNode<Leaf>();
+    usize half  = LEAF_CAP / 2;
+    mem::relocate(right->keys(), leaf->keys() + half, LEAF_CAP - half);
+    mem::relocate(right->vals(), leaf->vals() + half, LEAF_CAP - half);
+    right->len  = LEAF_CAP - half;
+    leaf->len   = half;
+    right->next = leaf->next;
+    leaf->next  = right;
+
+    if (idx <= half) {
+      insertIntoLeaf(leaf, idx, std::move(key), std::move(val));
+    } else {
+      insertIntoLeaf(right, idx - half, std::move(key), std::move(val));
+    }
+    return right;
+  }
+
+  /// Inserts the separator `key` and the new node `right` (split off the node
+  /// at the end of `path`) into the parents, splitting them as needed.
+  auto insertIntoParents(Path& path, const K& key, Node* right) -> void {
+    K     sep   = key;
+    Node* child = right;
+    for (usize level = path.len; level > 0; level--) {
+      Inner* node = path.nodes[level - 1];
+      usize  idx  = path.idxs[level - 1];
+      if (node->len < INNER_CAP) {
+        insertIntoInner(node, idx, sep, child);
+        return;
+      }
+
+      // Splits the node around its middle key, which moves up
+      Inner* split = this->createNode<Inner>();
+      usize  mid   = INNER_CAP / 2;
+      K      up    = std::move(node->keys()[mid]);
+      node->keys()[mid].~K();
+      mem::relocate(split->keys(), node->keys() + mid + 1,
+                    INNER_CAP - mid - 1);
+      for (usize i = mid + 1; i <= INNER_CAP; i++) {
+        split->children[i - mid - 1] = node->children[i];
+      }
+      split->len = INNER_CAP - mid - 1;
+      node->len  = mid;
+
+      if (idx <= mid) {
+        insertIntoInner(node, idx, sep, child);
+      } else {
+        insertIntoInner(split, idx - mid - 1, sep, child);
+      }
+      sep   = std::move(up);
+      child = split;
+    }
+
+    // The root was split
+    Inner* root = this->createNode<Inner>();
+    new (root->keys()) K(std::move(sep));
+    root->children[0] = this->root;
+    root->children[1] = child;
+    root->len         = 1;
+    this->root        = root;
+    this->height++;
+  }
+
+  /// Restores the minimum fill of `node` (the node at the end of `path`)
+  /// after an entry was removed from it, by borrowing from or merging with a
+  /// sibling, up to the root.
+  auto rebalance(Path& path, Node* node) noexcept -> void {
+    for (usize level = path.len; level > 0; level--) {
+      usize min = node->is_leaf ? MIN_LEAF : MIN_INNER;
+      if (node->len >= min) {
+        return;
+      }
+
+      Inner* parent = path.nodes[level - 1];
+      usize  idx    = path.idxs[level - 1];
+      Node*  left   = (idx > 0) ? parent->children[idx - 1] : nullptr;
+      Node*  right =
+          (idx < parent->len) ? parent->children[idx + 1] : nullptr;
+      if ((left != nullptr) && (left->len > min)) {
+        this->borrowFromLeft(parent, idx, node, left);
+        return;
+      }
+      if ((right != nullptr) && (right->len > min)) {
+        this->borrowFromRight(parent, idx, node, right);
+        return;
+      }
+
+      // Merges with a sibling, which removes a key from the parent
+      if (left != nullptr) {
+        this->merge(parent, idx - 1, left, node);
+      } else {
+        this->merge(parent, idx, node, right);
+      }
+      node = parent;
+    }
+
+    // Shrinks the tree if the root is left empty
+    if (this->root->len == 0) {
+      Node* old = this->root;
+      if (old->is_leaf) {
+        this->root  = nullptr;
+        this->first = nullptr;
+      } else {
+        this->root = static_cast<Inner*>(old)->children[0];
+        this->height--;
+      }
+      this->freeNode(old);
+    }
+  }
+
+  /// Moves the last entry (or child) of `left` to the front of `node`, the
+  /// child at index `idx` of `parent`.
+  static auto borrowFromLeft(Inner* parent, usize idx, Node* node,
+                             Node* left) noexcept -> void {
+    K& sep = parent->keys()[idx - 1];
+    if (node->is_leaf) {
+      Leaf* dst = static_cast<Leaf*>(node);
+      Leaf* src = static_cast<Leaf*>(left);
+      usize len = src->len - 1;
+      internal::btree::shiftRight(dst->keys(), 0, dst->len);
+      internal::btree::shiftRight(dst->vals(), 0, dst->len);
+      mem::relocate(dst->keys(), src->keys() + len, 1);
+      mem::relocate(dst->vals(), src->vals() + len, 1);
+      sep = dst->keys()[0];
+    } else {
+      // Rotates through the parent
+      Inner* dst = static_cast<Inner*>(node);
+      Inner* src = static_cast<Inner*>(left);
+      usize  len = src->len - 1;
+      internal::btree::shiftRight(dst->keys(), 0, dst->len);
+      internal::btree::shiftRight(dst->children, 0, dst->len + 1);
+      new (dst->keys()) K(std::move(sep));
+      dst->children[0] = src->children[len + 1];
+      sep              = std::move(src->keys()[len]);
+      src->keys()[len].~K();
+    }
+    node->len++;
+    left->len--;
+  }
+
+  /// Moves the first entry (or child) of `right` to the back of `node`, the
+  /// child at index `idx` of `parent`.
+  static auto borrowFromRight(Inner* parent, usize idx, Node* node,
+                              Node* right) noexcept -> void {
+    K& sep = parent->keys()[idx];
+    if (node->is_leaf) {
+      Leaf* dst = static_cast<Leaf*>(node);
+      Leaf* src = static_cast<Leaf*>(right);
+      mem::relocate(dst->keys() + dst->len, src->keys(), 1);
+      mem::relocate(dst->vals() + dst->len, src->vals(), 1);
+      internal::btree::shiftLeft(src->keys(), 0, src->len);
+      internal::btree::shiftLeft(src->vals(), 0, src->len);
+      sep = src->keys()[0];
+    } else {
+      Inner* dst = static_cast<Inner*>(node);
+      Inner* src = static_cast<Inner*>(right);
+      new (dst->keys() + dst->len) K(std::move(sep));
+      dst->children[dst->len + 1] = src->children[0];
+      sep                         = std::move(src->keys()[0]);
+      src->keys()[0].~K();
+      internal::btree::shiftLeft(src->keys(), 0, src->len);
+      internal::btree::shiftLeft(src->children, 0, src->len + 1);
+    }
+    node->len++;
+    right->len--;
+  }
+
+  /// Moves everything in `right` (the child at index `idx + 1` of `parent`)
+  /// into `left` (the child at index `idx`), and frees `right`.
+  auto merge(Inner* parent, usize idx, Node* left, Node* right) noexcept
+      -> void {
+    if (left->is_leaf) {
+      Leaf* dst = static_cast<Leaf*>(left);
+      Leaf* src = static_cast<Leaf*>(right);
+      mem::relocate(dst->keys() + dst->len, src->keys(), src->len);
+      mem::relocate(dst->vals() + dst->len, src->vals(), src->len);
+      dst->next = src->next;
+    } else {
+      // The separator moves down between the two halves
+      Inner* dst = static_cast<Inner*>(left);
+      Inner* src = static_cast<Inner*>(right);
+      new (dst->keys() + dst->len) K(std::move(parent->keys()[idx]));
+      mem::relocate(dst->keys() + dst->len + 1, src->keys(), src->len);
+      for (usize i = 0; i <= src->len; i++) {
+        dst->children[dst->len + 1 + i] = src->children[i];
+      }
+      left->len++;
+    }
+    left->len += right->len;
+    this->freeNode(right);
+
+    parent->keys()[idx].~K();
+    internal::btree::shiftLeft(parent->keys(), idx, parent->len);
+    internal::btree::shiftLeft(parent->children, idx + 1, parent->len + 1);
+    parent->len--;
+  }
+
+  /// Builds the tree from `entries` (the map must be empty), bottom-up.
+  auto bulkLoad(Slice<Entry> entries) -> void {
+    usize        len = entries.len();
+    const Entry* src = entries.ptr();
+    if (len == 0) {
+      return;
+    }
+    for (usize i = 1; i < len; i++) {
+      assert(Less{}(src[i - 1].key, src[i].key));
+    }
+
+    // The nodes of the level being grouped (and their smallest keys) are
+    // temporaries, so they go in the thread's scratch arena
+    struct Built {
+      Node*    node;
+      const K* min;
+    };
+    mem::TempScope scope{};
+    usize          num_leaves = (len + LEAF_CAP - 1) / LEAF_CAP;
+    Built*         level =
+        scope.arenaAllocator().allocUninit<Built>(num_leaves).ptr();
+
+    // Nothing is published until the tree is complete: if building throws,
+    // the subtrees owned by `level[0..done]` and `level[child..num_nodes]` are
+    // freed instead
+    usize done      = 0;
+    usize child     = 0;
+    usize num_nodes = 0;
+    usize levels    = 0;
+    Leaf* first     = nullptr;
+    try {
+      // Fills the leaves (as evenly as possible), linking them in order
+      usize next = 0;
+      for (usize n = 0; n < num_leaves; n++) {
+        Leaf* leaf = this->createNode<Leaf>();
+        level[n]   = Built{leaf, leaf->keys()};
+        done       = n + 1;
+        if (n > 0) {
+          static_cast<Leaf*>(level[n - 1].node)->next = leaf;
+        }
+        usize fill = len / num_leaves + (n < len % num_leaves);
+        for (usize i = 0; i < fill; i++, next++) {
+          new (leaf->keys() + i) K(src[next].key);
+          new (leaf->vals() + i) V(src[next].val);
+          leaf->len++;
+        }
+      }
+
+      // Groups each level's nodes under parents, until there is one node
+      first     = static_cast<Leaf*>(level[0].node);
+      num_nodes = num_leaves;
+      done      = 0;
+      while (num_nodes > 1) {
+        usize num_parents = (num_nodes + INNER_CAP) / (INNER_CAP + 1);
+        child             = 0;
+        for (usize n = 0; n < num_parents; n++) {
+          Inner*   node = this->createNode<Inner>();
+          usize    fill =
+              num_nodes / num_parents + (n < num_nodes % num_parents);
+          const K* min  = level[child].min;
+          node->children[0] = level[child++].node;
+          level[n]          = Built{node, min};
+          done              = n + 1;
+          for (usize i = 1; i < fill; i++, child++) {
+            new (node->keys() + i - 1) K(*level[child].min);
+            node->children[i] = level[child].node;
+            node->len++;
+          }
+        }
+        num_nodes = num_parents;
+        done      = 0;
+        child     = 0;
+        levels++;
+      }
+    } catch (...) {
+      for (usize i = 0; i < done; i++) {
+        this->freeTree(level[i].node);
+      }
+      for (usize i = child; i < num_nodes; i++) {
+        this->freeTree(level[i].node);
+      }
+      throw;
+    }
+
+    this->root   = level[0].node;
+    this->first  = first;
+    this->len_   = len;
+    this->height = levels;
+  }
+
+  /// Destroys the entries in (and frees) `node` and its subtree.
+  auto freeTree(Node* node) noexcept -> void {
+    if (node->is_leaf) {
+      Leaf* leaf = static_cast<Leaf*>(node);
+      for (usize i = 0; i < leaf->len; i++) {
+        leaf->keys()[i].~K();
+        leaf->vals()[i].~V();
+      }
+    } else {
+      Inner* inner = static_cast<Inner*>(node);
+      for (usize i = 0; i < inner->len; i++) {
+        inner->keys()[i].~K();
+      }
+      for (usize i = 0; i <= inner->len; i++) {
+        this->freeTree(inner->children[i]);
+      }
+    }
+    this->freeNode(node);
+  }
+
+  /// Destroys the entries and frees all nodes.
+  auto release() noexcept -> void {
+    if (this->root != nullptr) {
+      this->freeTree(this->root);
+    }
+    this->forget();
+  }
+
+  /// Leaves the map empty without freeing anything.
+  auto forget() noexcept -> void {
+    this->root   = nullptr;
+    this->first  = nullptr;
+    this->len_   = 0;
+    this->height = 0;
+  }
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  Node*                                              root   = nullptr;
+  Leaf*                                              first  = nullptr;
+  usize                                              len_   = 0;
+  usize                                              height = 0;
+};
+
+} // namespace mu
+
+#endif // !MU_BTREE_MAP_H
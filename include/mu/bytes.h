@@ -0,0 +1,62 @@
+#ifndef MU_BYTES_H
+#define MU_BYTES_H
+
+#include "mu/primitives.h" // usize, u64
+
+namespace mu::internal::bytes {
+
+/// The instruction sets the byte search kernels are implemented with.
+enum class Isa {
+  /// Plain C++, one byte at a time.
+  Scalar,
+  /// 16 bytes at a time (always available on x86-64).
+  Sse2,
+  /// 32 bytes at a time.
+  Avx2,
+  /// 64 bytes at a time, with masked loads for the tail (needs AVX-512BW).
+  Avx512,
+};
+
+/// Returns the best instruction set the CPU supports.
+///
+/// The CPU is only queried once; the kernels below (without an `Isa`
+/// argument) always use this one.
+auto bestIsa() noexcept -> Isa;
+
+/// Checks if the CPU supports `isa`.
+auto isSupported(Isa isa) noexcept -> bool;
+
+/// Returns the index of the first `byte` in `ptr[0..len]`, or `len` if there
+/// is none.
+auto indexOf(const char* ptr, usize len, char byte) noexcept -> usize;
+
+/// Returns the index of the first byte of `ptr[0..len]` that is in
+/// `set[0..set_len]`, or `len` if there is none.
+auto indexOfAny(const char* ptr, usize len, const char* set,
+                usize set_len) noexcept -> usize;
+
+/// Returns the number of `byte`s in `ptr[0..len]`.
+auto count(const char* ptr, usize len, char byte) noexcept -> usize;
+
+/// Returns the positions of `byte` in `ptr[0..min(len, 64)]`, one bit per
+/// position (for iterating over many nearby matches with one search).
+auto matchMask(const char* ptr, usize len, char byte) noexcept -> u64;
+
+/// `indexOf`, using the kernel for `isa` (which must be supported).
+auto indexOf(Isa isa, const char* ptr, usize len, char byte) noexcept
+    -> usize;
+
+/// `indexOfAny`, using the kernel for `isa` (which must be supported).
+auto indexOfAny(Isa isa, const char* ptr, usize len, const char* set,
+                usize set_len) noexcept -> usize;
+
+/// `count`, using the kernel for `isa` (which must be supported).
+auto count(Isa isa, const char* ptr, usize len, char byte) noexcept -> usize;
+
+/// `matchMask`, using the kernel for `isa` (which must be supported).
+auto matchMask(Isa isa, const char* ptr, usize len, char byte) noexcept
+    -> u64;
+
+} // namespace mu::internal::bytes
+
+#endif // !MU_BYTES_H
@@ -46,6 +46,13 @@ struct ResultUnwrapOkException : public std::exception {
   auto what() const throw() -> const_cstr override;
 };
 
+/// The exception thrown if an allocator of the wrong type is passed to a
+/// container that was declared with a static allocator.
+struct AllocatorMismatchException : public std::exception {
+  /// Explains the error.
+  auto what() const throw() -> const_cstr override;
+};
+
 /// Index out of bounds exception.
 struct IndexOutOfBounds : public std::exception {
   explicit IndexOutOfBounds(usize idx, usize len) : idx{idx}, len{len} {}
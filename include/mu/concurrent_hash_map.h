@@ -0,0 +1,257 @@
+#ifndef MU_CONCURRENT_HASH_MAP_H
+#define MU_CONCURRENT_HASH_MAP_H
+
+#include "mu/hash.h"            // Hash, Eq
+#include "mu/hash_map.h"        // HashMap
+#include "mu/mem/allocator.h"   // Allocator, isPowerOf2
+#include "mu/mem/c_allocator.h" // CAllocator
+#include "mu/mem/scratch.h"     // TempScope
+#include "mu/optional.h"        // Optional
+#include "mu/primitives.h"      // usize, u64
+#include "mu/slice.h"           // Slice
+#include <bit>                  // countr_zero
+#include <cassert>              // assert
+#include <mutex>                // unique_lock
+#include <shared_mutex>         // shared_mutex, shared_lock
+#include <utility>              // forward, move
+
+namespace mu {
+
+/// A `HashMap` that can be used by many threads at once.
+///
+/// The keys are split between `SHARDS` independent `HashMap`s (by the top
+/// bits of their hashes), each behind its own reader-writer lock, so threads
+/// only contend when they use the same shard, and readers never block each
+/// other.
+///
+/// ## Note
+/// Values are returned by copy, since references into a shard can't outlive
+/// its lock.
+///
+/// The batched `getMany` and `putMany` group their keys by shard, and lock
+/// each shard only once per batch.
+template <typename K, typename V, class Allocator = mem::CAllocator,
+          class Hasher = Hash<K>, class KeyEq = Eq<K>, usize SHARDS = 64>
+class ConcurrentHashMap {
+  static_assert(mem::isPowerOf2(SHARDS), "`SHARDS` must be a power of 2");
+
+  using Map = HashMap<K, V, Allocator, Hasher, KeyEq>;
+
+  /// A shard is aligned to a cache line, so that its lock doesn't share a
+  /// line with its neighbors'.
+  struct alignas(64) Shard {
+    mutable std::shared_mutex lock;
+    Map                       map;
+  };
+
+public:
+  static constexpr usize NUM_SHARDS = SHARDS;
+
+  ConcurrentHashMap(const ConcurrentHashMap&)                    = delete;
+  ConcurrentHashMap(ConcurrentHashMap&&)                         = delete;
+  auto operator=(const ConcurrentHashMap&) -> ConcurrentHashMap& = delete;
+  auto operator=(ConcurrentHashMap&&) -> ConcurrentHashMap&      = delete;
+
+  /// Creates an empty map whose shards all allocate using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` must be thread-safe, since the shards use it concurrently.
+  /// It is ignored (and may be `nullptr`) for static allocators.
+  explicit ConcurrentHashMap(Allocator* allocator = nullptr) {
+    for (Shard& shard : this->shards) {
+      shard.map = Map(allocator);
+    }
+  }
+
+  /// Creates an empty map where shard `i` allocates using `allocators[i]`.
+  ///
+  /// A shard only uses its allocator while holding its lock, so the
+  /// allocators don't need to be thread-safe (e.g. one arena per shard).
+  explicit ConcurrentHashMap(Slice<Allocator*> allocators) {
+    assert(allocators.len() == SHARDS);
+    for (usize i = 0; i < SHARDS; i++) {
+      this->shards[i].map = Map(allocators.ptr()[i]);
+    }
+  }
+
+  /// Returns (a copy of) the value of `key`, if there is one.
+  auto get(const K& key) const -> Optional<V> {
+    u64                                 hash  = Hasher{}(key);
+    Shard&                              shard = this->shardOf(hash);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    V*                                  val = shard.map.getHashed(key, hash);
+    return (val == nullptr) ? Optional<V>() : Optional<V>(V(*val));
+  }
+
+  /// Returns `true` if the map contains `key`.
+  auto contains(const K& key) const -> bool {
+    u64                                 hash  = Hasher{}(key);
+    Shard&                              shard = this->shardOf(hash);
+    std::shared_lock<std::shared_mutex> lock(shard.lock);
+    return shard.map.getHashed(key, hash) != nullptr;
+  }
+
+  /// Maps `key` to `val`, replacing its previous value if it has one.
+  ///
+  /// Returns `true` if `key` was not in the map.
+  auto put(K key, V val) -> bool {
+    u64                                 hash  = Hasher{}(key);
+    Shard&                              shard = this->shardOf(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    return shard.map.putHashed(std::move(key), std::move(val), hash);
+  }
+
+  /// Removes `key` from the map.
+  ///
+  /// Returns `false` if `key` was not in the map.
+  auto remove(const K& key) -> bool {
+    u64                                 hash  = Hasher{}(key);
+    Shard&                              shard = this->shardOf(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    return shard.map.removeHashed(key, hash);
+  }
+
+  /// Calls `func` with a reference to the value of `key` (if there is one),
+  /// while holding its shard's lock, so the value can be updated atomically.
+  ///
+  /// Returns `false` if `key` is not in the map.
+  template <typename F> auto update(const K& key, F&& func) -> bool {
+    u64                                 hash  = Hasher{}(key);
+    Shard&                              shard = this->shardOf(hash);
+    std::unique_lock<std::shared_mutex> lock(shard.lock);
+    V*                                  val = shard.map.getHashed(key, hash);
+    if (val == nullptr) {
+      return false;
+    }
+    std::forward<F>(func)(*val);
+    return true;
+  }
+
+  /// Looks up all `keys` at once: if `keys[i]` is in the map, its value is
+  /// copied to `vals[i]` and `found[i]` is set to `true`; otherwise `vals[i]`
+  /// is left untouched and `found[i]` is set to `false`.
+  ///
+  /// Returns the number of keys that were found.
+  auto getMany(Slice<K> keys, Slice<V> vals, Slice<bool> found) const
+      -> usize {
+    assert((vals.len() == keys.len()) && (found.len() == keys.len()));
+    usize hits = 0;
+    this->forEachShard(keys, [&](Shard& shard, const usize* idxs, usize len,
+                                 const u64* hashes) {
+      std::shared_lock<std::shared_mutex> lock(shard.lock);
+      for (usize i = 0; i < len; i++) {
+        usize idx = idxs[i];
+        V*    val = shard.map.getHashed(keys.ptr()[idx], hashes[idx]);
+        found.ptr()[idx] = (val != nullptr);
+        if (val != nullptr) {
+          vals.ptr()[idx] = *val;
+          hits++;
+        }
+      }
+    });
+    return hits;
+  }
+
+  /// Maps each of `keys[i]` to (a copy of) `vals[i]`.
+  ///
+  /// Returns the number of keys that were not in the map.
+  auto putMany(Slice<K> keys, Slice<V> vals) -> usize {
+    assert(vals.len() == keys.len());
+    usize inserted = 0;
+    this->forEachShard(keys, [&](Shard& shard, const usize* idxs, usize len,
+                                 const u64* hashes) {
+      std::unique_lock<std::shared_mutex> lock(shard.lock);
+      for (usize i = 0; i < len; i++) {
+        usize idx  = idxs[i];
+        inserted  += shard.map.putHashed(keys.ptr()[idx], vals.ptr()[idx],
+                                         hashes[idx]);
+      }
+    });
+    return inserted;
+  }
+
+  /// Returns the number of entries in the map.
+  ///
+  /// ## Note
+  /// The shards are counted one by one, so this is only a snapshot if other
+  /// threads modify the map concurrently.
+  auto len() const -> usize {
+    usize len = 0;
+    for (const Shard& shard : this->shards) {
+      std::shared_lock<std::shared_mutex> lock(shard.lock);
+      len += shard.map.len();
+    }
+    return len;
+  }
+
+  /// Removes all entries from the map.
+  auto clear() -> void {
+    for (Shard& shard : this->shards) {
+      std::unique_lock<std::shared_mutex> lock(shard.lock);
+      shard.map.clear();
+    }
+  }
+
+private:
+  static constexpr usize SHARD_BITS = std::countr_zero(SHARDS);
+
+  /// Returns the index of the shard that holds the keys with hash `hash`.
+  ///
+  /// This uses the top bits of the hash, since the shard's `HashMap` uses the
+  /// bottom ones.
+  static auto shardIdx(u64 hash) noexcept -> usize {
+    if constexpr (SHARDS == 1) {
+      return 0;
+    } else {
+      return hash >> (64 - SHARD_BITS);
+    }
+  }
+
+  /// Returns the shard that holds the keys with hash `hash`.
+  auto shardOf(u64 hash) const noexcept -> Shard& {
+    return this->shards[shardIdx(hash)];
+  }
+
+  /// Calls `func(shard, idxs, len, hashes)` once for each shard that holds
+  /// any of `keys`, where `idxs[0..len]` are the indices of those keys and
+  /// `hashes` are the hashes of all keys.
+  template <typename F>
+  auto forEachShard(Slice<K> keys, F&& func) const -> void {
+    // The hashes and the keys' indices (grouped by shard, with a counting
+    // sort) are temporaries, so they go in the thread's scratch arena
+    mem::TempScope       scope{};
+    mem::ArenaAllocator& arena  = scope.arenaAllocator();
+    usize                len    = keys.len();
+    Slice<u64>           hashes = arena.allocUninit<u64>(len);
+    Slice<usize>         idxs   = arena.allocUninit<usize>(len);
+
+    usize                starts[SHARDS + 1] = {};
+    for (usize i = 0; i < len; i++) {
+      hashes.ptr()[i] = Hasher{}(keys.ptr()[i]);
+      starts[shardIdx(hashes.ptr()[i]) + 1]++;
+    }
+    for (usize s = 0; s < SHARDS; s++) {
+      starts[s + 1] += starts[s];
+    }
+    usize next[SHARDS];
+    for (usize s = 0; s < SHARDS; s++) {
+      next[s] = starts[s];
+    }
+    for (usize i = 0; i < len; i++) {
+      idxs.ptr()[next[shardIdx(hashes.ptr()[i])]++] = i;
+    }
+
+    for (usize s = 0; s < SHARDS; s++) {
+      if (starts[s] != starts[s + 1]) {
+        func(this->shards[s], idxs.ptr() + starts[s], starts[s + 1] - starts[s],
+             hashes.ptr());
+      }
+    }
+  }
+
+  mutable Shard shards[SHARDS];
+};
+
+} // namespace mu
+
+#endif // !MU_CONCURRENT_HASH_MAP_H
@@ -0,0 +1,52 @@
+#ifndef MU_CRC32C_H
+#define MU_CRC32C_H
+
+#include "mu/primitives.h" // usize, u32
+#include "mu/slice.h"      // Slice
+
+namespace mu {
+
+namespace internal::crc32c {
+/// The ways the checksum can be computed.
+enum class Impl {
+  /// Slicing-by-8 tables, 8 bytes per step (works everywhere).
+  Table,
+  /// The SSE4.2 `crc32` instruction, 8 bytes per step.
+  Sse42,
+  /// Three interleaved `crc32` streams for long buffers (hiding the
+  /// instruction's latency), joined with carry-less multiplies (needs
+  /// PCLMULQDQ).
+  Pclmul,
+};
+
+/// Returns the fastest implementation the CPU supports.
+///
+/// The CPU is only queried once; `crc32c` always uses this one.
+auto bestImpl() noexcept -> Impl;
+
+/// Checks if the CPU supports `impl`.
+auto isSupported(Impl impl) noexcept -> bool;
+
+/// `crc32c`, using `impl` (which must be supported).
+auto crc32c(Impl impl, const void* data, usize len, u32 crc) noexcept -> u32;
+} // namespace internal::crc32c
+
+/// Returns the CRC32C (Castagnoli) checksum of the `len` bytes at `data`.
+///
+/// `crc` is the checksum of the bytes before these (0 for none), so a buffer
+/// can be checksummed in pieces: `crc32c(b, lb, crc32c(a, la))` is the
+/// checksum of `a` followed by `b`.
+///
+/// ## Note
+/// This is the CRC used by iSCSI, ext4 and SCTP (the reflected polynomial
+/// `0x82f63b78`, with the register inverted before and after).
+auto crc32c(const void* data, usize len, u32 crc = 0) noexcept -> u32;
+
+/// Returns the CRC32C checksum of `bytes`, continuing from `crc`.
+inline auto crc32c(Slice<u8> bytes, u32 crc = 0) noexcept -> u32 {
+  return crc32c(bytes.ptr(), bytes.len(), crc);
+}
+
+} // namespace mu
+
+#endif // !MU_CRC32C_H
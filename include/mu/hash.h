@@ -0,0 +1,315 @@
+#ifndef MU_HASH_H
+#define MU_HASH_H
+
+#include "mu/bytes.h"      // Isa
+#include "mu/cloneable.h"  // Copyable
+#include "mu/primitives.h" // usize, u8, u32, u64
+#include "mu/slice.h"      // Slice
+#include <array>           // array
+#include <bit>             // endian, rotl
+#include <concepts>        // integral
+#include <cstring>         // memcpy, memcmp
+#include <type_traits>     // is_enum_v, is_pointer_v, is_array_v, ...
+
+namespace mu {
+
+/// Mixes the bits of `val`, so that every input bit affects every output bit.
+///
+/// ## Note
+/// This is the finalizer of MurmurHash3; it is a bijection, so distinct
+/// integers never collide.
+constexpr auto mix64(u64 val) noexcept -> u64 {
+  val ^= val >> 33;
+  val *= 0xff51afd7ed558ccd;
+  val ^= val >> 33;
+  val *= 0xc4ceb9fe1a85ec53;
+  val ^= val >> 33;
+  return val;
+}
+
+namespace internal::hash {
+/// Reads 8 (little-endian) bytes from `ptr`.
+inline auto read64(const u8* ptr) noexcept -> u64 {
+  u64 val;
+  std::memcpy(&val, ptr, sizeof(val));
+  if constexpr (std::endian::native == std::endian::big) {
+    val = __builtin_bswap64(val);
+  }
+  return val;
+}
+
+/// Multiplies `a` and `b` and folds the 128-bit product into 64 bits.
+inline auto mulFold(u64 a, u64 b) noexcept -> u64 {
+  __uint128_t prod = __uint128_t(a) * b;
+  return u64(prod) ^ u64(prod >> 64);
+}
+
+/// Reads 4 (little-endian) bytes from `ptr`.
+inline auto read32(const u8* ptr) noexcept -> u32 {
+  u32 val;
+  std::memcpy(&val, ptr, sizeof(val));
+  if constexpr (std::endian::native == std::endian::big) {
+    val = __builtin_bswap32(val);
+  }
+  return val;
+}
+
+inline constexpr u64 PRIME32_1 = 0x9e3779b1;
+inline constexpr u64 PRIME32_2 = 0x85ebca77;
+inline constexpr u64 PRIME32_3 = 0xc2b2ae3d;
+inline constexpr u64 PRIME64_1 = 0x9e3779b185ebca87;
+inline constexpr u64 PRIME64_2 = 0xc2b2ae3d27d4eb4f;
+inline constexpr u64 PRIME64_3 = 0x165667b19e3779f9;
+inline constexpr u64 PRIME64_4 = 0x85ebca77c2b2ae63;
+inline constexpr u64 PRIME64_5 = 0x27d4eb2f165667c5;
+
+/// The size of the key `hash64` mixes into the input.
+inline constexpr usize SECRET_LEN = 192;
+
+/// The size of the chunks long inputs are processed in (8 lanes of 8 bytes).
+inline constexpr usize STRIPE_LEN = 64;
+
+/// The number of stripes between scrambles of the accumulators (each stripe
+/// uses the secret 8 bytes further in).
+inline constexpr usize STRIPES_PER_BLOCK = (SECRET_LEN - STRIPE_LEN) / 8;
+
+/// Inputs longer than this are hashed in stripes.
+inline constexpr usize MID_MAX_LEN = 240;
+
+/// Returns the default secret: pseudorandom bytes from a fixed splitmix64
+/// sequence (so hashes are stable across builds and platforms).
+constexpr auto makeSecret() noexcept -> std::array<u8, SECRET_LEN> {
+  std::array<u8, SECRET_LEN> secret{};
+  u64                        state = 0x6d75206861736821; // "mu hash!"
+  for (usize i = 0; i < SECRET_LEN; i += 8) {
+    state   += 0x9e3779b97f4a7c15;
+    u64 word = state;
+    word     = (word ^ (word >> 30)) * 0xbf58476d1ce4e5b9;
+    word     = (word ^ (word >> 27)) * 0x94d049bb133111eb;
+    word    ^= word >> 31;
+    for (usize b = 0; b < 8; b++) {
+      secret[i + b] = static_cast<u8>(word >> (8 * b));
+    }
+  }
+  return secret;
+}
+
+inline constexpr std::array<u8, SECRET_LEN> DEFAULT_SECRET = makeSecret();
+
+/// Hashes 16 bytes of input against 16 bytes of the secret.
+inline auto mix16(const u8* ptr, const u8* secret, u64 seed) noexcept -> u64 {
+  return mulFold(read64(ptr) ^ (read64(secret) + seed),
+                 read64(ptr + 8) ^ (read64(secret + 8) - seed));
+}
+
+/// A stronger finalizer, for inputs of 4 to 8 bytes (which get no
+/// multiplications otherwise).
+inline auto rrmxmx(u64 val, usize len) noexcept -> u64 {
+  val ^= std::rotl(val, 49) ^ std::rotl(val, 24);
+  val *= 0x9fb21c651e98df25;
+  val ^= (val >> 35) + len;
+  val *= 0x9fb21c651e98df25;
+  return val ^ (val >> 28);
+}
+
+inline auto hashShort(const u8* ptr, usize len, u64 seed) noexcept -> u64 {
+  const u8* secret = DEFAULT_SECRET.data();
+  if (len > 8) {
+    u64 lo = read64(ptr) ^ ((read64(secret + 24) ^ read64(secret + 32)) + seed);
+    u64 hi = read64(ptr + len - 8) ^
+             ((read64(secret + 40) ^ read64(secret + 48)) - seed);
+    return mix64(len + __builtin_bswap64(lo) + hi + mulFold(lo, hi));
+  }
+  if (len >= 4) {
+    seed       ^= u64(__builtin_bswap32(static_cast<u32>(seed))) << 32;
+    u64 input   = read32(ptr + len - 4) + (u64(read32(ptr)) << 32);
+    u64 bitflip = (read64(secret + 8) ^ read64(secret + 16)) - seed;
+    return rrmxmx(input ^ bitflip, len);
+  }
+  if (len > 0) {
+    u32 combined = (u32(ptr[0]) << 16) | (u32(ptr[len >> 1]) << 24) |
+                   u32(ptr[len - 1]) | (u32(len) << 8);
+    u64 bitflip  = (read32(secret) ^ read32(secret + 4)) + seed;
+    return mix64(combined ^ bitflip);
+  }
+  return mix64(seed ^ read64(secret + 56) ^ read64(secret + 64));
+}
+
+inline auto hashMid(const u8* ptr, usize len, u64 seed) noexcept -> u64 {
+  const u8* secret = DEFAULT_SECRET.data();
+  u64       acc    = len * PRIME64_1;
+  if (len <= 128) {
+    // Pairs of 16 bytes from both ends, meeting in the middle
+    if (len > 32) {
+      if (len > 64) {
+        if (len > 96) {
+          acc += mix16(ptr + 48, secret + 96, seed);
+          acc += mix16(ptr + len - 64, secret + 112, seed);
+        }
+        acc += mix16(ptr + 32, secret + 64, seed);
+        acc += mix16(ptr + len - 48, secret + 80, seed);
+      }
+      acc += mix16(ptr + 16, secret + 32, seed);
+      acc += mix16(ptr + len - 32, secret + 48, seed);
+    }
+    acc += mix16(ptr, secret, seed);
+    acc += mix16(ptr + len - 16, secret + 16, seed);
+    return mix64(acc);
+  }
+
+  for (usize i = 0; i < 8; i++) {
+    acc += mix16(ptr + 16 * i, secret + 16 * i, seed);
+  }
+  acc = mix64(acc);
+  for (usize i = 8; i < len / 16; i++) {
+    acc += mix16(ptr + 16 * i, secret + 16 * (i - 8) + 3, seed);
+  }
+  acc += mix16(ptr + len - 16, secret + 119, seed);
+  return mix64(acc);
+}
+
+/// Hashes inputs longer than `MID_MAX_LEN`, in stripes (with the best
+/// kernels the CPU supports).
+auto hashLong(const u8* ptr, usize len, u64 seed) noexcept -> u64;
+
+/// `hash64` with the stripe kernels for `isa` (which must be supported).
+auto hash64(bytes::Isa isa, const void* data, usize len, u64 seed) noexcept
+    -> u64;
+} // namespace internal::hash
+
+/// Hashes the `len` bytes at `data`, with 64 bits of output.
+///
+/// This is an XXH3-style hash (*not* a cryptographic one), for fingerprinting
+/// content and for keys of any length: short inputs are mixed in a few
+/// multiplications, and inputs longer than 240 bytes are hashed in 64-byte
+/// stripes, with vector kernels (SSE2, AVX2 or AVX-512) where available.
+///
+/// ## Note
+/// The output only depends on the bytes and `seed`: it is the same for every
+/// instruction set and platform, and `Hasher` gives the same result for the
+/// bytes in chunks. (It is *not* the same as `XXH3_64bits`, which uses a
+/// different secret.)
+inline auto hash64(const void* data, usize len, u64 seed = 0) noexcept
+    -> u64 {
+  using namespace internal::hash;
+
+  const u8* ptr = static_cast<const u8*>(data);
+  if (len <= 16) {
+    return hashShort(ptr, len, seed);
+  }
+  if (len <= MID_MAX_LEN) {
+    return hashMid(ptr, len, seed);
+  }
+  return hashLong(ptr, len, seed);
+}
+
+/// Hashes the contents of the slice (not its address).
+template <Copyable T>
+auto hash64(Slice<T> items, u64 seed = 0) noexcept -> u64 {
+  return hash64(items.ptr(), sizeof(T) * items.len(), seed);
+}
+
+/// Hashes the bytes of `val`.
+///
+/// ## Note
+/// Padding bytes are hashed too, so `T` should not have any (see
+/// `std::has_unique_object_representations`). Pointers and arrays are
+/// excluded, since `hash64(ptr, len)` would silently pick this overload.
+template <Copyable T>
+  requires(!std::is_pointer_v<T> && !std::is_array_v<T>)
+auto hash64(const T& val, u64 seed = 0) noexcept -> u64 {
+  return hash64(&val, sizeof(T), seed);
+}
+
+/// Computes `hash64` of a sequence of chunks, without keeping them around.
+///
+/// Up to 256 bytes are buffered; past that, whole stripes are hashed as they
+/// arrive.
+class Hasher {
+public:
+  /// Creates a hasher for `hash64(bytes, seed)`.
+  explicit Hasher(u64 seed = 0) noexcept;
+
+  /// Adds the `len` bytes at `data`.
+  auto update(const void* data, usize len) noexcept -> void;
+
+  /// Adds the contents of the slice (not its address).
+  template <Copyable T> auto update(Slice<T> items) noexcept -> void {
+    this->update(items.ptr(), sizeof(T) * items.len());
+  }
+
+  /// Adds the bytes of `val` (including any padding).
+  template <Copyable T>
+    requires(!std::is_pointer_v<T> && !std::is_array_v<T>)
+  auto update(const T& val) noexcept -> void {
+    this->update(&val, sizeof(T));
+  }
+
+  /// Returns the hash of the bytes added so far (more can still be added).
+  auto finish() const noexcept -> u64;
+
+  /// Forgets the bytes added so far.
+  auto reset() noexcept -> void;
+
+private:
+  static constexpr usize BUFFER_LEN = 4 * internal::hash::STRIPE_LEN;
+
+  alignas(64) u64 acc[8];
+  u8    secret[internal::hash::SECRET_LEN];
+  u8    buffer[BUFFER_LEN];
+  usize buffered;
+  usize stripes;
+  u64   total;
+  u64   seed;
+};
+
+/// The default hash function for keys of type `T`.
+///
+/// ## Note
+/// Specialize this to make a type usable as a `HashMap` key.
+template <typename T> struct Hash;
+
+template <typename T>
+  requires(std::integral<T> || std::is_enum_v<T>)
+struct Hash<T> {
+  auto operator()(T val) const noexcept -> u64 {
+    return mix64(static_cast<u64>(val));
+  }
+};
+
+template <typename T> struct Hash<T*> {
+  auto operator()(T* val) const noexcept -> u64 {
+    return mix64(reinterpret_cast<usize>(val));
+  }
+};
+
+/// Hashes the contents of the slice (not its address).
+template <typename T>
+  requires(std::has_unique_object_representations_v<T>)
+struct Hash<Slice<T>> {
+  auto operator()(const Slice<T>& val) const noexcept -> u64 {
+    return hash64(val);
+  }
+};
+
+/// The default equality comparison for keys of type `T`.
+template <typename T> struct Eq {
+  auto operator()(const T& lhs, const T& rhs) const -> bool {
+    return lhs == rhs;
+  }
+};
+
+/// Compares the contents of the slices (not their addresses).
+template <typename T>
+  requires(std::has_unique_object_representations_v<T>)
+struct Eq<Slice<T>> {
+  auto operator()(const Slice<T>& lhs, const Slice<T>& rhs) const -> bool {
+    return (lhs.len() == rhs.len()) &&
+           ((lhs.len() == 0) ||
+            (std::memcmp(lhs.ptr(), rhs.ptr(), sizeof(T) * lhs.len()) == 0));
+  }
+};
+
+} // namespace mu
+
+#endif // !MU_HASH_H
@@ -0,0 +1,609 @@
+#ifndef MU_HASH_MAP_H
+#define MU_HASH_MAP_H
+
+#include "mu/common.h"            // OutOfMemoryException
+#include "mu/hash.h"              // Hash, Eq
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/utils.h"         // relocate
+#include "mu/primitives.h"        // usize, u32, u64, i8
+#include <bit>                    // countr_zero, countl_zero
+#include <cstring>                // memcpy, memset
+#include <new>                    // placement new
+#include <type_traits>            // is_trivially_destructible_v
+#include <utility>                // forward, move
+
+#if defined(__SSE2__) && !defined(MU_HASH_MAP_NO_SIMD)
+#include <immintrin.h> // _mm_*, _mm256_*
+#endif
+
+namespace mu {
+
+namespace internal::swiss {
+/// The control byte of a slot: `EMPTY`, `DELETED`, or the 7 low bits of the
+/// hash of a full slot (so full slots are exactly the non-negative ones).
+using ctrl_t                    = i8;
+
+inline constexpr ctrl_t EMPTY   = -128; // 0b10000000
+inline constexpr ctrl_t DELETED = -2;   // 0b11111110
+
+/// A set of slot positions within a group, as returned by the `match*`
+/// methods of a group.
+///
+/// Each position takes `1 << SHIFT` bits of `mask`, with `WIDTH` positions.
+template <typename T, usize WIDTH, usize SHIFT> class BitMask {
+public:
+  explicit BitMask(T mask) noexcept : mask{mask} {}
+
+  explicit operator bool() const noexcept { return this->mask != 0; }
+
+  /// Returns the lowest position in the set.
+  auto lowest() const noexcept -> usize {
+    return static_cast<usize>(std::countr_zero(this->mask)) >> SHIFT;
+  }
+
+  /// Removes the lowest position from the set.
+  auto clearLowest() noexcept -> void { this->mask &= this->mask - 1; }
+
+  /// Returns the number of positions before the lowest one in the set.
+  auto trailingZeros() const noexcept -> usize { return this->lowest(); }
+
+  /// Returns the number of positions after the highest one in the set.
+  auto leadingZeros() const noexcept -> usize {
+    constexpr usize EXTRA = sizeof(T) * 8 - (WIDTH << SHIFT);
+    return (static_cast<usize>(std::countl_zero(this->mask)) - EXTRA) >> SHIFT;
+  }
+
+private:
+  T mask;
+};
+
+/// A group of 8 control bytes, matched 8 at a time with plain integer
+/// arithmetic (SWAR); this is the fallback if SIMD is unavailable.
+class GroupPortable {
+public:
+  static constexpr usize WIDTH = 8;
+
+  using Mask                   = BitMask<u64, WIDTH, 3>;
+
+  explicit GroupPortable(const ctrl_t* pos) noexcept {
+    std::memcpy(&this->ctrl, pos, sizeof(this->ctrl));
+    if constexpr (std::endian::native == std::endian::big) {
+      this->ctrl = __builtin_bswap64(this->ctrl);
+    }
+  }
+
+  /// Returns the positions whose control byte is `hash`.
+  ///
+  /// ## Note
+  /// This may return false positives (right after a true positive), which is
+  /// fine since the keys are compared anyway.
+  auto match(ctrl_t hash) const noexcept -> Mask {
+    u64 x = this->ctrl ^ (LSBS * static_cast<u8>(hash));
+    return Mask((x - LSBS) & ~x & MSBS);
+  }
+
+  /// Returns the positions that are `EMPTY`.
+  auto matchEmpty() const noexcept -> Mask {
+    return Mask(this->ctrl & (~this->ctrl << 6) & MSBS);
+  }
+
+  /// Returns the positions that are `EMPTY` or `DELETED`.
+  auto matchEmptyOrDeleted() const noexcept -> Mask {
+    return Mask(this->ctrl & MSBS);
+  }
+
+  /// Returns the positions that are full.
+  auto matchFull() const noexcept -> Mask { return Mask(~this->ctrl & MSBS); }
+
+private:
+  static constexpr u64 LSBS = 0x0101010101010101;
+  static constexpr u64 MSBS = 0x8080808080808080;
+
+  u64                  ctrl;
+};
+
+#if defined(__SSE2__) && !defined(MU_HASH_MAP_NO_SIMD)
+/// A group of 16 control bytes, matched with SSE2.
+class GroupSse2 {
+public:
+  static constexpr usize WIDTH = 16;
+
+  using Mask                   = BitMask<u32, WIDTH, 0>;
+
+  explicit GroupSse2(const ctrl_t* pos) noexcept
+      : ctrl{_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos))} {}
+
+  /// Returns the positions whose control byte is `hash`.
+  auto match(ctrl_t hash) const noexcept -> Mask {
+    return this->maskOf(_mm_cmpeq_epi8(_mm_set1_epi8(hash), this->ctrl));
+  }
+
+  /// Returns the positions that are `EMPTY`.
+  auto matchEmpty() const noexcept -> Mask { return this->match(EMPTY); }
+
+  /// Returns the positions that are `EMPTY` or `DELETED`.
+  auto matchEmptyOrDeleted() const noexcept -> Mask {
+    return this->maskOf(this->ctrl);
+  }
+
+  /// Returns the positions that are full.
+  auto matchFull() const noexcept -> Mask {
+    return Mask(static_cast<u32>(~_mm_movemask_epi8(this->ctrl)) & 0xffff);
+  }
+
+private:
+  /// Collects the sign bits of `bytes`.
+  static auto maskOf(__m128i bytes) noexcept -> Mask {
+    return Mask(static_cast<u32>(_mm_movemask_epi8(bytes)));
+  }
+
+  __m128i ctrl;
+};
+#endif
+
+#if defined(__AVX2__) && !defined(MU_HASH_MAP_NO_SIMD)
+/// A group of 32 control bytes, matched with AVX2.
+class GroupAvx2 {
+public:
+  static constexpr usize WIDTH = 32;
+
+  using Mask                   = BitMask<u32, WIDTH, 0>;
+
+  explicit GroupAvx2(const ctrl_t* pos) noexcept
+      : ctrl{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos))} {}
+
+  /// Returns the positions whose control byte is `hash`.
+  auto match(ctrl_t hash) const noexcept -> Mask {
+    return this->maskOf(_mm256_cmpeq_epi8(_mm256_set1_epi8(hash), this->ctrl));
+  }
+
+  /// Returns the positions that are `EMPTY`.
+  auto matchEmpty() const noexcept -> Mask { return this->match(EMPTY); }
+
+  /// Returns the positions that are `EMPTY` or `DELETED`.
+  auto matchEmptyOrDeleted() const noexcept -> Mask {
+    return this->maskOf(this->ctrl);
+  }
+
+  /// Returns the positions that are full.
+  auto matchFull() const noexcept -> Mask {
+    return Mask(~static_cast<u32>(_mm256_movemask_epi8(this->ctrl)));
+  }
+
+private:
+  /// Collects the sign bits of `bytes`.
+  static auto maskOf(__m256i bytes) noexcept -> Mask {
+    return Mask(static_cast<u32>(_mm256_movemask_epi8(bytes)));
+  }
+
+  __m256i ctrl;
+};
+
+using Group = GroupAvx2;
+#elif defined(__SSE2__) && !defined(MU_HASH_MAP_NO_SIMD)
+using Group = GroupSse2;
+#else
+using Group = GroupPortable;
+#endif
+} // namespace internal::swiss
+
+/// An unordered map from keys of type `K` to values of type `V`.
+///
+/// This is an open-addressing ("Swiss") table: besides the entries, it keeps
+/// one control byte per slot, holding 7 bits of the hash of its key. Lookups
+/// compare a whole group of control bytes at a time (with SSE2/AVX2 if it is
+/// enabled at compile time, and with integer arithmetic otherwise), and only
+/// compare the keys of slots whose control byte matches.
+///
+/// ## Note
+/// Entries are stored inline, so inserting may move them and invalidates
+/// pointers into the map.
+///
+/// Define `MU_HASH_MAP_NO_SIMD` to use the portable implementation.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename K, typename V, class Allocator = mem::CAllocator,
+          class Hasher = Hash<K>, class KeyEq = Eq<K>>
+class HashMap {
+  using ctrl_t = internal::swiss::ctrl_t;
+  using Group  = internal::swiss::Group;
+
+public:
+  /// A key and its value.
+  struct Entry {
+    K key;
+    V val;
+  };
+
+  /// Iterates over the entries of a `HashMap`, in no particular order.
+  ///
+  /// ## Note
+  /// The keys must not be modified.
+  template <typename E> class Iterator {
+  public:
+    auto operator*() const noexcept -> E& { return this->entries[this->idx]; }
+    auto operator->() const noexcept -> E* { return this->entries + this->idx; }
+
+    auto operator++() noexcept -> Iterator& {
+      this->idx++;
+      this->skipEmpty();
+      return *this;
+    }
+
+    auto operator==(const Iterator& other) const noexcept -> bool {
+      return this->idx == other.idx;
+    }
+
+  private:
+    friend class HashMap;
+
+    explicit Iterator(const ctrl_t* ctrl, E* entries, usize idx,
+                      usize cap) noexcept
+        : ctrl{ctrl}, entries{entries}, idx{idx}, cap{cap} {
+      this->skipEmpty();
+    }
+
+    auto skipEmpty() noexcept -> void {
+      while ((this->idx < this->cap) && (this->ctrl[this->idx] < 0)) {
+        this->idx++;
+      }
+    }
+
+    const ctrl_t* ctrl;
+    E*            entries;
+    usize         idx;
+    usize         cap;
+  };
+
+  HashMap(const HashMap&)                    = delete;
+  auto operator=(const HashMap&) -> HashMap& = delete;
+
+  /// Creates an empty map that allocates using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit HashMap(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator} {}
+
+  /// Creates a map by transferring the entries from `other`, which is left
+  /// empty.
+  HashMap(HashMap&& other) noexcept
+      : allocator{other.allocator}, ctrl{other.ctrl}, entries{other.entries},
+        cap{other.cap}, len_{other.len_}, growth_left{other.growth_left} {
+    other.forget();
+  }
+
+  /// Move assignment operator.
+  auto operator=(HashMap&& other) noexcept -> HashMap& {
+    if (this != &other) {
+      this->release();
+      this->allocator   = other.allocator;
+      this->ctrl        = other.ctrl;
+      this->entries     = other.entries;
+      this->cap         = other.cap;
+      this->len_        = other.len_;
+      this->growth_left = other.growth_left;
+      other.forget();
+    }
+    return *this;
+  }
+
+  ~HashMap() noexcept { this->release(); }
+
+  /// Returns a pointer to the value of `key`, or `nullptr` if there is none.
+  auto get(const K& key) noexcept -> V* {
+    return this->getHashed(key, Hasher{}(key));
+  }
+
+  /// Returns a pointer to the value of `key`, or `nullptr` if there is none.
+  auto get(const K& key) const noexcept -> const V* {
+    usize idx = this->find(key, Hasher{}(key));
+    return (idx == NOT_FOUND) ? nullptr : &this->entries[idx].val;
+  }
+
+  /// Same as `get`, with the hash of `key` computed by the caller.
+  ///
+  /// ## Note
+  /// `hash` must be `Hasher{}(key)`; this lets wrappers that already hashed
+  /// the key (e.g. to pick a shard) avoid hashing it twice.
+  auto getHashed(const K& key, u64 hash) noexcept -> V* {
+    usize idx = this->find(key, hash);
+    return (idx == NOT_FOUND) ? nullptr : &this->entries[idx].val;
+  }
+
+  /// Returns `true` if the map contains `key`.
+  auto contains(const K& key) const noexcept -> bool {
+    return this->find(key, Hasher{}(key)) != NOT_FOUND;
+  }
+
+  /// Maps `key` to `val`, replacing its previous value if it has one.
+  ///
+  /// Returns `true` if `key` was not in the map.
+  auto put(K key, V val) -> bool {
+    u64 hash = Hasher{}(key);
+    return this->putHashed(std::move(key), std::move(val), hash);
+  }
+
+  /// Same as `put`, with the hash of `key` computed by the caller (see
+  /// `getHashed`).
+  auto putHashed(K key, V val, u64 hash) -> bool {
+    usize idx = this->find(key, hash);
+    if (idx != NOT_FOUND) {
+      this->entries[idx].val = std::move(val);
+      return false;
+    }
+
+    idx = this->prepareInsert(hash);
+    new (this->entries + idx) Entry{std::move(key), std::move(val)};
+    this->setCtrl(idx, h2(hash));
+    this->len_++;
+    return true;
+  }
+
+  /// Returns the value of `key`, inserting a value constructed from `args` if
+  /// `key` is not in the map.
+  template <typename... Args>
+  auto getOrPut(const K& key, Args&&... args) -> V& {
+    u64   hash = Hasher{}(key);
+    usize idx  = this->find(key, hash);
+    if (idx != NOT_FOUND) {
+      return this->entries[idx].val;
+    }
+
+    idx = this->prepareInsert(hash);
+    new (this->entries + idx) Entry{key, V(std::forward<Args>(args)...)};
+    this->setCtrl(idx, h2(hash));
+    this->len_++;
+    return this->entries[idx].val;
+  }
+
+  /// Removes `key` from the map.
+  ///
+  /// Returns `false` if `key` was not in the map.
+  auto remove(const K& key) noexcept -> bool {
+    return this->removeHashed(key, Hasher{}(key));
+  }
+
+  /// Same as `remove`, with the hash of `key` computed by the caller (see
+  /// `getHashed`).
+  auto removeHashed(const K& key, u64 hash) noexcept -> bool {
+    usize idx = this->find(key, hash);
+    if (idx == NOT_FOUND) {
+      return false;
+    }
+
+    this->entries[idx].~Entry();
+    this->len_--;
+
+    // If the slot is surrounded by empty slots within a group's width, no
+    // probe has ever passed over it while it was full, so it can be marked
+    // `EMPTY` instead of leaving a tombstone
+    usize before       = (idx - WIDTH) & (this->cap - 1);
+    auto  empty_before = Group(this->ctrl + before).matchEmpty();
+    auto  empty_after  = Group(this->ctrl + idx).matchEmpty();
+    bool  never_full   = empty_before && empty_after &&
+                      (empty_after.trailingZeros() +
+                       empty_before.leadingZeros()) < WIDTH;
+    this->setCtrl(idx, never_full ? internal::swiss::EMPTY
+                                  : internal::swiss::DELETED);
+    this->growth_left += never_full;
+    return true;
+  }
+
+  /// Returns the number of entries in the map.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Returns the number of slots in the map.
+  auto capacity() const noexcept -> usize { return this->cap; }
+
+  /// Makes sure the map can hold `len` entries without reallocating.
+  auto reserve(usize len) -> void {
+    if ((len > this->len_ + this->growth_left) ||
+        ((this->cap == 0) && (len != 0))) {
+      this->rehash(capacityFor(len));
+    }
+  }
+
+  /// Removes all entries from the map (keeping its memory).
+  auto clear() noexcept -> void {
+    if (this->cap == 0) {
+      return;
+    }
+    this->destroyEntries();
+    std::memset(this->ctrl, internal::swiss::EMPTY, this->cap + WIDTH);
+    this->len_        = 0;
+    this->growth_left = maxLoad(this->cap);
+  }
+
+  auto begin() noexcept -> Iterator<Entry> {
+    return Iterator<Entry>(this->ctrl, this->entries, 0, this->cap);
+  }
+  auto end() noexcept -> Iterator<Entry> {
+    return Iterator<Entry>(this->ctrl, this->entries, this->cap, this->cap);
+  }
+  auto begin() const noexcept -> Iterator<const Entry> {
+    return Iterator<const Entry>(this->ctrl, this->entries, 0, this->cap);
+  }
+  auto end() const noexcept -> Iterator<const Entry> {
+    return Iterator<const Entry>(this->ctrl, this->entries, this->cap,
+                                 this->cap);
+  }
+
+private:
+  static constexpr usize WIDTH     = Group::WIDTH;
+  static constexpr usize NOT_FOUND = ~usize(0);
+
+  /// Returns the part of `hash` used to pick the first group to probe.
+  static auto h1(u64 hash) noexcept -> usize { return hash >> 7; }
+
+  /// Returns the part of `hash` stored in the control bytes.
+  static auto h2(u64 hash) noexcept -> ctrl_t {
+    return static_cast<ctrl_t>(hash & 0x7f);
+  }
+
+  /// Returns the number of entries a table with `cap` slots can hold (7/8 of
+  /// the slots).
+  static auto maxLoad(usize cap) noexcept -> usize { return cap - cap / 8; }
+
+  /// Returns the number of slots needed to hold `len` entries.
+  static auto capacityFor(usize len) noexcept -> usize {
+    usize cap = WIDTH;
+    while (maxLoad(cap) < len) {
+      cap *= 2;
+    }
+    return cap;
+  }
+
+  /// Returns the offset of the entries in the table's allocation.
+  static auto entriesOffset(usize cap) noexcept -> usize {
+    return (cap + WIDTH + alignof(Entry) - 1) & ~(alignof(Entry) - 1);
+  }
+
+  /// Returns the size of the table's allocation.
+  static auto allocSize(usize cap) noexcept -> usize {
+    return entriesOffset(cap) + sizeof(Entry) * cap;
+  }
+
+  /// Returns the index of the slot that holds `key`, or `NOT_FOUND`.
+  ///
+  /// The groups are probed with quadratic (triangular) steps, which visits
+  /// every group since the capacity is a power of 2.
+  auto find(const K& key, u64 hash) const noexcept -> usize {
+    if (this->len_ == 0) {
+      return NOT_FOUND;
+    }
+    usize  mask = this->cap - 1;
+    usize  pos  = h1(hash) & mask;
+    ctrl_t tag  = h2(hash);
+    for (usize step = WIDTH;; step += WIDTH) {
+      Group group{this->ctrl + pos};
+      for (auto match = group.match(tag); match; match.clearLowest()) {
+        usize idx = (pos + match.lowest()) & mask;
+        if (KeyEq{}(this->entries[idx].key, key)) {
+          return idx;
+        }
+      }
+      if (group.matchEmpty()) {
+        return NOT_FOUND;
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  /// Returns the first slot for `hash` that isn't full.
+  auto findFree(u64 hash) const noexcept -> usize {
+    usize mask = this->cap - 1;
+    usize pos  = h1(hash) & mask;
+    for (usize step = WIDTH;; step += WIDTH) {
+      auto free = Group(this->ctrl + pos).matchEmptyOrDeleted();
+      if (free) {
+        return (pos + free.lowest()) & mask;
+      }
+      pos = (pos + step) & mask;
+    }
+  }
+
+  /// Returns the slot to insert a new entry with `hash` into, growing the
+  /// table if needed.
+  auto prepareInsert(u64 hash) -> usize {
+    if (this->cap == 0) {
+      this->rehash(WIDTH);
+    }
+    usize idx = this->findFree(hash);
+    if ((this->growth_left == 0) &&
+        (this->ctrl[idx] == internal::swiss::EMPTY)) {
+      // Only grow if the table is actually full, rather than full of
+      // tombstones
+      usize cap = (this->len_ < maxLoad(this->cap) / 2) ? this->cap
+                                                        : this->cap * 2;
+      this->rehash(cap);
+      idx = this->findFree(hash);
+    }
+    this->growth_left -= (this->ctrl[idx] == internal::swiss::EMPTY);
+    return idx;
+  }
+
+  /// Sets the control byte of slot `idx`, and its mirror after the last slot
+  /// (which lets groups be loaded past the end without wrapping around).
+  auto setCtrl(usize idx, ctrl_t val) noexcept -> void {
+    this->ctrl[idx] = val;
+    if (idx < WIDTH) {
+      this->ctrl[this->cap + idx] = val;
+    }
+  }
+
+  /// Moves the entries into a new table with `cap` slots, dropping all
+  /// tombstones.
+  auto rehash(usize cap) -> void {
+    auto&&  allocator = this->allocator.get();
+    usize   size      = allocSize(cap);
+    void*   mem       = allocator.rawAlloc(size, alignof(Entry));
+    if (mem == nullptr) {
+      throw common::OutOfMemoryException(size);
+    }
+
+    ctrl_t* old_ctrl    = this->ctrl;
+    Entry*  old_entries = this->entries;
+    usize   old_cap     = this->cap;
+    this->ctrl          = static_cast<ctrl_t*>(mem);
+    this->entries       = reinterpret_cast<Entry*>(static_cast<u8*>(mem) +
+                                                   entriesOffset(cap));
+    this->cap           = cap;
+    this->growth_left   = maxLoad(cap) - this->len_;
+    std::memset(this->ctrl, internal::swiss::EMPTY, cap + WIDTH);
+
+    for (usize i = 0; i < old_cap; i++) {
+      if (old_ctrl[i] >= 0) {
+        u64   hash = Hasher{}(old_entries[i].key);
+        usize idx  = this->findFree(hash);
+        mem::relocate(this->entries + idx, old_entries + i, 1);
+        this->setCtrl(idx, h2(hash));
+      }
+    }
+    if (old_cap != 0) {
+      allocator.rawFree(old_ctrl, allocSize(old_cap), alignof(Entry));
+    }
+  }
+
+  auto destroyEntries() noexcept -> void {
+    if constexpr (!std::is_trivially_destructible_v<Entry>) {
+      for (usize i = 0; i < this->cap; i++) {
+        if (this->ctrl[i] >= 0) {
+          this->entries[i].~Entry();
+        }
+      }
+    }
+  }
+
+  /// Destroys the entries and frees the table.
+  auto release() noexcept -> void {
+    if (this->cap != 0) {
+      this->destroyEntries();
+      this->allocator.get().rawFree(this->ctrl, allocSize(this->cap),
+                                    alignof(Entry));
+    }
+    this->forget();
+  }
+
+  /// Leaves the map empty without freeing anything.
+  auto forget() noexcept -> void {
+    this->ctrl        = nullptr;
+    this->entries     = nullptr;
+    this->cap         = 0;
+    this->len_        = 0;
+    this->growth_left = 0;
+  }
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  ctrl_t*                                            ctrl        = nullptr;
+  Entry*                                             entries     = nullptr;
+  usize                                              cap         = 0;
+  usize                                              len_        = 0;
+  usize                                              growth_left = 0;
+};
+
+} // namespace mu
+
+#endif // !MU_HASH_MAP_H
@@ -0,0 +1,88 @@
+#ifndef MU_CHECKSUM_WRITER_H
+#define MU_CHECKSUM_WRITER_H
+
+#include "mu/crc32c.h"      // crc32c
+#include "mu/io/writer.h"   // Writer, Writeable
+#include "mu/mem/scratch.h" // TempScope
+#include "mu/primitives.h"  // u8, u32, u64, usize, cstr, const_cstr
+#include "mu/slice.h"       // Slice
+#include <cstdarg>          // va_list, va_copy, va_end
+#include <cstdio>           // vsnprintf
+#include <utility>          // forward
+
+namespace mu::io {
+
+/// A `Writer` that keeps the CRC32C of everything written through it.
+///
+/// The checksum is updated as the bytes pass through `write`, while they are
+/// still in cache, so there is no second pass over the data. Only the bytes
+/// the inner writer accepted are checksummed, so after a short write the
+/// checksum still matches what actually reached it.
+///
+/// ## Note
+/// `T` can be a reference (`ChecksumWriter<File&>`) to checksum a writer
+/// without taking ownership of it.
+template <Writeable T> class ChecksumWriter : public Writer {
+public:
+  ~ChecksumWriter() = default;
+
+  /// Wraps `writer`, continuing from `crc` (the checksum of the bytes already
+  /// written, or 0 for none).
+  explicit ChecksumWriter(T&& writer, u32 crc = 0)
+      : writer{std::forward<T>(writer)}, crc{crc} {}
+
+  auto write(Slice<u8> buf) -> usize override {
+    usize written  = this->writer.write(buf);
+    this->crc      = crc32c(buf.ptr(), written, this->crc);
+    this->written += written;
+    return written;
+  }
+
+  /// Formats the string into a buffer, then writes it through `write` (so
+  /// it's checksummed like any other bytes).
+  auto formatV(const_cstr fmt, va_list args) -> void override {
+    char    small[256];
+    va_list copy;
+    va_copy(copy, args);
+    int len = std::vsnprintf(small, sizeof(small), fmt, copy);
+    va_end(copy);
+    if (len < 0) {
+      return;
+    }
+    usize size = static_cast<usize>(len);
+    if (size < sizeof(small)) {
+      this->writeAll(Slice<u8>(small, size));
+      return;
+    }
+
+    mem::TempScope scope{};
+    cstr           large =
+        scope.arenaAllocator().allocUninit<char>(size + 1).ptr();
+    std::vsnprintf(large, size + 1, fmt, args);
+    this->writeAll(Slice<u8>(large, size));
+  }
+
+  /// Returns the CRC32C of the bytes written so far.
+  auto checksum() const noexcept -> u32 { return this->crc; }
+
+  /// Returns how many bytes were written so far.
+  auto bytesWritten() const noexcept -> u64 { return this->written; }
+
+  /// Starts a new checksum (e.g. for the next record), from `crc`.
+  auto reset(u32 crc = 0) noexcept -> void {
+    this->crc     = crc;
+    this->written = 0;
+  }
+
+  /// Returns the wrapped writer.
+  auto inner() noexcept -> T& { return this->writer; }
+
+private:
+  T   writer;
+  u32 crc     = 0;
+  u64 written = 0;
+};
+
+} // namespace mu::io
+
+#endif // !MU_CHECKSUM_WRITER_H
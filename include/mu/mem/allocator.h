@@ -4,9 +4,9 @@
 #include "mu/common.h"     // OutOfMemoryException
 #include "mu/primitives.h" // usize, u8
 #include "mu/slice.h"      // Slice
-
-// TODO: Add thread safe allocator:
-//  https://github.com/ziglang/zig/blob/master/lib/std/heap/ThreadSafeAllocator.zig
+#include <cassert>         // assert
+#include <concepts>        // derived_from, default_initializable, same_as
+#include <cstring>         // memcpy, memset
 
 namespace mu::mem {
 
@@ -15,13 +15,50 @@ public:
   Allocator()          = default;
   virtual ~Allocator() = default;
 
-  /// Allocates `byte_size` bytes of memory aligned to `align`.
-  auto                       rawAlloc(usize byte_size, u8 align) -> void*;
+  /// Allocates `byte_size` bytes of uninitialized memory aligned to `align`.
+  ///
+  /// ## Note
+  /// This is defined inline so that calls on an allocator of a known type can
+  /// be devirtualized (see `StaticAllocator`).
+  auto                       rawAlloc(usize byte_size, usize align) -> void*;
 
-  /// Frees the memory allocated for `ptr`.
-  auto                       rawFree(void* ptr, u8 align) noexcept -> void;
+  /// Allocates `byte_size` bytes of zeroed memory aligned to `align`.
+  auto rawAllocZeroed(usize byte_size, usize align) -> void*;
 
-  /// Allocates and returns memory for a single item of type `T`.
+  /// Frees the `byte_size` bytes allocated for `ptr` with alignment `align`.
+  ///
+  /// ## Note
+  /// `byte_size` and `align` must be the values the memory was allocated (or
+  /// last resized) with.
+  auto rawFree(void* ptr, usize byte_size, usize align) noexcept -> void;
+
+  /// Attempts to resize the memory allocated for `ptr` from `old_size` to
+  /// `new_size` bytes without moving it.
+  ///
+  /// Returns `false` (and leaves the allocation untouched) if the allocation
+  /// can't be resized in place.
+  auto rawResize(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool;
+
+  /// Resizes the memory allocated for `ptr` from `old_size` to `new_size`
+  /// bytes in place, or moves it if the allocator can do so more cheaply than
+  /// allocating, copying and freeing.
+  ///
+  /// Returns the (possibly new) pointer to the allocation, or `nullptr` (and
+  /// leaves the allocation untouched) if neither is possible.
+  auto rawRemap(void* ptr, usize old_size, usize new_size,
+                usize align) -> void*;
+
+  /// Resizes the memory allocated for `ptr` from `old_size` to `new_size`
+  /// bytes, moving it if it can't be resized in place.
+  ///
+  /// Returns the (possibly new) pointer to the allocation, or `nullptr` (and
+  /// leaves the allocation untouched) if there was not enough memory.
+  auto rawRealloc(void* ptr, usize old_size, usize new_size,
+                  usize align) -> void*;
+
+  /// Allocates and returns (uninitialized) memory for a single item of type
+  /// `T`.
   ///
   /// ## Note
   /// Use `destroy` (*not* `free`) to free the memory allocated by `create`.
@@ -34,27 +71,92 @@ public:
   /// allocated memory).
   ///
   /// ## Note
+  /// The memory is uninitialized (this is the same as `allocUninit`).
+  ///
   /// Use `free` (*not* `destroy`) to free the memory allocated by `alloc`.
   template <typename T> auto alloc(usize len) -> Slice<T> {
     return allocCustom<T>(len);
   }
 
+  /// Allocates uninitialized memory for `len` items of type `T`, aligned to
+  /// `align`.
+  ///
+  /// Use this for buffers that are overwritten right away.
+  template <typename T>
+  auto allocUninit(usize len, usize align = alignof(T)) -> Slice<T> {
+    return allocCustom<T>(len, align);
+  }
+
+  /// Allocates zeroed memory for `len` items of type `T`, aligned to `align`.
+  ///
+  /// ## Note
+  /// This is cheaper than `allocUninit` followed by a `memset` for backends
+  /// that get already-zeroed memory from the OS (e.g. `calloc` or `mmap`).
+  template <typename T>
+  auto allocZeroed(usize len, usize align = alignof(T)) -> Slice<T> {
+    return allocCustom<T>(len, align, true);
+  }
+
   /// Allocates memory for `len` items of type `T` (returns a slice into the
   /// allocated memory), aligned to `align`.
   ///
   /// ## Note
+  /// The memory is uninitialized.
+  ///
   /// Use `free` (*not* `destroy`) to free the memory allocated by
   /// `allocAligned`.
-  template <typename T> auto allocAligned(usize len, u8 align) -> Slice<T> {
+  template <typename T>
+  auto allocAligned(usize len, usize align) -> Slice<T> {
     return allocCustom<T>(len, align);
   }
 
+  /// Attempts to resize `slice` to `new_len` items without moving it.
+  ///
+  /// Returns `true` and updates `slice` on success; otherwise `slice` is left
+  /// untouched.
+  template <typename T>
+  auto resize(Slice<T>& slice, usize new_len) noexcept -> bool {
+    if ((sizeof(T) == 0) || (slice.len() == 0) || (new_len == 0)) {
+      return slice.len() == new_len;
+    }
+    if (!this->rawResize(slice.ptr(), sizeof(T) * slice.len(),
+                         sizeof(T) * new_len, slice.align())) {
+      return false;
+    }
+    slice = Slice(slice.ptr(), new_len, slice.align());
+    return true;
+  }
+
+  /// Resizes `slice` to `new_len` items, growing or shrinking in place when
+  /// possible and moving the items otherwise.
+  ///
+  /// ## Note
+  /// The items are moved bitwise; `slice` must not be used after this call.
+  template <typename T>
+  auto realloc(Slice<T> slice, usize new_len) -> Slice<T> {
+    if ((sizeof(T) == 0) || (slice.len() == 0)) {
+      return allocCustom<T>(new_len, slice.align());
+    }
+    if (new_len == 0) {
+      this->free(slice);
+      return allocCustom<T>(0, slice.align());
+    }
+
+    T* ptr = reinterpret_cast<T*>(
+        this->rawRealloc(slice.ptr(), sizeof(T) * slice.len(),
+                         sizeof(T) * new_len, slice.align()));
+    if (ptr == nullptr) {
+      throw common::OutOfMemoryException(sizeof(T) * new_len);
+    }
+    return Slice(ptr, new_len, slice.align());
+  }
+
   /// Frees the memory allocated for `ptr`.
   template <typename T> auto destroy(T* ptr) noexcept -> void {
     if (sizeof(T) == 0) {
       return;
     }
-    this->rawFree(ptr, alignof(T));
+    this->rawFree(ptr, sizeof(T), alignof(T));
   }
 
   /// Frees the memory allocated for the `slice`.
@@ -62,22 +164,112 @@ public:
     if ((sizeof(T) == 0) || (slice.len() == 0)) {
       return;
     }
-    this->rawFree(slice.ptr(), slice.align());
+    this->rawFree(slice.ptr(), sizeof(T) * slice.len(), slice.align());
   }
 
 private:
-  virtual auto alloc_fn(usize byte_size) -> void* = 0;
-  virtual auto free_fn(void* ptr) -> void         = 0;
+  /// Largest alignment whose offset is stored in a single byte; larger
+  /// alignments store a `usize` offset.
+  static constexpr usize MAX_BYTE_HEADER_ALIGN = 128;
+
+  /// Allocates `byte_size` uninitialized bytes aligned to `align` (which is
+  /// never larger than `native_align_fn()`).
+  virtual auto alloc_fn(usize byte_size, usize align) -> void* = 0;
+
+  /// Frees memory returned by `alloc_fn(byte_size, align)`.
+  ///
+  /// Since the size is always known, backends don't need to store any
+  /// per-allocation metadata to free a block.
+  virtual auto free_fn(void* ptr, usize byte_size, usize align) -> void = 0;
+
+  /// Same as `alloc_fn`, but the memory must be zeroed.
+  ///
+  /// Backends that know their memory is already zeroed should override this to
+  /// skip the `memset`.
+  virtual auto alloc_zeroed_fn(usize byte_size, usize align) -> void* {
+    void* ptr = this->alloc_fn(byte_size, align);
+    return ptr == nullptr ? nullptr : std::memset(ptr, 0, byte_size);
+  }
+
+  /// Returns the largest alignment that `alloc_fn` can provide natively.
+  ///
+  /// Allocations that need at most this alignment are passed straight through
+  /// to `alloc_fn`/`free_fn`; stricter alignments over-allocate and store the
+  /// alignment offset right before the returned pointer.
+  virtual auto native_align_fn() const noexcept -> usize { return 1; }
+
+  /// Attempts to resize the memory returned by `alloc_fn` in place.
+  virtual auto resize_fn(void* /*ptr*/, usize /*old_size*/, usize /*new_size*/,
+                         usize /*align*/) -> bool {
+    return false;
+  }
+
+  /// Attempts to move the memory returned by `alloc_fn` into a block of
+  /// `new_size` bytes more cheaply than allocating, copying and freeing.
+  ///
+  /// Returns `nullptr` if the allocator has no better way to do so.
+  virtual auto remap_fn(void* /*ptr*/, usize /*old_size*/, usize /*new_size*/,
+                        usize /*align*/) -> void* {
+    return nullptr;
+  }
+
+  /// Returns the number of extra bytes needed to align an allocation to
+  /// `align` and store its alignment offset.
+  static constexpr auto headerSize(usize align) noexcept -> usize {
+    return align <= MAX_BYTE_HEADER_ALIGN ? align : align + sizeof(usize) - 1;
+  }
+
+  /// Returns the first address after `ptr` that is aligned to `align` and
+  /// leaves room for the alignment offset.
+  static auto alignAfterHeader(void* ptr, usize align) noexcept -> u8* {
+    usize header = align <= MAX_BYTE_HEADER_ALIGN ? 1 : sizeof(usize);
+    usize addr   = reinterpret_cast<usize>(ptr);
+    return reinterpret_cast<u8*>((addr + header + align - 1) & ~(align - 1));
+  }
+
+  /// Aligns the block at `ptr` to `align`, storing the alignment offset right
+  /// before the returned pointer.
+  static auto writeHeader(void* ptr, usize align) noexcept -> u8* {
+    u8*   res    = alignAfterHeader(ptr, align);
+    usize offset = static_cast<usize>(res - reinterpret_cast<u8*>(ptr));
+    if (align <= MAX_BYTE_HEADER_ALIGN) {
+      *(res - 1) = static_cast<u8>(offset);
+    } else {
+      std::memcpy(res - sizeof(usize), &offset, sizeof(usize));
+    }
+    return res;
+  }
+
+  /// Frees an allocation that was aligned with `writeHeader`.
+  ///
+  /// ## Note
+  /// This is kept out of line, since it is the slow path of `rawFree`.
+  auto freeWithHeader(void* ptr, usize byte_size, usize align) noexcept
+      -> void;
+
+  /// Returns the alignment offset stored by `writeHeader`.
+  static auto readHeader(void* aligned, usize align) noexcept -> usize {
+    u8* res = reinterpret_cast<u8*>(aligned);
+    if (align <= MAX_BYTE_HEADER_ALIGN) {
+      return *(res - 1);
+    }
+    usize offset;
+    std::memcpy(&offset, res - sizeof(usize), sizeof(usize));
+    return offset;
+  }
 
   template <typename T>
-  constexpr auto allocCustom(usize len, u8 align = alignof(T)) -> Slice<T> {
+  constexpr auto allocCustom(usize len, usize align = alignof(T),
+                             bool zeroed = false) -> Slice<T> {
     if ((sizeof(T) == 0) || (len == 0)) {
       return Slice(reinterpret_cast<T*>(reinterpret_cast<intptr_t*>(
                        reinterpret_cast<intptr_t>(INTMAX_MAX))),
                    len, align);
     }
 
-    T* ptr = reinterpret_cast<T*>(this->rawAlloc(sizeof(T) * len, align));
+    T* ptr = reinterpret_cast<T*>(
+        zeroed ? this->rawAllocZeroed(sizeof(T) * len, align)
+               : this->rawAlloc(sizeof(T) * len, align));
     if (ptr == nullptr) {
       throw common::OutOfMemoryException(sizeof(T) * len);
     }
@@ -85,6 +277,75 @@ private:
   }
 };
 
+/// Checks if `val` is a power of 2.
+constexpr auto isPowerOf2(usize val) noexcept -> bool {
+  return (val != 0) && ((val & (val - 1)) == 0);
+}
+
+// NOTE: Impl from:
+// https://johanmabille.github.io/blog/2014/12/06/aligned-memory-allocator/
+inline auto Allocator::rawAlloc(usize byte_size, usize align) -> void* {
+  assert(isPowerOf2(align));
+  if (align <= this->native_align_fn()) {
+    return this->alloc_fn(byte_size, align);
+  }
+
+  void* ptr = this->alloc_fn(byte_size + headerSize(align), 1);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  return writeHeader(ptr, align);
+}
+
+inline auto Allocator::rawAllocZeroed(usize byte_size, usize align) -> void* {
+  assert(isPowerOf2(align));
+  if (align <= this->native_align_fn()) {
+    return this->alloc_zeroed_fn(byte_size, align);
+  }
+
+  void* ptr = this->alloc_zeroed_fn(byte_size + headerSize(align), 1);
+  if (ptr == nullptr) {
+    return nullptr;
+  }
+  return writeHeader(ptr, align);
+}
+
+inline auto Allocator::rawFree(void* ptr, usize byte_size,
+                               usize align) noexcept -> void {
+  if (ptr == nullptr) {
+    return;
+  }
+  if (align <= this->native_align_fn()) {
+    this->free_fn(ptr, byte_size, align);
+    return;
+  }
+  this->freeWithHeader(ptr, byte_size, align);
+}
+
+/// An allocator that doesn't have to be passed around: any default-constructed
+/// instance can free memory allocated by any other instance, because the
+/// allocator is either stateless or refers to shared state.
+///
+/// Containers don't store a pointer to static allocators, and their calls are
+/// dispatched statically (and can be inlined) instead of going through the
+/// virtual `mem::Allocator` interface.
+///
+/// ## Note
+/// Allocators opt in by declaring `static constexpr bool IS_STATIC = true`.
+template <class A>
+concept StaticAllocator =
+    std::derived_from<A, Allocator> && std::default_initializable<A> &&
+    requires { requires A::IS_STATIC; };
+
+/// An allocator that can tell whether a pointer was allocated by it.
+///
+/// This is what lets a `FallbackAllocator` route frees to the right allocator.
+template <class A>
+concept OwningAllocator =
+    std::derived_from<A, Allocator> && requires(const A& self, void* ptr) {
+      { self.owns(ptr) } -> std::same_as<bool>;
+    };
+
 } // namespace mu::mem
 
 #endif // !MU_ALLOCATOR_H
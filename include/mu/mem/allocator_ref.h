@@ -0,0 +1,49 @@
+#ifndef MU_ALLOCATOR_REF_H
+#define MU_ALLOCATOR_REF_H
+
+#include "mu/mem/allocator.h" // Allocator, StaticAllocator
+#include <cassert>            // assert
+#include <concepts>           // derived_from
+
+namespace mu::mem {
+
+/// Refers to the allocator a container allocates its memory from.
+///
+/// A pointer to the allocator is stored, and calls are dispatched through the
+/// static type `A` (so they are only virtual if `A` is `mem::Allocator`).
+///
+/// ## Note
+/// Containers should store this as a `[[no_unique_address]]` member, so that
+/// it takes no space for static allocators.
+template <class A> class AllocatorRef {
+  static_assert(std::derived_from<A, Allocator>,
+                "`A` must be a `mem::Allocator`");
+
+public:
+  explicit AllocatorRef(A* allocator = nullptr) noexcept
+      : allocator{allocator} {}
+
+  /// Returns the allocator.
+  auto get() const noexcept -> A& {
+    assert(this->allocator != nullptr);
+    return *this->allocator;
+  }
+
+private:
+  A* allocator;
+};
+
+/// Refers to a `StaticAllocator`, which is default-constructed whenever it is
+/// needed, so nothing is stored.
+template <StaticAllocator A> class AllocatorRef<A> {
+public:
+  /// `allocator` is ignored (and may be `nullptr`).
+  explicit AllocatorRef(A* /*allocator*/ = nullptr) noexcept {}
+
+  /// Returns the allocator.
+  auto get() const noexcept -> A { return A(); }
+};
+
+} // namespace mu::mem
+
+#endif // !MU_ALLOCATOR_REF_H
@@ -0,0 +1,102 @@
+#ifndef MU_ARENA_ALLOCATOR_H
+#define MU_ARENA_ALLOCATOR_H
+
+#include "mu/mem/allocator.h" // Allocator
+#include "mu/primitives.h"    // usize, u8
+
+namespace mu::mem {
+
+/// A bump allocator that carves allocations out of large chunks obtained from
+/// a backing allocator.
+///
+/// Individual frees are no-ops, except for the allocation at the top of the
+/// arena which is given back (and which can also be grown in place), so frees
+/// in reverse order of allocation reclaim memory (unless alignment padding
+/// separates the allocations). All memory is reclaimed at once with `reset` or
+/// `rollback`, and returned to the backing allocator when the arena is
+/// destroyed.
+class ArenaAllocator : public Allocator {
+  struct Chunk;
+
+public:
+  /// A position in the arena that can be returned to with `rollback`.
+  struct Checkpoint {
+    Chunk* chunk;
+    usize  used;
+  };
+
+  static const usize DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+  /// Creates an arena that requests chunks of (at least) `chunk_size` bytes
+  /// from `backing`.
+  explicit ArenaAllocator(Allocator* backing,
+                          usize      chunk_size = DEFAULT_CHUNK_SIZE) noexcept;
+  ArenaAllocator(const ArenaAllocator& other)            = delete;
+  ArenaAllocator& operator=(const ArenaAllocator& other) = delete;
+
+  /// Move construct from `other`, leaving `other` empty.
+  ArenaAllocator(ArenaAllocator&& other) noexcept;
+
+  /// Move assign from `other`, leaving `other` empty.
+  ArenaAllocator& operator=(ArenaAllocator&& other) noexcept;
+
+  /// Returns all chunks to the backing allocator.
+  ~ArenaAllocator() override;
+
+  /// Returns the current position of the arena.
+  auto checkpoint() const noexcept -> Checkpoint;
+
+  /// Frees everything allocated since `checkpoint` was taken.
+  ///
+  /// ## Note
+  /// The chunks are kept around and reused by subsequent allocations.
+  auto rollback(Checkpoint checkpoint) noexcept -> void;
+
+  /// Frees everything allocated from the arena in O(1).
+  ///
+  /// ## Note
+  /// The chunks are kept around and reused by subsequent allocations; use
+  /// `release` to return them to the backing allocator.
+  auto reset() noexcept -> void;
+
+  /// Frees everything allocated from the arena and returns all chunks to the
+  /// backing allocator.
+  auto release() noexcept -> void;
+
+  /// Returns the total number of bytes reserved from the backing allocator.
+  auto capacity() const noexcept -> usize;
+
+  /// Checks if `ptr` points into one of the arena's chunks.
+  auto owns(void* ptr) const noexcept -> bool;
+
+private:
+  struct Chunk {
+    Chunk* next;
+    usize  cap;
+  };
+
+  Allocator* backing    = nullptr;
+  usize      chunk_size = DEFAULT_CHUNK_SIZE;
+  Chunk*     head       = nullptr;
+  Chunk*     current    = nullptr;
+  usize      used       = 0;
+
+  /// Moves to the next chunk that can fit `byte_size` bytes, allocating a new
+  /// one if necessary.
+  auto nextChunk(usize byte_size) -> bool;
+
+  /// Returns the offset of `ptr` in the current chunk if the `byte_size` bytes
+  /// at `ptr` are the top of the arena, or `-1` otherwise.
+  auto topOffset(void* ptr, usize byte_size) const noexcept -> usize;
+
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override;
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override;
+  auto native_align_fn() const noexcept -> usize override;
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override;
+};
+
+} // namespace mu::mem
+
+#endif // !MU_ARENA_ALLOCATOR_H
@@ -4,12 +4,22 @@
 #include "mu/mem/allocator.h" // Allocator
 #include "mu/primitives.h"    // usize, u8
 
-#include <cstdlib> // malloc, free
+#include <cstddef> // max_align_t
+#include <cstdlib> // malloc, calloc, posix_memalign, realloc, free
+#include <cstring> // memset
+#include <limits>  // numeric_limits
 
 namespace mu::mem {
 
-class CAllocator : public Allocator {
+/// An allocator backed by the C allocation functions (`malloc`, `calloc`,
+/// `realloc` and `free`).
+///
+/// Alignments above `alignof(std::max_align_t)` are served natively by
+/// `posix_memalign`, so no alignment header is ever needed.
+class CAllocator final : public Allocator {
 public:
+  static constexpr bool IS_STATIC = true;
+
   CAllocator()                                   = default;
   ~CAllocator()                                  = default;
   CAllocator(const CAllocator& other)            = default;
@@ -18,8 +28,40 @@ public:
   CAllocator& operator=(CAllocator&& other)      = default;
 
 private:
-  auto alloc_fn(usize byte_size) noexcept -> void* override;
-  auto free_fn(void* ptr) noexcept -> void override;
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override {
+    if (align <= alignof(std::max_align_t)) {
+      return std::malloc(byte_size);
+    }
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, align, byte_size) != 0) {
+      return nullptr;
+    }
+    return ptr;
+  }
+
+  auto alloc_zeroed_fn(usize byte_size,
+                       usize align) noexcept -> void* override {
+    // `calloc` skips the `memset` for memory that is fresh from the OS
+    if (align <= alignof(std::max_align_t)) {
+      return std::calloc(1, byte_size);
+    }
+    void* ptr = this->alloc_fn(byte_size, align);
+    return ptr == nullptr ? nullptr : std::memset(ptr, 0, byte_size);
+  }
+
+  auto free_fn(void* ptr, usize /*byte_size*/,
+               usize /*align*/) noexcept -> void override {
+    std::free(ptr);
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return std::numeric_limits<usize>::max();
+  }
+
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override;
+  auto remap_fn(void* ptr, usize old_size, usize new_size,
+                usize align) noexcept -> void* override;
 };
 
 } // namespace mu::mem
@@ -0,0 +1,278 @@
+#ifndef MU_COMBINATORS_H
+#define MU_COMBINATORS_H
+
+#include "mu/mem/allocator.h" // Allocator, StaticAllocator, OwningAllocator
+#include "mu/primitives.h"    // usize
+#include <cassert>            // assert
+#include <limits>             // numeric_limits
+#include <tuple>              // tuple, make_from_tuple
+#include <utility>            // piecewise_construct_t, index_sequence
+
+namespace mu::mem {
+
+// NOTE: The combinators store their inner allocators by value, so calls to them
+// are dispatched statically (and can be inlined) instead of going through the
+// virtual `mem::Allocator` interface. Inner allocators are default-constructed
+// or constructed in place from argument tuples (like `std::pair`), so
+// allocators that can't be moved (like `PoolAllocator`) can be used too.
+
+/// Allocates from `Primary`, and from `Secondary` when `Primary` fails.
+///
+/// Frees are routed with `Primary::owns`.
+template <OwningAllocator Primary, class Secondary>
+class FallbackAllocator final : public Allocator {
+  static_assert(std::derived_from<Secondary, Allocator>,
+                "`Secondary` must be a `mem::Allocator`");
+
+public:
+  static constexpr bool IS_STATIC =
+      StaticAllocator<Primary> && StaticAllocator<Secondary>;
+
+  FallbackAllocator() = default;
+
+  /// Constructs the inner allocators from `primary_args` and
+  /// `secondary_args`.
+  template <typename... PrimaryArgs, typename... SecondaryArgs>
+  FallbackAllocator(std::piecewise_construct_t,
+                    std::tuple<PrimaryArgs...>   primary_args,
+                    std::tuple<SecondaryArgs...> secondary_args)
+      : primary_{std::make_from_tuple<Primary>(std::move(primary_args))},
+        secondary_{
+            std::make_from_tuple<Secondary>(std::move(secondary_args))} {}
+
+  /// Checks if `ptr` was allocated by either allocator.
+  auto owns(void* ptr) const noexcept -> bool
+    requires(OwningAllocator<Secondary>)
+  {
+    return this->primary_.owns(ptr) || this->secondary_.owns(ptr);
+  }
+
+  auto primary() noexcept -> Primary& { return this->primary_; }
+  auto secondary() noexcept -> Secondary& { return this->secondary_; }
+
+private:
+  Primary   primary_;
+  Secondary secondary_;
+
+  auto      alloc_fn(usize byte_size, usize align) -> void* override {
+    void* ptr = this->primary_.rawAlloc(byte_size, align);
+    return ptr != nullptr ? ptr : this->secondary_.rawAlloc(byte_size, align);
+  }
+
+  auto alloc_zeroed_fn(usize byte_size, usize align) -> void* override {
+    void* ptr = this->primary_.rawAllocZeroed(byte_size, align);
+    return ptr != nullptr ? ptr
+                          : this->secondary_.rawAllocZeroed(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override {
+    if (this->primary_.owns(ptr)) {
+      this->primary_.rawFree(ptr, byte_size, align);
+    } else {
+      this->secondary_.rawFree(ptr, byte_size, align);
+    }
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return std::numeric_limits<usize>::max();
+  }
+
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override {
+    if (this->primary_.owns(ptr)) {
+      return this->primary_.rawResize(ptr, old_size, new_size, align);
+    }
+    return this->secondary_.rawResize(ptr, old_size, new_size, align);
+  }
+
+  auto remap_fn(void* ptr, usize old_size, usize new_size,
+                usize align) -> void* override {
+    // Only the owner's cheap paths: moving between the allocators (or
+    // allocating, copying and freeing) is done by `rawRealloc`, through
+    // `alloc_fn` and `free_fn`
+    if (this->primary_.owns(ptr)) {
+      return this->primary_.rawRemap(ptr, old_size, new_size, align);
+    }
+    return this->secondary_.rawRemap(ptr, old_size, new_size, align);
+  }
+};
+
+/// Allocates blocks of at most `Threshold` bytes from `Small`, and larger
+/// blocks from `Large`.
+///
+/// ## Note
+/// Frees are routed by size, so neither allocator needs to implement `owns`.
+template <usize Threshold, class Small, class Large>
+class Segregator final : public Allocator {
+  static_assert(std::derived_from<Small, Allocator>,
+                "`Small` must be a `mem::Allocator`");
+  static_assert(std::derived_from<Large, Allocator>,
+                "`Large` must be a `mem::Allocator`");
+
+public:
+  static constexpr bool IS_STATIC =
+      StaticAllocator<Small> && StaticAllocator<Large>;
+
+  Segregator() = default;
+
+  /// Constructs the inner allocators from `small_args` and `large_args`.
+  template <typename... SmallArgs, typename... LargeArgs>
+  Segregator(std::piecewise_construct_t, std::tuple<SmallArgs...> small_args,
+             std::tuple<LargeArgs...> large_args)
+      : small_{std::make_from_tuple<Small>(std::move(small_args))},
+        large_{std::make_from_tuple<Large>(std::move(large_args))} {}
+
+  /// Checks if `ptr` was allocated by either allocator.
+  auto owns(void* ptr) const noexcept -> bool
+    requires(OwningAllocator<Small> && OwningAllocator<Large>)
+  {
+    return this->small_.owns(ptr) || this->large_.owns(ptr);
+  }
+
+  auto small() noexcept -> Small& { return this->small_; }
+  auto large() noexcept -> Large& { return this->large_; }
+
+private:
+  Small small_;
+  Large large_;
+
+  auto  alloc_fn(usize byte_size, usize align) -> void* override {
+    return byte_size <= Threshold ? this->small_.rawAlloc(byte_size, align)
+                                  : this->large_.rawAlloc(byte_size, align);
+  }
+
+  auto alloc_zeroed_fn(usize byte_size, usize align) -> void* override {
+    return byte_size <= Threshold
+               ? this->small_.rawAllocZeroed(byte_size, align)
+               : this->large_.rawAllocZeroed(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override {
+    if (byte_size <= Threshold) {
+      this->small_.rawFree(ptr, byte_size, align);
+    } else {
+      this->large_.rawFree(ptr, byte_size, align);
+    }
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return std::numeric_limits<usize>::max();
+  }
+
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override {
+    // Allocations can't be resized into the other allocator
+    if ((old_size <= Threshold) != (new_size <= Threshold)) {
+      return false;
+    }
+    return old_size <= Threshold
+               ? this->small_.rawResize(ptr, old_size, new_size, align)
+               : this->large_.rawResize(ptr, old_size, new_size, align);
+  }
+
+  auto remap_fn(void* ptr, usize old_size, usize new_size,
+                usize align) -> void* override {
+    // Moving between the allocators is done by `rawRealloc`
+    if ((old_size <= Threshold) != (new_size <= Threshold)) {
+      return nullptr;
+    }
+    return old_size <= Threshold
+               ? this->small_.rawRemap(ptr, old_size, new_size, align)
+               : this->large_.rawRemap(ptr, old_size, new_size, align);
+  }
+};
+
+/// Splits allocations of `[Min, Max]` bytes into buckets of `Step` bytes, each
+/// served by its own instance of `Alloc`.
+///
+/// Allocations outside of `[Min, Max]` fail, so a `Bucketizer` is usually
+/// combined with a `Segregator` or a `FallbackAllocator`.
+template <class Alloc, usize Min, usize Max, usize Step>
+class Bucketizer final : public Allocator {
+  static_assert(std::derived_from<Alloc, Allocator>,
+                "`Alloc` must be a `mem::Allocator`");
+  static_assert((Step > 0) && (Min <= Max), "invalid bucket range");
+
+public:
+  static constexpr bool  IS_STATIC   = StaticAllocator<Alloc>;
+
+  /// The number of buckets.
+  static constexpr usize NUM_BUCKETS = (Max - Min) / Step + 1;
+
+  /// Constructs every bucket's allocator from `args`.
+  template <typename... Args>
+  explicit Bucketizer(const Args&... args)
+      : Bucketizer(std::make_index_sequence<NUM_BUCKETS>{}, args...) {}
+
+  /// Checks if `ptr` was allocated by any bucket.
+  auto owns(void* ptr) const noexcept -> bool
+    requires(OwningAllocator<Alloc>)
+  {
+    for (const Alloc& bucket : this->buckets) {
+      if (bucket.owns(ptr)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the allocator of the `idx`th bucket.
+  auto bucket(usize idx) noexcept -> Alloc& { return this->buckets[idx]; }
+
+  /// Returns the bucket that serves allocations of `byte_size` bytes.
+  static constexpr auto bucketOf(usize byte_size) noexcept -> usize {
+    return (byte_size - Min) / Step;
+  }
+
+  /// Checks if allocations of `byte_size` bytes are served by a bucket.
+  static constexpr auto inRange(usize byte_size) noexcept -> bool {
+    return (byte_size >= Min) && (byte_size <= Max);
+  }
+
+private:
+  Alloc buckets[NUM_BUCKETS];
+
+  template <usize... Idxs, typename... Args>
+  Bucketizer(std::index_sequence<Idxs...> /*idxs*/, const Args&... args)
+      : buckets{((void)Idxs, Alloc(args...))...} {}
+
+  auto alloc_fn(usize byte_size, usize align) -> void* override {
+    if (!inRange(byte_size)) {
+      return nullptr;
+    }
+    return this->buckets[bucketOf(byte_size)].rawAlloc(byte_size, align);
+  }
+
+  auto alloc_zeroed_fn(usize byte_size, usize align) -> void* override {
+    if (!inRange(byte_size)) {
+      return nullptr;
+    }
+    return this->buckets[bucketOf(byte_size)].rawAllocZeroed(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override {
+    assert(inRange(byte_size));
+    this->buckets[bucketOf(byte_size)].rawFree(ptr, byte_size, align);
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return std::numeric_limits<usize>::max();
+  }
+
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override {
+    // Allocations can only be resized within their bucket
+    if (!inRange(new_size) || (bucketOf(old_size) != bucketOf(new_size))) {
+      return false;
+    }
+    return this->buckets[bucketOf(old_size)].rawResize(ptr, old_size, new_size,
+                                                       align);
+  }
+};
+
+} // namespace mu::mem
+
+#endif // !MU_COMBINATORS_H
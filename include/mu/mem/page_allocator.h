@@ -0,0 +1,82 @@
+#ifndef MU_PAGE_ALLOCATOR_H
+#define MU_PAGE_ALLOCATOR_H
+
+#include "mu/mem/allocator.h" // Allocator
+#include "mu/primitives.h"    // usize
+
+namespace mu::mem {
+
+/// An allocator that maps memory directly from the OS with `mmap`.
+///
+/// Every allocation gets its own mapping (rounded up to whole pages), which is
+/// returned to the OS with `munmap` when freed. This is meant for large
+/// buffers, and as the backing allocator for arenas and pools.
+///
+/// ## Note
+/// Freshly mapped memory is always zeroed, so `allocZeroed` is as cheap as
+/// `allocUninit`.
+class PageAllocator final : public Allocator {
+public:
+  /// How huge pages should be used for the mappings.
+  enum class HugePages {
+    /// Only use regular pages.
+    None,
+    /// Round allocations of at least one huge page up to (and align them to)
+    /// the huge page size, and request transparent huge pages with
+    /// `madvise(MADV_HUGEPAGE)`.
+    Transparent,
+    /// Same as `Transparent`, but map explicit huge pages with `MAP_HUGETLB`,
+    /// falling back to transparent huge pages if none are available.
+    Explicit,
+  };
+
+  /// The size of a huge page.
+  static const usize HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  explicit PageAllocator(HugePages huge_pages = HugePages::None) noexcept
+      : huge_pages{huge_pages} {}
+  ~PageAllocator() override                            = default;
+  PageAllocator(const PageAllocator& other)            = default;
+  PageAllocator(PageAllocator&& other)                 = default;
+  PageAllocator& operator=(const PageAllocator& other) = default;
+  PageAllocator& operator=(PageAllocator&& other)      = default;
+
+  /// Returns the size of a (regular) page.
+  static auto pageSize() noexcept -> usize;
+
+  /// Returns the physical memory backing `byte_size` bytes at `ptr` to the OS
+  /// (with `madvise(MADV_DONTNEED)`), while keeping the memory mapped.
+  ///
+  /// ## Note
+  /// `ptr` must be page-aligned. The discarded memory reads as zero on the
+  /// next access.
+  static auto discard(void* ptr, usize byte_size) noexcept -> void;
+
+private:
+  HugePages huge_pages = HugePages::None;
+
+  /// Checks if an allocation of `byte_size` bytes is backed by huge pages.
+  auto      usesHugePages(usize byte_size) const noexcept -> bool;
+
+  /// Returns the size of the mapping for an allocation of `byte_size` bytes.
+  ///
+  /// ## Note
+  /// The mapping size is derived from the allocation size alone, so no
+  /// per-allocation metadata is needed to unmap it.
+  auto      mappingSize(usize byte_size) const noexcept -> usize;
+
+  auto      alloc_fn(usize byte_size, usize align) noexcept -> void* override;
+  auto      alloc_zeroed_fn(usize byte_size,
+                            usize align) noexcept -> void* override;
+  auto      free_fn(void* ptr, usize byte_size,
+                    usize align) noexcept -> void override;
+  auto      native_align_fn() const noexcept -> usize override;
+  auto      resize_fn(void* ptr, usize old_size, usize new_size,
+                      usize align) noexcept -> bool override;
+  auto      remap_fn(void* ptr, usize old_size, usize new_size,
+                     usize align) noexcept -> void* override;
+};
+
+} // namespace mu::mem
+
+#endif // !MU_PAGE_ALLOCATOR_H
@@ -0,0 +1,145 @@
+#ifndef MU_POOL_ALLOCATOR_H
+#define MU_POOL_ALLOCATOR_H
+
+#include "mu/mem/allocator.h" // Allocator
+#include "mu/primitives.h"    // usize, u8
+#include <cstddef>            // max_align_t
+
+namespace mu::mem {
+
+/// An allocator for single objects of type `T`.
+///
+/// Blocks of `sizeof(T)` bytes are carved out of slabs obtained from a backing
+/// allocator, and freed blocks are kept in an intrusive free list, so both
+/// `create` and `destroy` are O(1) and need no per-object header.
+///
+/// ## Note
+/// Only allocations of a single `T` (with at most `alignof(T)` alignment) can
+/// be served; anything else throws an `OutOfMemoryException`.
+template <typename T> class PoolAllocator : public Allocator {
+  union Block {
+    Block* next;
+    alignas(T) u8 storage[sizeof(T)];
+  };
+
+  struct Slab {
+    Slab* next;
+  };
+
+public:
+  static const usize DEFAULT_BLOCKS_PER_SLAB = 256;
+
+  /// Creates a pool that requests slabs of `blocks_per_slab` blocks from
+  /// `backing`.
+  explicit PoolAllocator(
+      Allocator* backing,
+      usize      blocks_per_slab = DEFAULT_BLOCKS_PER_SLAB) noexcept
+      : backing{backing}, blocks_per_slab{blocks_per_slab} {}
+
+  PoolAllocator(const PoolAllocator& other)            = delete;
+  PoolAllocator& operator=(const PoolAllocator& other) = delete;
+
+  /// Returns all slabs to the backing allocator.
+  ~PoolAllocator() override {
+    Slab* slab = this->slabs;
+    while (slab != nullptr) {
+      Slab* next = slab->next;
+      this->backing->rawFree(slab, this->slabSize(), SLAB_ALIGN);
+      slab = next;
+    }
+  }
+
+  /// Checks if `ptr` points into one of the pool's slabs.
+  auto owns(void* ptr) const noexcept -> bool {
+    u8* addr = reinterpret_cast<u8*>(ptr);
+    for (Slab* slab = this->slabs; slab != nullptr; slab = slab->next) {
+      u8* start = reinterpret_cast<u8*>(slab);
+      if ((addr >= start) && (addr < start + this->slabSize())) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the number of blocks reserved from the backing allocator.
+  auto capacity() const noexcept -> usize {
+    usize cap = 0;
+    for (Slab* slab = this->slabs; slab != nullptr; slab = slab->next) {
+      cap += this->blocks_per_slab;
+    }
+    return cap;
+  }
+
+private:
+  static constexpr usize SLAB_ALIGN = alignof(Block) > alignof(std::max_align_t)
+                                          ? alignof(Block)
+                                          : alignof(std::max_align_t);
+
+  /// Size of the slab header, padded so the blocks stay aligned.
+  static constexpr usize SLAB_HEADER_SIZE =
+      (sizeof(Slab) + alignof(Block) - 1) & ~(alignof(Block) - 1);
+
+  Allocator*             backing         = nullptr;
+  usize                  blocks_per_slab = DEFAULT_BLOCKS_PER_SLAB;
+  Slab*                  slabs           = nullptr;
+  Block*                 free_list       = nullptr;
+
+  /// The untouched blocks of the most recent slab.
+  Block*                 fresh           = nullptr;
+  Block*                 fresh_end       = nullptr;
+
+  /// Returns the size of a slab (including its header).
+  auto                   slabSize() const noexcept -> usize {
+    return SLAB_HEADER_SIZE + (this->blocks_per_slab * sizeof(Block));
+  }
+
+  /// Requests a new slab from the backing allocator.
+  auto addSlab() noexcept -> bool {
+    Slab* slab = reinterpret_cast<Slab*>(
+        this->backing->rawAlloc(this->slabSize(), SLAB_ALIGN));
+    if (slab == nullptr) {
+      return false;
+    }
+    slab->next      = this->slabs;
+    this->slabs     = slab;
+    this->fresh     = reinterpret_cast<Block*>(reinterpret_cast<u8*>(slab) +
+                                           SLAB_HEADER_SIZE);
+    this->fresh_end = this->fresh + this->blocks_per_slab;
+    return true;
+  }
+
+  auto alloc_fn(usize byte_size, usize /*align*/) noexcept -> void* override {
+    if (byte_size > sizeof(Block)) {
+      return nullptr;
+    }
+    if (this->free_list != nullptr) {
+      Block* block    = this->free_list;
+      this->free_list = block->next;
+      return block;
+    }
+    if ((this->fresh == this->fresh_end) && !this->addSlab()) {
+      return nullptr;
+    }
+    return this->fresh++;
+  }
+
+  auto free_fn(void* ptr, usize /*byte_size*/,
+               usize /*align*/) noexcept -> void override {
+    Block* block    = reinterpret_cast<Block*>(ptr);
+    block->next     = this->free_list;
+    this->free_list = block;
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return alignof(Block);
+  }
+
+  auto resize_fn(void* /*ptr*/, usize /*old_size*/, usize new_size,
+                 usize /*align*/) noexcept -> bool override {
+    return new_size <= sizeof(Block);
+  }
+};
+
+} // namespace mu::mem
+
+#endif // !MU_POOL_ALLOCATOR_H
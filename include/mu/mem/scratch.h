@@ -0,0 +1,93 @@
+#ifndef MU_SCRATCH_H
+#define MU_SCRATCH_H
+
+#include "mu/mem/allocator.h"       // Allocator
+#include "mu/mem/arena_allocator.h" // ArenaAllocator
+#include "mu/primitives.h"          // usize
+#include <limits>                   // numeric_limits
+
+namespace mu::mem {
+
+/// Size of the chunks the scratch arenas request from the system.
+static const usize SCRATCH_CHUNK_SIZE = 256 * 1024;
+
+/// Returns the scratch arena of the current thread.
+///
+/// The arena is created on first use and released when the thread exits. Use
+/// a `TempScope` to give the memory back when the temporaries are no longer
+/// needed.
+auto scratchArena() noexcept -> ArenaAllocator&;
+
+/// Rolls the current thread's scratch arena back to where it was when the
+/// scope was entered.
+///
+/// Scopes nest: an inner scope only frees what was allocated since it was
+/// entered.
+///
+/// ## Note
+/// Everything allocated from the scratch arena (directly or through a
+/// `ScratchAllocator`) while the scope is active is freed when it exits, and
+/// must not be used afterwards.
+class TempScope {
+public:
+  TempScope() noexcept
+      : arena{scratchArena()}, checkpoint{arena.checkpoint()} {}
+  TempScope(const TempScope& other)            = delete;
+  TempScope(TempScope&& other)                 = delete;
+  TempScope& operator=(const TempScope& other) = delete;
+  TempScope& operator=(TempScope&& other)      = delete;
+
+  ~TempScope() { this->arena.rollback(this->checkpoint); }
+
+  /// Returns the scratch arena of the current thread.
+  auto arenaAllocator() const noexcept -> ArenaAllocator& {
+    return this->arena;
+  }
+
+private:
+  ArenaAllocator&            arena;
+  ArenaAllocator::Checkpoint checkpoint;
+};
+
+/// An allocator that allocates from the scratch arena of the current thread.
+///
+/// This lets existing APIs that take a `mem::Allocator` (or a
+/// `StaticAllocator` type, like `UniquePtr`) use the scratch arena.
+///
+/// ## Note
+/// Memory must be freed on the thread it was allocated on, and only lives
+/// until the enclosing `TempScope` exits.
+class ScratchAllocator final : public Allocator {
+public:
+  static constexpr bool IS_STATIC = true;
+
+  ScratchAllocator()                                         = default;
+  ~ScratchAllocator()                                        = default;
+  ScratchAllocator(const ScratchAllocator& other)            = default;
+  ScratchAllocator(ScratchAllocator&& other)                 = default;
+  ScratchAllocator& operator=(const ScratchAllocator& other) = default;
+  ScratchAllocator& operator=(ScratchAllocator&& other)      = default;
+
+private:
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override {
+    return scratchArena().rawAlloc(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override {
+    scratchArena().rawFree(ptr, byte_size, align);
+  }
+
+  auto native_align_fn() const noexcept -> usize override {
+    return std::numeric_limits<usize>::max();
+  }
+
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override {
+    return scratchArena().rawResize(ptr, old_size, new_size, align);
+  }
+};
+
+} // namespace mu::mem
+
+#endif // !MU_SCRATCH_H
@@ -0,0 +1,48 @@
+#ifndef MU_THREAD_SAFE_ALLOCATOR_H
+#define MU_THREAD_SAFE_ALLOCATOR_H
+
+#include "mu/mem/allocator.h" // Allocator
+#include "mu/primitives.h"    // usize
+#include <memory>             // shared_ptr
+
+namespace mu::mem {
+
+namespace internal {
+struct ThreadSafeHeap;
+} // namespace internal
+
+/// A thread-safe allocator that scales with the number of threads.
+///
+/// Small allocations are grouped into size classes. Each thread keeps a cache
+/// of free blocks per size class, which is refilled from (and drained to) a
+/// shared heap in batches, so most allocations and frees never take a lock.
+/// Large allocations (over 16 KiB) go straight to the system allocator.
+///
+/// ## Note
+/// Memory may be freed from a different thread than the one it was allocated
+/// on. The chunks that small allocations are carved from are returned to the
+/// system when the allocator is destroyed, but large allocations are not
+/// tracked, so they must be freed before then.
+class ThreadSafeAllocator : public Allocator {
+public:
+  ThreadSafeAllocator();
+  ThreadSafeAllocator(const ThreadSafeAllocator& other)            = delete;
+  ThreadSafeAllocator& operator=(const ThreadSafeAllocator& other) = delete;
+  ThreadSafeAllocator(ThreadSafeAllocator&& other)                 = delete;
+  ThreadSafeAllocator& operator=(ThreadSafeAllocator&& other)      = delete;
+  ~ThreadSafeAllocator() override;
+
+private:
+  std::shared_ptr<internal::ThreadSafeHeap> heap;
+
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override;
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override;
+  auto native_align_fn() const noexcept -> usize override;
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override;
+};
+
+} // namespace mu::mem
+
+#endif // !MU_THREAD_SAFE_ALLOCATOR_H
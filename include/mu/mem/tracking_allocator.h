@@ -0,0 +1,105 @@
+#ifndef MU_TRACKING_ALLOCATOR_H
+#define MU_TRACKING_ALLOCATOR_H
+
+#include "mu/io/writer.h"     // Writer
+#include "mu/mem/allocator.h" // Allocator
+#include "mu/primitives.h"    // usize, u64
+#include <atomic>             // atomic
+
+namespace mu::mem {
+
+/// An allocator that wraps another allocator and records statistics about the
+/// allocations made through it.
+///
+/// The counters are updated with relaxed atomics, so this is cheap enough to
+/// leave on in production, and is as thread-safe as the backing allocator.
+///
+/// ## Note
+/// The statistics are only eventually consistent: a snapshot taken while
+/// other threads are allocating may mix counters from slightly different
+/// points in time.
+class TrackingAllocator final : public Allocator {
+public:
+  /// The number of size classes in the histogram; class `i` counts
+  /// allocations of `[2^i, 2^(i + 1))` bytes (class `0` also counts empty
+  /// allocations).
+  static constexpr usize NUM_SIZE_CLASSES = sizeof(usize) * 8;
+
+  /// A snapshot of the statistics.
+  struct Stats {
+    /// The number of successful allocations.
+    u64   allocs;
+    /// The number of frees.
+    u64   frees;
+    /// The number of successful in-place resizes and reallocations.
+    u64   resizes;
+    /// The number of allocations the backing allocator failed.
+    u64   failures;
+    /// The number of bytes currently allocated.
+    usize live_bytes;
+    /// The largest number of bytes that were allocated at once.
+    usize peak_bytes;
+    /// The number of allocations in each (log2) size class.
+    u64   histogram[NUM_SIZE_CLASSES];
+
+    /// Returns the number of allocations that haven't been freed.
+    auto  liveAllocs() const noexcept -> u64 { return allocs - frees; }
+  };
+
+  /// Creates an allocator that forwards to (and tracks) `backing`.
+  explicit TrackingAllocator(Allocator* backing) noexcept : backing{backing} {}
+  TrackingAllocator(const TrackingAllocator& other)            = delete;
+  TrackingAllocator& operator=(const TrackingAllocator& other) = delete;
+  ~TrackingAllocator() override                                = default;
+
+  /// Returns a snapshot of the current statistics.
+  auto stats() const noexcept -> Stats;
+
+  /// Resets the counters and the histogram.
+  ///
+  /// ## Note
+  /// `live_bytes` is kept, since the live allocations will still be freed;
+  /// `peak_bytes` is reset to it.
+  auto reset() noexcept -> void;
+
+  /// Writes a human-readable report of the current statistics to `writer`.
+  auto dump(io::Writer& writer) const -> void;
+
+  /// Returns the size class of an allocation of `byte_size` bytes.
+  static auto sizeClass(usize byte_size) noexcept -> usize;
+
+private:
+  Allocator*         backing;
+  std::atomic<u64>   allocs{0};
+  std::atomic<u64>   frees{0};
+  std::atomic<u64>   resizes{0};
+  std::atomic<u64>   failures{0};
+  std::atomic<usize> live_bytes{0};
+  std::atomic<usize> peak_bytes{0};
+  std::atomic<u64>   histogram[NUM_SIZE_CLASSES]{};
+
+  /// Records an allocation of `byte_size` bytes (or a failure if `ptr` is
+  /// `nullptr`), and returns `ptr`.
+  auto               track(void* ptr, usize byte_size) noexcept -> void*;
+
+  /// Records that an allocation was resized from `old_size` to `new_size`.
+  auto trackResize(usize old_size, usize new_size) noexcept -> void;
+
+  /// Records that the live bytes grew by `byte_size`.
+  auto grow(usize byte_size) noexcept -> void;
+
+  auto alloc_fn(usize byte_size, usize align) noexcept -> void* override;
+  auto alloc_zeroed_fn(usize byte_size,
+                       usize align) noexcept -> void* override;
+  auto free_fn(void* ptr, usize byte_size,
+               usize align) noexcept -> void override;
+  auto native_align_fn() const noexcept -> usize override;
+  auto resize_fn(void* ptr, usize old_size, usize new_size,
+                 usize align) noexcept -> bool override;
+  auto remap_fn(void* ptr, usize old_size, usize new_size,
+                usize align) noexcept -> void* override;
+};
+
+} // namespace mu::mem
+
+#endif // !MU_TRACKING_ALLOCATOR_H
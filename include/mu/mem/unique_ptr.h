@@ -2,27 +2,41 @@
 #define MU_UNIQUE_PTR_H
 
 #include "mu/cloneable.h"
-#include "mu/mem/allocator.h"   // Allocator
+#include "mu/common.h"          // AllocatorMismatchException
+#include "mu/mem/allocator.h"   // Allocator, StaticAllocator
 #include "mu/mem/c_allocator.h" // CAllocator
-#include "mu/panic.h"
-#include "mu/primitives.h" // usize, u64
-#include "mu/slice.h"      // Slice
-#include <type_traits>     // is_same_v
-#include <utility>         // forward, swap
+#include "mu/mem/utils.h"       // IS_TRIVIALLY_RELOCATABLE
+#include "mu/primitives.h"      // usize, u64
+#include "mu/slice.h"           // Slice
+#include <concepts>             // derived_from
+#include <new>                  // placement new
+#include <type_traits>          // conditional_t, is_trivially_destructible_v
+#include <utility>              // forward, swap
 
 namespace mu {
 
 namespace internal::helper {
+/// The default allocator of a `UniquePtr<T>`: single objects use the static
+/// `mem::CAllocator`, while slices use the `mem::Allocator*` passed to
+/// `create` (so existing callers keep allocating from the allocator they pass
+/// in).
+template <typename T> struct DefaultUniquePtrAllocator {
+  using Type = mem::CAllocator;
+};
 
-/// TODO: Replace with check for static allocator instead!!
-///   - Must be default constructible
-///   - Must inherit base type `StaticAllocator`
-///   - Move this to `allocator.h` instead!
-///
-/// TODO: Add check to `UniquePtr` allocator parameter:
-///   - Should be an `mem::Allocator`
-template <typename T>
-concept IsCAllocator = std::is_same_v<T, mem::CAllocator>;
+template <typename T> struct DefaultUniquePtrAllocator<Slice<T>> {
+  using Type = mem::Allocator;
+};
+
+/// Throws an `AllocatorMismatchException` if `allocator` is neither `nullptr`
+/// nor an instance of the static allocator `Allocator`.
+template <class Allocator>
+auto checkStaticAllocator(mem::Allocator* allocator) -> void {
+  if ((allocator != nullptr) &&
+      (dynamic_cast<Allocator*>(allocator) == nullptr)) {
+    throw common::AllocatorMismatchException();
+  }
+}
 } // namespace internal::helper
 
 /// A smart pointer that owns and manages another object through a pointer and
@@ -30,7 +44,17 @@ concept IsCAllocator = std::is_same_v<T, mem::CAllocator>;
 ///
 /// # Note
 /// Manages a single object of type `T`.
-template <typename T, class Allocator = mem::CAllocator> class UniquePtr {
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored
+/// and allocations are dispatched statically; otherwise the `mem::Allocator*`
+/// passed to `create` is stored and used through virtual calls.
+template <typename T,
+          class Allocator =
+              typename internal::helper::DefaultUniquePtrAllocator<T>::Type>
+class UniquePtr {
+  static_assert(std::derived_from<Allocator, mem::Allocator>,
+                "`Allocator` must be a `mem::Allocator`");
+
   struct empty {};
 
 public:
@@ -38,17 +62,22 @@ public:
   auto operator=(const UniquePtr&) -> UniquePtr& = delete;
 
   /// Constructs an object of type `T` and wraps it in a `UniquePtr`.
+  ///
+  /// ## Note
+  /// For static allocators, `allocator` may be `nullptr`; otherwise it must be
+  /// an `Allocator` (or an `AllocatorMismatchException` is thrown).
   template <typename... Args>
   static auto create(mem::Allocator* allocator = nullptr,
-                     Args... args) -> UniquePtr<T> {
+                     Args... args) -> UniquePtr {
     T* data;
-    if constexpr (internal::helper::IsCAllocator<Allocator>) {
-      data  = Allocator().template create<T>();
-      *data = T{std::forward<Args>(args)...};
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      internal::helper::checkStaticAllocator<Allocator>(allocator);
+      data = Allocator().template create<T>();
+      new (data) T{std::forward<Args>(args)...};
       return UniquePtr(empty{}, data);
     } else {
-      data  = allocator->create<T>();
-      *data = T{std::forward<Args>(args)...};
+      data = allocator->create<T>();
+      new (data) T{std::forward<Args>(args)...};
       return UniquePtr(allocator, data);
     }
   }
@@ -78,14 +107,14 @@ public:
     this->allocator = other.allocator;
     this->data      = other.data;
     other.data      = nullptr;
+    return *this;
   }
 
   /// Destroys the managed object.
   ~UniquePtr() {
-    if constexpr (internal::helper::IsCAllocator<Allocator>) {
-      Allocator().destroy(this->data);
-    } else {
-      this->allocator->destroy(this->data);
+    if (this->data) {
+      this->data->~T();
+      this->getAllocator().destroy(this->data);
     }
   }
 
@@ -127,7 +156,8 @@ public:
     T* old     = this->data;
     this->data = ptr;
     if (old) {
-      this->allocator->destroy(old);
+      old->~T();
+      this->getAllocator().destroy(old);
     }
   }
 
@@ -135,28 +165,35 @@ public:
   //  - have a constexpr if to check for each
   //
   /// Clones the contained value.
-  auto clone() const -> UniquePtr<T>
+  auto clone() const -> UniquePtr
     requires(Cloneable<T>)
   {
-    if constexpr (internal::helper::IsCAllocator<Allocator>) {
+    if constexpr (mem::StaticAllocator<Allocator>) {
       T* data = Allocator().template create<T>();
-      *data   = this->data->clone();
+      new (data) T(this->data->clone());
       return UniquePtr(empty{}, data);
     } else {
       T* data = this->allocator->template create<T>();
-      *data   = this->data->clone();
+      new (data) T(this->data->clone());
       return UniquePtr(this->allocator, data);
     }
   }
 
 private:
-  /// TODO: Replace the `is_same_v` check with `isStaticAllocator` (see todo
-  /// above)
   using AllocatorType =
-      std::conditional_t<std::is_same_v<Allocator, mem::CAllocator>, empty,
-                         Allocator*>;
+      std::conditional_t<mem::StaticAllocator<Allocator>, empty,
+                         mem::Allocator*>;
   [[no_unique_address]] AllocatorType allocator;
   T*                                  data;
+
+  /// Returns the allocator that owns the managed object.
+  auto getAllocator() const noexcept -> decltype(auto) {
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      return Allocator();
+    } else {
+      return *this->allocator;
+    }
+  }
 };
 
 /// A smart pointer that owns and manages another object through a pointer and
@@ -164,27 +201,65 @@ private:
 ///
 /// # Note
 /// Manages a dynamically-allocated array of objects.
-template <typename T> class UniquePtr<Slice<T>> {
+///
+/// Unless a static allocator is named, this stores the `mem::Allocator*`
+/// passed to `create` (`UniquePtr<Slice<T>>` uses `mem::Allocator`).
+template <typename T, class Allocator> class UniquePtr<Slice<T>, Allocator> {
+  static_assert(std::derived_from<Allocator, mem::Allocator>,
+                "`Allocator` must be a `mem::Allocator`");
+
+  struct empty {};
+
 public:
   UniquePtr(const UniquePtr&)                    = delete;
   auto operator=(const UniquePtr&) -> UniquePtr& = delete;
 
   /// Constructs `len` number of objects of type `T` and wraps the resulting
   /// slice in a `UniquePtr`.
+  ///
+  /// ## Note
+  /// For static allocators, `allocator` may be `nullptr`; otherwise it must be
+  /// an `Allocator` (or an `AllocatorMismatchException` is thrown).
   template <typename... Args>
   static auto create(mem::Allocator* allocator, usize len,
-                     Args... args) -> UniquePtr<Slice<T>> {
-    Slice<T> data = allocator->alloc<T>(len);
+                     Args... args) -> UniquePtr {
+    Slice<T> data;
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      internal::helper::checkStaticAllocator<Allocator>(allocator);
+      data = Allocator().template allocUninit<T>(len);
+    } else {
+      data = allocator->allocUninit<T>(len);
+    }
     for (usize i = 0; i < len; i++) {
-      data[i] = T{std::forward<Args>(args)...};
+      new (data.ptr() + i) T{args...};
+    }
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      return UniquePtr(empty{}, data);
+    } else {
+      return UniquePtr(allocator, data);
+    }
+  }
+
+  /// Takes ownership of a slice (`data`) allocated using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  static auto fromSlice(mem::Allocator* allocator,
+                        Slice<T>        data) -> UniquePtr {
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      return UniquePtr(empty{}, data);
+    } else {
+      return UniquePtr(allocator, data);
     }
-    return UniquePtr(allocator, data);
   }
 
   /// Creates a `UniquePtr` from a slice (`data`) allocated using `allocator`.
   explicit UniquePtr(mem::Allocator* allocator, Slice<T> data)
       : allocator{allocator}, data{data} {}
 
+  explicit UniquePtr(empty allocator, Slice<T> data)
+      : allocator{allocator}, data{data} {}
+
   /// Creates a `UniquePtr` by transferring ownership from `other` to `this`.
   UniquePtr(UniquePtr&& other) noexcept {
     this->allocator = other.allocator;
@@ -202,10 +277,14 @@ public:
     this->allocator = other.allocator;
     this->data      = other.data;
     other.data      = Slice<T>(nullptr, 0);
+    return *this;
   }
 
   /// Destroys the managed slice.
-  ~UniquePtr() { this->allocator->free(this->data); }
+  ~UniquePtr() {
+    destroyAll(this->data);
+    this->getAllocator().free(this->data);
+  }
 
   ///  Returns the slice owned by `this`.
   constexpr auto     operator*() const noexcept -> Slice<T>& { return data; }
@@ -247,7 +326,8 @@ public:
     Slice<T> old = this->data;
     this->data   = slice;
     if (old.ptr()) {
-      this->allocator->free(old);
+      destroyAll(old);
+      this->getAllocator().free(old);
     }
   }
 
@@ -255,21 +335,48 @@ public:
   //  - have a constexpr if to check for each
   //
   /// Clones the contained value.
-  auto clone() const -> UniquePtr<Slice<T>>
+  auto clone() const -> UniquePtr
     requires(Cloneable<T>)
   {
-    Slice<T> data = this->allocator->template alloc<T>(this->data.len());
+    Slice<T> data = this->getAllocator().template alloc<T>(this->data.len());
     for (usize i = 0; i < this->data.len(); i++) {
-      data[i] = this->data[i].clone();
+      new (data.ptr() + i) T(this->data[i].clone());
     }
     return UniquePtr(this->allocator, data);
   }
 
 private:
-  mem::Allocator* allocator;
-  Slice<T>        data;
+  using AllocatorType =
+      std::conditional_t<mem::StaticAllocator<Allocator>, empty,
+                         mem::Allocator*>;
+  [[no_unique_address]] AllocatorType allocator;
+  Slice<T>                            data;
+
+  /// Runs the destructors of the objects in `slice`.
+  static auto destroyAll(Slice<T> slice) noexcept -> void {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (usize i = 0; i < slice.len(); i++) {
+        slice.ptr()[i].~T();
+      }
+    }
+  }
+
+  /// Returns the allocator that owns the managed slice.
+  auto getAllocator() const noexcept -> decltype(auto) {
+    if constexpr (mem::StaticAllocator<Allocator>) {
+      return Allocator();
+    } else {
+      return *this->allocator;
+    }
+  }
 };
 
+/// A `UniquePtr` only holds a pointer to its data, so it can be moved with
+/// `memcpy`.
+template <typename T, class Allocator>
+inline constexpr bool mem::IS_TRIVIALLY_RELOCATABLE<UniquePtr<T, Allocator>> =
+    true;
+
 } // namespace mu
 
 #endif // !MU_UNIQUE_PTR_H
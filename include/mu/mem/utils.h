@@ -4,6 +4,10 @@
 #include "mu/primitives.h"
 #include <algorithm>
 #include <array>
+#include <cstring>     // memcpy
+#include <new>         // placement new
+#include <type_traits> // is_trivially_copyable_v
+#include <utility>     // move
 
 namespace mu::mem {
 // NOTE: Impl from:
@@ -21,6 +25,49 @@ template <typename T> auto swapEndian(T& val) {
   val = dst.val;
 }
 
+/// The (assumed) size of a cache line.
+///
+/// Data written by different threads is aligned to this, so that their writes
+/// don't invalidate each other's cache lines (false sharing).
+inline constexpr usize CACHE_LINE_SIZE = 64;
+
+/// Determines if a `T` can be moved to another address by copying its bytes
+/// (and forgetting the original), instead of move constructing the new object
+/// and destroying the old one.
+///
+/// ## Note
+/// Specialize this for types that own resources through a pointer, but don't
+/// point into themselves (e.g. `UniquePtr`).
+template <typename T>
+inline constexpr bool IS_TRIVIALLY_RELOCATABLE =
+    std::is_trivially_copyable_v<T>;
+
+/// Determines if `T` can be relocated with `memcpy`.
+template <typename T>
+concept TriviallyRelocatable = IS_TRIVIALLY_RELOCATABLE<T>;
+
+/// Moves `len` objects from `src` into the uninitialized memory at `dst`, and
+/// ends the lifetime of the objects at `src`.
+///
+/// ## Note
+/// The ranges must not overlap.
+template <typename T>
+auto relocate(T* dst, T* src, usize len) noexcept -> void {
+  if constexpr (TriviallyRelocatable<T>) {
+    if (len != 0) {
+      std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src),
+                  sizeof(T) * len);
+    }
+  } else {
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "`T` must be nothrow move constructible");
+    for (usize i = 0; i < len; i++) {
+      new (dst + i) T(std::move(src[i]));
+      src[i].~T();
+    }
+  }
+}
+
 } // namespace mu::mem
 
 #endif // !MU_MEM_H
@@ -0,0 +1,256 @@
+#ifndef MU_MPMC_QUEUE_H
+#define MU_MPMC_QUEUE_H
+
+#include "mu/common.h"            // OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/utils.h"         // CACHE_LINE_SIZE
+#include "mu/primitives.h"        // usize, i64, u8, u32
+#include "mu/slice.h"             // Slice
+#include <atomic>                 // atomic, memory_order
+#include <bit>                    // bit_ceil
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <thread>                 // this_thread::yield
+#include <type_traits>            // is_nothrow_move_constructible_v
+#include <utility>                // move
+
+namespace mu {
+
+/// A bounded, lock-free queue that any number of threads can push to and pop
+/// from concurrently.
+///
+/// This is Dmitry Vyukov's bounded MPMC queue: each slot has a sequence
+/// number that says whether it is ready to be written or read for the
+/// current lap around the ring, so a push or pop only needs one
+/// compare-and-swap on the shared index, and producers and consumers never
+/// touch the same index.
+///
+/// ## Note
+/// `tryPush` and `tryPop` never wait. `pushMany` and `popMany` claim a range
+/// of slots at once, and may briefly wait for the threads that were still
+/// popping (or pushing) those slots.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, class Allocator = mem::CAllocator> class MpmcQueue {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "`T` must be nothrow move constructible");
+
+  struct Cell {
+    std::atomic<usize> seq;
+    alignas(T) u8 storage[sizeof(T)];
+
+    auto val() noexcept -> T* { return reinterpret_cast<T*>(this->storage); }
+  };
+
+public:
+  MpmcQueue(const MpmcQueue&)                    = delete;
+  MpmcQueue(MpmcQueue&&)                         = delete;
+  auto operator=(const MpmcQueue&) -> MpmcQueue& = delete;
+  auto operator=(MpmcQueue&&) -> MpmcQueue&      = delete;
+
+  /// Creates an empty queue that can hold at least `capacity` items (rounded
+  /// up to a power of 2), allocated from `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  MpmcQueue(Allocator* allocator, usize capacity)
+      : allocator{allocator}, cap{roundCapacity(capacity)}, mask{cap - 1} {
+    usize size = sizeof(Cell) * this->cap;
+    this->cells =
+        static_cast<Cell*>(this->allocator.get().rawAlloc(size, CELLS_ALIGN));
+    if (this->cells == nullptr) {
+      throw common::OutOfMemoryException(size);
+    }
+    for (usize i = 0; i < this->cap; i++) {
+      new (&this->cells[i].seq) std::atomic<usize>(i);
+    }
+  }
+
+  ~MpmcQueue() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      usize tail = this->tail.load(std::memory_order_relaxed);
+      for (usize i = this->head.load(std::memory_order_relaxed); i != tail;
+           i++) {
+        this->cells[i & this->mask].val()->~T();
+      }
+    }
+    this->allocator.get().rawFree(this->cells, sizeof(Cell) * this->cap,
+                                  CELLS_ALIGN);
+  }
+
+  /// Returns the number of items the queue can hold.
+  auto capacity() const noexcept -> usize { return this->cap; }
+
+  /// Returns the (approximate) number of items in the queue.
+  ///
+  /// ## Note
+  /// This is only a snapshot if other threads use the queue concurrently, and
+  /// counts the items that are still being pushed or popped.
+  auto len() const noexcept -> usize {
+    usize head = this->head.load(std::memory_order_acquire);
+    usize tail = this->tail.load(std::memory_order_acquire);
+    return (tail > head) ? tail - head : 0;
+  }
+
+  /// Pushes `val` to the back of the queue.
+  ///
+  /// Returns `false` (leaving `val` untouched) if the queue is full.
+  auto tryPush(T&& val) noexcept -> bool {
+    usize pos = this->tail.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell       = this->cells + (pos & this->mask);
+      i64   diff = i64(cell->seq.load(std::memory_order_acquire) - pos);
+      if (diff == 0) {
+        if (this->tail.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // The slot hasn't been popped since the last lap
+      } else {
+        pos = this->tail.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->val()) T(std::move(val));
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Pushes a copy of `val` to the back of the queue.
+  ///
+  /// Returns `false` if the queue is full.
+  auto tryPush(const T& val) -> bool {
+    T copy = val;
+    return this->tryPush(std::move(copy));
+  }
+
+  /// Pops the item at the front of the queue into `out`.
+  ///
+  /// Returns `false` (leaving `out` untouched) if the queue is empty.
+  auto tryPop(T& out) -> bool {
+    usize pos = this->head.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell       = this->cells + (pos & this->mask);
+      i64   diff = i64(cell->seq.load(std::memory_order_acquire) - (pos + 1));
+      if (diff == 0) {
+        if (this->head.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false; // The slot hasn't been pushed to in this lap
+      } else {
+        pos = this->head.load(std::memory_order_relaxed);
+      }
+    }
+    out = std::move(*cell->val());
+    cell->val()->~T();
+    cell->seq.store(pos + this->cap, std::memory_order_release);
+    return true;
+  }
+
+  /// Moves as many of `items` as fit to the back of the queue.
+  ///
+  /// Returns the number of items pushed: `items[0..n]` are moved from (and
+  /// pushed in order, though other threads' items may be interleaved with
+  /// them once popped), and the rest are left untouched.
+  auto pushMany(Slice<T> items) noexcept -> usize {
+    // `Slice<u8>::ptr` returns a `cstr`
+    T*    src = reinterpret_cast<T*>(items.ptr());
+    usize pos = this->tail.load(std::memory_order_relaxed);
+    usize n;
+    do {
+      // Only slots whose previous item has been claimed by a consumer can be
+      // claimed
+      i64   used = i64(pos - this->head.load(std::memory_order_acquire));
+      usize free = (used < 0) ? this->cap : this->cap - usize(used);
+      n          = (free < items.len()) ? free : items.len();
+      if (n == 0) {
+        return 0;
+      }
+    } while (!this->tail.compare_exchange_weak(pos, pos + n,
+                                               std::memory_order_relaxed));
+
+    for (usize i = 0; i < n; i++) {
+      Cell* cell = this->cells + ((pos + i) & this->mask);
+      waitFor(cell->seq, pos + i);
+      new (cell->val()) T(std::move(src[i]));
+      cell->seq.store(pos + i + 1, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// Pops up to `out.len()` items from the front of the queue into `out`.
+  ///
+  /// Returns the number of items popped into `out[0..n]`.
+  auto popMany(Slice<T> out) -> usize {
+    T*    dst = reinterpret_cast<T*>(out.ptr());
+    usize pos = this->head.load(std::memory_order_relaxed);
+    usize n;
+    do {
+      // Only slots that have been claimed by a producer can be claimed
+      i64   avail = i64(this->tail.load(std::memory_order_acquire) - pos);
+      n           = (avail < 0) ? 0 : usize(avail);
+      n           = (n < out.len()) ? n : out.len();
+      if (n == 0) {
+        return 0;
+      }
+    } while (!this->head.compare_exchange_weak(pos, pos + n,
+                                               std::memory_order_relaxed));
+
+    for (usize i = 0; i < n; i++) {
+      Cell* cell = this->cells + ((pos + i) & this->mask);
+      waitFor(cell->seq, pos + i + 1);
+      dst[i] = std::move(*cell->val());
+      cell->val()->~T();
+      cell->seq.store(pos + i + this->cap, std::memory_order_release);
+    }
+    return n;
+  }
+
+private:
+  /// The alignment of the cells (at least a cache line).
+  static constexpr usize CELLS_ALIGN = (alignof(Cell) > mem::CACHE_LINE_SIZE)
+                                           ? alignof(Cell)
+                                           : mem::CACHE_LINE_SIZE;
+
+  /// Rounds `capacity` up to a power of 2 (of at least 2).
+  static auto roundCapacity(usize capacity) -> usize {
+    if (capacity > std::numeric_limits<usize>::max() / (2 * sizeof(Cell))) {
+      throw common::OutOfMemoryException(capacity);
+    }
+    return std::bit_ceil((capacity < 2) ? usize(2) : capacity);
+  }
+
+  /// Waits until `seq` is `expected`, i.e. until the thread that claimed the
+  /// slot in the previous step has finished with it.
+  static auto waitFor(const std::atomic<usize>& seq, usize expected) noexcept
+      -> void {
+    for (u32 spins = 0; seq.load(std::memory_order_acquire) != expected;
+         spins++) {
+      if (spins >= 64) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  // Read-only after construction
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  Cell*                                              cells = nullptr;
+  usize                                              cap;
+  usize                                              mask;
+
+  // Claimed by producers
+  alignas(mem::CACHE_LINE_SIZE) std::atomic<usize> tail{0};
+
+  // Claimed by consumers
+  alignas(mem::CACHE_LINE_SIZE) std::atomic<usize> head{0};
+};
+
+} // namespace mu
+
+#endif // !MU_MPMC_QUEUE_H
@@ -0,0 +1,448 @@
+#ifndef MU_MULTI_ARRAY_LIST_H
+#define MU_MULTI_ARRAY_LIST_H
+
+#include "mu/common.h"            // IndexOutOfBounds, OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/scratch.h"       // TempScope
+#include "mu/mem/utils.h"         // relocate
+#include "mu/optional.h"          // Optional
+#include "mu/primitives.h"        // usize, u8, u32
+#include "mu/slice.h"             // Slice
+#include <algorithm>              // sort
+#include <functional>             // less
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <tuple>                  // tuple, tie, get, tuple_element_t
+#include <type_traits>            // is_aggregate_v, is_same_v
+#include <utility>                // declval, index_sequence, move
+
+namespace mu {
+
+namespace internal::fields {
+/// Converts to any type, to count the fields of an aggregate by initializing
+/// it with more and more of them.
+template <usize> struct AnyField {
+  template <typename F> operator F() const noexcept;
+};
+
+template <typename T, usize... Idxs>
+constexpr auto initializableWith(std::index_sequence<Idxs...> /*idxs*/)
+    -> bool {
+  return requires { T{AnyField<Idxs>{}...}; };
+}
+
+/// Returns the number of fields of the aggregate `T`.
+template <typename T, usize N = 0> constexpr auto count() -> usize {
+  if constexpr (initializableWith<T>(std::make_index_sequence<N + 1>{})) {
+    return count<T, N + 1>();
+  } else {
+    return N;
+  }
+}
+
+/// The maximum number of fields `tie` supports.
+inline constexpr usize MAX_FIELDS = 8;
+
+/// Returns a tuple of references to the fields of `val`.
+template <typename T> constexpr auto tie(T& val) noexcept {
+  constexpr usize N = count<std::remove_const_t<T>>();
+  static_assert((N > 0) && (N <= MAX_FIELDS),
+                "`T` must have between 1 and 8 fields");
+  if constexpr (N == 1) {
+    auto& [a] = val;
+    return std::tie(a);
+  } else if constexpr (N == 2) {
+    auto& [a, b] = val;
+    return std::tie(a, b);
+  } else if constexpr (N == 3) {
+    auto& [a, b, c] = val;
+    return std::tie(a, b, c);
+  } else if constexpr (N == 4) {
+    auto& [a, b, c, d] = val;
+    return std::tie(a, b, c, d);
+  } else if constexpr (N == 5) {
+    auto& [a, b, c, d, e] = val;
+    return std::tie(a, b, c, d, e);
+  } else if constexpr (N == 6) {
+    auto& [a, b, c, d, e, f] = val;
+    return std::tie(a, b, c, d, e, f);
+  } else if constexpr (N == 7) {
+    auto& [a, b, c, d, e, f, g] = val;
+    return std::tie(a, b, c, d, e, f, g);
+  } else {
+    auto& [a, b, c, d, e, f, g, h] = val;
+    return std::tie(a, b, c, d, e, f, g, h);
+  }
+}
+
+template <typename Tie> struct Types;
+template <typename... Fs> struct Types<std::tuple<Fs&...>> {
+  using type = std::tuple<Fs...>;
+};
+
+/// A tuple of the types of the fields of `T`.
+template <typename T>
+using FieldTypes = typename Types<decltype(tie(std::declval<T&>()))>::type;
+} // namespace internal::fields
+
+/// A list of aggregates (structs) that stores each field in its own array.
+///
+/// Loops that only use a few fields only load those fields' arrays, instead
+/// of every item's full struct, so they use every byte of each cache line
+/// (and usually auto-vectorize).
+///
+/// All arrays are stored in a single allocation, each aligned to a cache
+/// line.
+///
+/// ## Note
+/// `T` must be an aggregate with 1 to 8 fields (and no C array fields), whose
+/// fields are nothrow move constructible. The items are not stored as `T`s, so
+/// `get` and `pop` return them by value.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, class Allocator = mem::CAllocator>
+class MultiArrayList {
+  static_assert(std::is_aggregate_v<T>, "`T` must be an aggregate");
+
+  using Fields = internal::fields::FieldTypes<T>;
+
+public:
+  /// The number of fields of `T`.
+  static constexpr usize NUM_FIELDS = std::tuple_size_v<Fields>;
+
+  /// The type of field `I` of `T`.
+  template <usize I> using Field = std::tuple_element_t<I, Fields>;
+
+  MultiArrayList(const MultiArrayList&)                    = delete;
+  auto operator=(const MultiArrayList&) -> MultiArrayList& = delete;
+
+  /// Creates an empty list that allocates using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit MultiArrayList(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator} {}
+
+  /// Creates a list by transferring the items from `other`, which is left
+  /// empty.
+  MultiArrayList(MultiArrayList&& other) noexcept
+      : allocator{other.allocator}, bytes{other.bytes}, len_{other.len_},
+        cap{other.cap} {
+    other.forget();
+  }
+
+  /// Move assignment operator.
+  auto operator=(MultiArrayList&& other) noexcept -> MultiArrayList& {
+    if (this != &other) {
+      this->release();
+      this->allocator = other.allocator;
+      this->bytes     = other.bytes;
+      this->len_      = other.len_;
+      this->cap       = other.cap;
+      other.forget();
+    }
+    return *this;
+  }
+
+  ~MultiArrayList() noexcept { this->release(); }
+
+  /// Returns the values of field `I` of all items.
+  ///
+  /// ## Note
+  /// The slice is invalidated when the list grows.
+  template <usize I> auto items() noexcept -> Slice<Field<I>> {
+    if constexpr (std::is_same_v<Field<I>, u8>) {
+      // `Slice<u8>` is a string, which is made from a `Slice<char>`
+      return Slice<u8>(Slice<char>(
+          reinterpret_cast<char*>(this->fieldPtr<I>()), this->len_));
+    } else {
+      return Slice<Field<I>>(this->fieldPtr<I>(), this->len_);
+    }
+  }
+
+  /// Returns the values of field `I` of all items.
+  template <usize I> auto items() const noexcept -> Slice<const Field<I>> {
+    return Slice<const Field<I>>(this->fieldPtr<I>(), this->len_);
+  }
+
+  /// Returns the number of items in the list.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Returns the number of items the list can hold without reallocating.
+  auto capacity() const noexcept -> usize { return this->cap; }
+
+  /// Returns (a copy of) the item at index `idx`.
+  auto get(usize idx) const -> T {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    return [&]<usize... Is>(std::index_sequence<Is...> /*idxs*/) {
+      return T{this->fieldPtr<Is>()[idx]...};
+    }(std::make_index_sequence<NUM_FIELDS>{});
+  }
+
+  /// Replaces the item at index `idx` with `val`.
+  auto set(usize idx, T val) -> void {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    auto fields = internal::fields::tie(val);
+    forEachField([&]<usize I>() {
+      this->fieldPtr<I>()[idx] = std::move(std::get<I>(fields));
+    });
+  }
+
+  /// Makes sure the list can hold at least `capacity` items in total, growing
+  /// it geometrically if needed.
+  auto ensureCapacity(usize capacity) -> void {
+    if (capacity <= this->cap) {
+      return;
+    }
+
+    usize grown = (this->cap < MIN_CAPACITY) ? MIN_CAPACITY : this->cap * 2;
+    this->setCapacity((grown < capacity) ? capacity : grown);
+  }
+
+  /// Makes sure the list can hold at least `additional` more items.
+  auto ensureUnusedCapacity(usize additional) -> void {
+    if (additional > std::numeric_limits<usize>::max() - this->len_) {
+      throw common::OutOfMemoryException(additional);
+    }
+    this->ensureCapacity(this->len_ + additional);
+  }
+
+  /// Appends `val` to the end of the list.
+  auto append(T val) -> void {
+    if (this->len_ == this->cap) {
+      this->ensureCapacity(this->len_ + 1);
+    }
+    auto fields = internal::fields::tie(val);
+    forEachField([&]<usize I>() {
+      new (this->fieldPtr<I>() + this->len_)
+          Field<I>(std::move(std::get<I>(fields)));
+    });
+    this->len_++;
+  }
+
+  /// Removes and returns the item at index `idx`, replacing it with the last
+  /// item (in O(1), without preserving the order).
+  auto swapRemove(usize idx) -> T {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    T     res  = this->take(idx);
+    usize last = this->len_ - 1;
+    if (idx != last) {
+      forEachField([&]<usize I>() {
+        mem::relocate(this->fieldPtr<I>() + idx, this->fieldPtr<I>() + last,
+                      1);
+      });
+    }
+    this->len_--;
+    return res;
+  }
+
+  /// Removes and returns the last item, if there is one.
+  auto pop() -> Optional<T> {
+    if (this->len_ == 0) {
+      return Optional<T>();
+    }
+    T res = this->take(this->len_ - 1);
+    this->len_--;
+    return Optional<T>(std::move(res));
+  }
+
+  /// Removes all items from the list (keeping its memory).
+  auto clear() noexcept -> void {
+    this->destroyItems();
+    this->len_ = 0;
+  }
+
+  /// Sorts the items by field `I` (comparing the values with `less`).
+  ///
+  /// The sort only reads field `I`; the other fields are then moved (once)
+  /// into their sorted order.
+  ///
+  /// ## Note
+  /// The sort is not stable.
+  template <usize I, typename Less = std::less<Field<I>>>
+  auto sortBy(Less less = Less{}) -> void {
+    if (this->len_ < 2) {
+      return;
+    }
+    if (this->len_ > std::numeric_limits<u32>::max()) {
+      throw common::OutOfMemoryException(this->len_);
+    }
+
+    // The permutation (and the staging buffers) are temporaries, so they go
+    // in the thread's scratch arena
+    mem::TempScope       scope{};
+    mem::ArenaAllocator& arena = scope.arenaAllocator();
+    Slice<u32>           perm  = arena.allocUninit<u32>(this->len_);
+    u32*                 order = perm.ptr();
+    for (usize i = 0; i < this->len_; i++) {
+      order[i] = static_cast<u32>(i);
+    }
+    const Field<I>* keys = this->fieldPtr<I>();
+    std::sort(order, order + this->len_,
+              [&](u32 lhs, u32 rhs) { return less(keys[lhs], keys[rhs]); });
+
+    forEachField([&]<usize F>() {
+      // Raw memory, since `Slice<u8>` can't be allocated as an array
+      using V     = Field<F>;
+      V*    vals  = this->fieldPtr<F>();
+      usize size  = sizeof(V) * this->len_;
+      V*    moved = static_cast<V*>(arena.rawAlloc(size, alignof(V)));
+      if (moved == nullptr) {
+        throw common::OutOfMemoryException(size);
+      }
+      for (usize i = 0; i < this->len_; i++) {
+        new (moved + i) V(std::move(vals[order[i]]));
+      }
+      if constexpr (!std::is_trivially_destructible_v<V>) {
+        for (usize i = 0; i < this->len_; i++) {
+          vals[i].~V();
+        }
+      }
+      mem::relocate(vals, moved, this->len_);
+    });
+  }
+
+private:
+  /// The capacity of the first allocation.
+  static constexpr usize MIN_CAPACITY = 8;
+
+  /// The alignment of each field's array (at least a cache line).
+  static constexpr usize ALIGN = []<usize... Is>(
+                                     std::index_sequence<Is...> /*idxs*/) {
+    usize align = 64;
+    ((align = (alignof(Field<Is>) > align) ? alignof(Field<Is>) : align), ...);
+    return align;
+  }(std::make_index_sequence<NUM_FIELDS>{});
+
+  /// The size of all fields of one item.
+  static constexpr usize ITEM_SIZE =
+      []<usize... Is>(std::index_sequence<Is...> /*idxs*/) {
+        return (sizeof(Field<Is>) + ...);
+      }(std::make_index_sequence<NUM_FIELDS>{});
+
+  /// Calls `func.template operator()<I>()` for each field index `I`.
+  template <typename F> static auto forEachField(F&& func) -> void {
+    [&]<usize... Is>(std::index_sequence<Is...> /*idxs*/) {
+      (func.template operator()<Is>(), ...);
+    }(std::make_index_sequence<NUM_FIELDS>{});
+  }
+
+  /// Returns the size of the array of field `I` for `cap` items, rounded up
+  /// to `ALIGN`.
+  template <usize I> static auto arraySize(usize cap) noexcept -> usize {
+    return (sizeof(Field<I>) * cap + ALIGN - 1) & ~(ALIGN - 1);
+  }
+
+  /// Returns the offset of the array of field `I` in an allocation for `cap`
+  /// items.
+  template <usize I> static auto offset(usize cap) noexcept -> usize {
+    if constexpr (I == 0) {
+      return 0;
+    } else {
+      return offset<I - 1>(cap) + arraySize<I - 1>(cap);
+    }
+  }
+
+  /// Returns the size of an allocation for `cap` items.
+  static auto allocSize(usize cap) noexcept -> usize {
+    return offset<NUM_FIELDS - 1>(cap) + arraySize<NUM_FIELDS - 1>(cap);
+  }
+
+  template <usize I> auto fieldPtr() noexcept -> Field<I>* {
+    return reinterpret_cast<Field<I>*>(this->bytes + offset<I>(this->cap));
+  }
+
+  template <usize I> auto fieldPtr() const noexcept -> const Field<I>* {
+    return reinterpret_cast<const Field<I>*>(this->bytes +
+                                             offset<I>(this->cap));
+  }
+
+  /// Moves the item at index `idx` out of the arrays (destroying its fields).
+  auto take(usize idx) noexcept -> T {
+    return [&]<usize... Is>(std::index_sequence<Is...> /*idxs*/) {
+      T res{std::move(this->fieldPtr<Is>()[idx])...};
+      if constexpr (!std::is_trivially_destructible_v<T>) {
+        (this->fieldPtr<Is>()[idx].~Field<Is>(), ...);
+      }
+      return res;
+    }(std::make_index_sequence<NUM_FIELDS>{});
+  }
+
+  /// Moves the items to a new allocation for `capacity` (>= `len()`) items.
+  ///
+  /// Since the arrays' offsets depend on the capacity, the allocation can't
+  /// be resized in place.
+  auto setCapacity(usize capacity) -> void {
+    if (capacity > std::numeric_limits<usize>::max() / (2 * ITEM_SIZE)) {
+      throw common::OutOfMemoryException(capacity);
+    }
+
+    auto&& allocator = this->allocator.get();
+    usize  size      = allocSize(capacity);
+    u8*    bytes     = static_cast<u8*>(allocator.rawAlloc(size, ALIGN));
+    if (bytes == nullptr) {
+      throw common::OutOfMemoryException(size);
+    }
+
+    if (this->cap != 0) {
+      forEachField([&]<usize I>() {
+        mem::relocate(
+            reinterpret_cast<Field<I>*>(bytes + offset<I>(capacity)),
+            this->fieldPtr<I>(), this->len_);
+      });
+      allocator.rawFree(this->bytes, allocSize(this->cap), ALIGN);
+    }
+    this->bytes = bytes;
+    this->cap   = capacity;
+  }
+
+  auto destroyItems() noexcept -> void {
+    forEachField([&]<usize I>() {
+      if constexpr (!std::is_trivially_destructible_v<Field<I>>) {
+        Field<I>* vals = this->fieldPtr<I>();
+        for (usize i = 0; i < this->len_; i++) {
+          vals[i].~Field<I>();
+        }
+      }
+    });
+  }
+
+  /// Destroys the items and frees the arrays.
+  auto release() noexcept -> void {
+    if (this->cap != 0) {
+      this->destroyItems();
+      this->allocator.get().rawFree(this->bytes, allocSize(this->cap), ALIGN);
+    }
+    this->forget();
+  }
+
+  /// Leaves the list empty without freeing anything.
+  auto forget() noexcept -> void {
+    this->bytes = nullptr;
+    this->len_  = 0;
+    this->cap   = 0;
+  }
+
+  static_assert(
+      []<usize... Is>(std::index_sequence<Is...> /*idxs*/) {
+        return (std::is_nothrow_move_constructible_v<Field<Is>> && ...);
+      }(std::make_index_sequence<NUM_FIELDS>{}),
+      "The fields of `T` must be nothrow move constructible");
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  u8*                                                bytes = nullptr;
+  usize                                              len_  = 0;
+  usize                                              cap   = 0;
+};
+
+} // namespace mu
+
+#endif // !MU_MULTI_ARRAY_LIST_H
@@ -59,13 +59,8 @@ public:
   auto operator=(Optional&& other) noexcept -> Optional&
     requires(noexcept(~T()))
   {
-    // Destroy contained object
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
-
-    // Move `other`'s object if it exists
+    // Move `other`'s object if it exists (assigning to `val` destroys the
+    // contained object)
     if (other.isValid()) {
       this->val = std::get<T>(std::move(other.val));
     } else {
@@ -79,13 +74,8 @@ public:
   /// Move assignment operator.
   /// Transfers the object contained from `other` to `this`.
   auto operator=(Optional&& other) -> Optional& {
-    // Destroy contained object
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
-
-    // Move `other`'s object if it exists
+    // Move `other`'s object if it exists (assigning to `val` destroys the
+    // contained object)
     if (other.isValid()) {
       this->val = std::get<T>(std::move(other.val));
     } else {
@@ -97,22 +87,11 @@ public:
   }
 
   /// Destroys the contained object.
-  ~Optional() noexcept
-    requires(noexcept(~T()))
-  {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
-  }
-
-  /// Destroys the contained object.
-  ~Optional() {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
-  }
+  ///
+  /// ## Note
+  /// The `std::variant` destroys the object, so it must not be destroyed by
+  /// hand anywhere in this class.
+  ~Optional() = default;
 
   /// Checks if `this` is a valid optional.
   ///
@@ -244,10 +223,6 @@ public:
   auto replace(T&& val) noexcept -> void
     requires(noexcept(~T()))
   {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
     this->val = std::move(val);
   }
 
@@ -255,10 +230,6 @@ public:
   ///
   /// This will call the destructor of the contained value.
   auto replace(T&& val) -> void {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
     this->val = std::move(val);
   }
 
@@ -269,10 +240,6 @@ public:
   auto emplace(Args... args) noexcept -> void
     requires(noexcept(T{std::forward<Args>(args)...}) && noexcept(~T()))
   {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
     this->val = T{std::forward<Args>(args)...};
   }
 
@@ -280,10 +247,6 @@ public:
   ///
   /// This will call the destructor of the contained value.
   template <typename... Args> auto emplace(Args... args) -> void {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-    }
     this->val = T{std::forward<Args>(args)...};
   }
 
@@ -302,20 +265,12 @@ public:
   auto reset() noexcept
     requires(noexcept(~T()))
   {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-      this->val = std::monostate();
-    }
+    this->val = std::monostate();
   }
 
   /// Destroys any contained value, but leaves the `Optional` intact.
   auto reset() {
-    if (this->isValid()) {
-      auto& val = std::get<T>(this->val);
-      val.~T();
-      this->val = std::monostate();
-    }
+    this->val = std::monostate();
   }
 
   /// Calls `func` on the contained value and returns the result.
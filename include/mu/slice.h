@@ -1,9 +1,13 @@
 #ifndef MU_SLICE_H
 #define MU_SLICE_H
 
+#include "mu/bytes.h"      // indexOf, indexOfAny, count, matchMask
 #include "mu/common.h"     // IndexOutOfBounds
+#include "mu/optional.h"   // Optional
 #include "mu/primitives.h" // usize, u8< u64
-#include <cstring>         // strlen
+#include <bit>             // countr_zero
+#include <cassert>         // assert
+#include <cstring>         // memcmp, strlen
 #include <iostream>        // cout
 #include <ostream>         // endl
 
@@ -14,8 +18,53 @@ template <typename T>
 concept HasDebugFn = requires(const T self) {
   { self.debug() } -> std::same_as<void>;
 };
+
+/// Returns the base-2 logarithm of the (power of 2) alignment `align`.
+constexpr auto alignLog2(usize align) noexcept -> u8 {
+  return static_cast<u8>(std::countr_zero(align));
+}
+
+/// Returns the alignment of a pointer `offset` bytes past one aligned to
+/// `align`.
+constexpr auto offsetAlign(usize align, usize offset) noexcept -> usize {
+  if (offset == 0) {
+    return align;
+  }
+  usize offset_align = usize(1) << std::countr_zero(offset);
+  return (offset_align < align) ? offset_align : align;
+}
+
+/// Checks that `idx` is in bounds of a slice with `len` elements.
+///
+/// Throws an `IndexOutOfBounds` if it isn't, unless `MU_SLICE_UNCHECKED` is
+/// defined (see the `slice_bounds_checks` build option), in which case the
+/// index is only asserted (so release builds check nothing).
+inline auto checkIndex([[maybe_unused]] usize idx,
+                       [[maybe_unused]] usize len) -> void {
+#ifndef MU_SLICE_UNCHECKED
+  if (idx >= len) [[unlikely]] {
+    throw common::IndexOutOfBounds(idx, len);
+  }
+#else
+  assert(idx < len);
+#endif
+}
+
+/// Checks that `[start, end)` is a range in a slice with `len` elements.
+inline auto checkRange(usize start, usize end, usize len) -> void {
+  if (end > len) {
+    throw common::IndexOutOfBounds(end, len);
+  }
+  if (start > end) {
+    throw common::IndexOutOfBounds(start, end);
+  }
+}
 } // namespace internal::helper
 
+template <typename T> class Chunks;
+template <typename T> class Windows;
+class Split;
+
 // TODO: Add template specialization for make Slice<u8> from const_cstr
 //
 // TODO: Add Iterator mixin!
@@ -30,8 +79,8 @@ public:
   Slice(const Slice& other) noexcept            = default;
   Slice& operator=(const Slice& other) noexcept = default;
 
-  explicit Slice(T* ptr, usize len, u8 align = alignof(T)) noexcept
-      : ptr_{ptr}, len_{len}, align_{align} {}
+  explicit Slice(T* ptr, usize len, usize align = alignof(T)) noexcept
+      : ptr_{ptr}, len_{len}, align_{internal::helper::alignLog2(align)} {}
 
   /// Returns the number of elements in the slice.
   inline auto len() const noexcept -> usize { return this->len_; }
@@ -41,24 +90,67 @@ public:
   inline auto ptr() const noexcept -> T* { return this->ptr_; }
 
   /// Returns the alignment of the slice.
-  inline auto align() const noexcept -> u8 { return this->align_; }
+  inline auto align() const noexcept -> usize {
+    return usize(1) << this->align_;
+  }
 
   /// Indexes into the slice.
+  ///
+  /// ## Note
+  /// Throws an `IndexOutOfBounds` if `idx` is out of bounds, unless the
+  /// library is built without slice bounds checks (`MU_SLICE_UNCHECKED`),
+  /// where it is only asserted.
   auto        operator[](u64 idx) -> T& {
-    if (idx >= this->len()) {
-      throw common::IndexOutOfBounds(idx, this->len());
-    }
+    internal::helper::checkIndex(idx, this->len());
     return *(this->ptr_ + idx);
   }
 
   /// Indexes into the slice.
   auto operator[](u64 idx) const -> const T& {
-    if (idx >= this->len()) {
-      throw common::IndexOutOfBounds(idx, this->len());
-    }
+    internal::helper::checkIndex(idx, this->len());
     return *(this->ptr_ + idx);
   }
 
+  /// Indexes into the slice without a bounds check.
+  ///
+  /// ## Note
+  /// `idx` must be less than `len()`. This is not asserted either, so that
+  /// loops using it can be vectorized in debug builds too.
+  inline auto getUnchecked(usize idx) const noexcept -> T& {
+    return *(this->ptr_ + idx);
+  }
+
+  /// Returns a pointer to the first element.
+  ///
+  /// The slice's elements can be iterated over with a range-based `for` loop
+  /// (or passed to standard algorithms) without any bounds checks.
+  inline auto begin() const noexcept -> T* { return this->ptr_; }
+
+  /// Returns a pointer past the last element.
+  inline auto end() const noexcept -> T* { return this->ptr_ + this->len_; }
+
+  /// Returns a view of the elements in `[start, end)`.
+  ///
+  /// Throws an `IndexOutOfBounds` if the range is not in the slice.
+  auto subslice(usize start, usize end) const -> Slice {
+    internal::helper::checkRange(start, end, this->len());
+    return Slice(this->ptr_ + start, end - start,
+                 internal::helper::offsetAlign(this->align(),
+                                               sizeof(T) * start));
+  }
+
+  /// Returns views of consecutive, non-overlapping runs of `size` elements
+  /// (the last one may be shorter).
+  auto chunks(usize size) const noexcept -> Chunks<T> {
+    return Chunks<T>(*this, size);
+  }
+
+  /// Returns views of every run of `size` consecutive elements (which
+  /// overlap).
+  auto windows(usize size) const noexcept -> Windows<T> {
+    return Windows<T>(*this, size);
+  }
+
   // TODO: Add `elements` method to get the elements of the slice
 
   /// Print the slice to `stderr`.
@@ -71,7 +163,7 @@ public:
 private:
   T*  ptr_;
   u64 len_ : 56;
-  u8  align_ : 8;
+  u8  align_ : 8; // log2 of the alignment
 };
 
 template <> class Slice<u8> {
@@ -83,54 +175,60 @@ public:
 
   explicit Slice(const_cstr str)
       : ptr_{const_cast<cstr>(str)}, len_{strlen(str)},
-        align_{alignof(const_cstr)} {}
+        align_{internal::helper::alignLog2(alignof(const_cstr))} {}
 
   explicit Slice(cstr str)
-      : ptr_{str}, len_{strlen(str)}, align_{alignof(cstr)} {}
+      : ptr_{str}, len_{strlen(str)},
+        align_{internal::helper::alignLog2(alignof(cstr))} {}
+
+  explicit Slice(cstr ptr, usize len, usize align = alignof(char)) noexcept
+      : ptr_{ptr}, len_{len}, align_{internal::helper::alignLog2(align)} {}
 
   Slice(const Slice<cstr>& other) noexcept
-      : ptr_{*other.ptr()}, len_{other.len()}, align_{other.align()} {}
+      : ptr_{*other.ptr()}, len_{other.len()},
+        align_{internal::helper::alignLog2(other.align())} {}
 
   Slice(const Slice<const_cstr>& other) noexcept
       : ptr_{const_cast<cstr>(*other.ptr())}, len_{other.len()},
-        align_{other.align()} {}
+        align_{internal::helper::alignLog2(other.align())} {}
 
   Slice(const Slice<char>& other) noexcept
-      : ptr_{other.ptr()}, len_{other.len()}, align_{other.align()} {}
+      : ptr_{other.ptr()}, len_{other.len()},
+        align_{internal::helper::alignLog2(other.align())} {}
 
   Slice& operator=(const Slice<cstr>& other) noexcept {
     if ((this->ptr_ == *other.ptr()) && (this->len_ == other.len()) &&
-        (this->align_ == other.align())) {
+        (this->align() == other.align())) {
       return *this;
     }
 
     this->ptr_   = *other.ptr();
     this->len_   = other.len();
-    this->align_ = other.align();
+    this->align_ = internal::helper::alignLog2(other.align());
     return *this;
   }
 
   Slice& operator=(const Slice<const_cstr>& other) noexcept {
     if ((this->ptr_ == *other.ptr()) && (this->len_ == other.len()) &&
-        (this->align_ == other.align())) {
+        (this->align() == other.align())) {
       return *this;
     }
 
     this->ptr_   = const_cast<cstr>(*other.ptr());
     this->len_   = other.len();
-    this->align_ = other.align();
+    this->align_ = internal::helper::alignLog2(other.align());
     return *this;
   }
 
   Slice& operator=(const Slice<char>& other) noexcept {
     if ((this->ptr_ == other.ptr()) && (this->len_ == other.len()) &&
-        (this->align_ == other.align())) {
+        (this->align() == other.align())) {
       return *this;
     }
 
     this->ptr_   = other.ptr();
     this->len_   = other.len();
-    this->align_ = other.align();
+    this->align_ = internal::helper::alignLog2(other.align());
     return *this;
   }
 
@@ -142,24 +240,106 @@ public:
   inline auto ptr() const noexcept -> cstr { return this->ptr_; }
 
   /// Returns the alignment of the slice.
-  inline auto align() const noexcept -> u8 { return this->align_; }
+  inline auto align() const noexcept -> usize {
+    return usize(1) << this->align_;
+  }
 
   /// Indexes into the slice.
+  ///
+  /// ## Note
+  /// Throws an `IndexOutOfBounds` if `idx` is out of bounds, unless the
+  /// library is built without slice bounds checks (`MU_SLICE_UNCHECKED`),
+  /// where it is only asserted.
   auto        operator[](u64 idx) -> char {
-    if (idx >= this->len()) {
-      throw common::IndexOutOfBounds(idx, this->len());
-    }
+    internal::helper::checkIndex(idx, this->len());
     return this->ptr_[idx];
   }
 
   /// Indexes into the slice.
   auto operator[](u64 idx) const -> char {
-    if (idx >= this->len()) {
-      throw common::IndexOutOfBounds(idx, this->len());
-    }
+    internal::helper::checkIndex(idx, this->len());
     return this->ptr_[idx];
   }
 
+  /// Indexes into the slice without a bounds check.
+  ///
+  /// ## Note
+  /// `idx` must be less than `len()`.
+  inline auto getUnchecked(usize idx) const noexcept -> char& {
+    return this->ptr_[idx];
+  }
+
+  /// Returns a pointer to the first byte.
+  inline auto begin() const noexcept -> cstr { return this->ptr_; }
+
+  /// Returns a pointer past the last byte.
+  inline auto end() const noexcept -> cstr { return this->ptr_ + this->len_; }
+
+  /// Returns a view of the bytes in `[start, end)`.
+  ///
+  /// Throws an `IndexOutOfBounds` if the range is not in the slice.
+  auto subslice(usize start, usize end) const -> Slice {
+    internal::helper::checkRange(start, end, this->len());
+    return Slice(this->ptr_ + start, end - start,
+                 internal::helper::offsetAlign(this->align(), start));
+  }
+
+  /// Returns views of consecutive, non-overlapping runs of `size` bytes (the
+  /// last one may be shorter).
+  auto chunks(usize size) const noexcept -> Chunks<u8>;
+
+  /// Returns views of every run of `size` consecutive bytes (which overlap).
+  auto windows(usize size) const noexcept -> Windows<u8>;
+
+  /// Returns the index of the first `byte` in the slice, if there is one.
+  ///
+  /// ## Note
+  /// The byte search functions use the widest SIMD instructions the CPU
+  /// supports (SSE2, AVX2 or AVX-512), chosen at runtime.
+  auto indexOf(char byte) const noexcept -> Optional<usize> {
+    usize idx = internal::bytes::indexOf(this->ptr_, this->len_, byte);
+    if (idx == this->len_) {
+      return Optional<usize>();
+    }
+    return Optional<usize>(usize(idx));
+  }
+
+  /// Returns the index of the first byte that is one of the bytes in `set`,
+  /// if there is one.
+  auto indexOfAny(Slice set) const noexcept -> Optional<usize> {
+    usize idx = internal::bytes::indexOfAny(this->ptr_, this->len_,
+                                            set.ptr(), set.len());
+    if (idx == this->len_) {
+      return Optional<usize>();
+    }
+    return Optional<usize>(usize(idx));
+  }
+
+  /// Returns the number of `byte`s in the slice.
+  auto count(char byte) const noexcept -> usize {
+    return internal::bytes::count(this->ptr_, this->len_, byte);
+  }
+
+  /// Returns the (possibly empty) views between each `delim`, found lazily.
+  ///
+  /// Like `str::split` in Rust, there is always one more view than there are
+  /// delimiters, so an empty slice is split into one empty view.
+  auto split(char delim) const noexcept -> Split;
+
+  /// Checks if the slice has the same bytes as `other`.
+  auto equals(Slice other) const noexcept -> bool {
+    return (this->len_ == other.len_) &&
+           ((this->len_ == 0) ||
+            (std::memcmp(this->ptr_, other.ptr_, this->len_) == 0));
+  }
+
+  /// Checks if the slice starts with the bytes of `prefix`.
+  auto startsWith(Slice prefix) const noexcept -> bool {
+    return (this->len_ >= prefix.len_) &&
+           ((prefix.len_ == 0) ||
+            (std::memcmp(this->ptr_, prefix.ptr_, prefix.len_) == 0));
+  }
+
   /// Print the slice to `stderr`.
   auto debug() const -> void {
     std::cout << "Slice { ";
@@ -170,9 +350,225 @@ public:
 private:
   cstr ptr_;
   u64  len_ : 56;
-  u8   align_ : 8;
+  u8   align_ : 8; // log2 of the alignment
+};
+
+/// The views returned by `Slice::chunks`.
+template <typename T> class Chunks {
+public:
+  class Iterator {
+  public:
+    auto operator*() const noexcept -> Slice<T> {
+      usize end = this->pos + this->size;
+      end       = (end < this->slice.len()) ? end : this->slice.len();
+      return this->slice.subslice(this->pos, end);
+    }
+
+    auto operator++() noexcept -> Iterator& {
+      usize left  = this->slice.len() - this->pos;
+      this->pos  += (this->size < left) ? this->size : left;
+      return *this;
+    }
+
+    auto operator==(const Iterator& other) const noexcept -> bool {
+      return this->pos == other.pos;
+    }
+
+  private:
+    friend class Chunks;
+
+    explicit Iterator(Slice<T> slice, usize size, usize pos) noexcept
+        : slice{slice}, size{size}, pos{pos} {}
+
+    Slice<T> slice;
+    usize    size;
+    usize    pos;
+  };
+
+  /// Returns the number of chunks.
+  auto len() const noexcept -> usize {
+    return (this->slice.len() + this->size - 1) / this->size;
+  }
+
+  auto begin() const noexcept -> Iterator {
+    return Iterator(this->slice, this->size, 0);
+  }
+  auto end() const noexcept -> Iterator {
+    return Iterator(this->slice, this->size, this->slice.len());
+  }
+
+private:
+  friend class Slice<T>;
+
+  explicit Chunks(Slice<T> slice, usize size) noexcept
+      : slice{slice}, size{size} {
+    assert(size > 0);
+  }
+
+  Slice<T> slice;
+  usize    size;
 };
 
+/// The views returned by `Slice::windows`.
+template <typename T> class Windows {
+public:
+  class Iterator {
+  public:
+    auto operator*() const noexcept -> Slice<T> {
+      return this->slice.subslice(this->pos, this->pos + this->size);
+    }
+
+    auto operator++() noexcept -> Iterator& {
+      this->pos++;
+      return *this;
+    }
+
+    auto operator==(const Iterator& other) const noexcept -> bool {
+      return this->pos == other.pos;
+    }
+
+  private:
+    friend class Windows;
+
+    explicit Iterator(Slice<T> slice, usize size, usize pos) noexcept
+        : slice{slice}, size{size}, pos{pos} {}
+
+    Slice<T> slice;
+    usize    size;
+    usize    pos;
+  };
+
+  /// Returns the number of windows (0 if the slice is shorter than a
+  /// window).
+  auto len() const noexcept -> usize {
+    return (this->slice.len() < this->size)
+               ? 0
+               : this->slice.len() - this->size + 1;
+  }
+
+  auto begin() const noexcept -> Iterator {
+    return Iterator(this->slice, this->size, 0);
+  }
+  auto end() const noexcept -> Iterator {
+    return Iterator(this->slice, this->size, this->len());
+  }
+
+private:
+  friend class Slice<T>;
+
+  explicit Windows(Slice<T> slice, usize size) noexcept
+      : slice{slice}, size{size} {
+    assert(size > 0);
+  }
+
+  Slice<T> slice;
+  usize    size;
+};
+
+/// The views returned by `Slice<u8>::split`.
+class Split {
+public:
+  class Iterator {
+  public:
+    auto operator*() const noexcept -> Slice<u8> { return this->piece; }
+
+    auto operator++() noexcept -> Iterator& {
+      if (this->piece.end() == this->last) {
+        this->done = true;
+      } else {
+        this->find(this->piece.end() + 1);
+      }
+      return *this;
+    }
+
+    auto operator==(const Iterator& other) const noexcept -> bool {
+      if (this->done || other.done) {
+        return this->done == other.done;
+      }
+      return this->piece.ptr() == other.piece.ptr();
+    }
+
+  private:
+    friend class Split;
+
+    explicit Iterator(cstr start, cstr last, char delim, bool done) noexcept
+        : last{last}, delim{delim}, done{done} {
+      if (!done) {
+        this->load(start);
+        this->find(start);
+      }
+    }
+
+    /// Finds the view that starts at `start` (and ends before the next
+    /// delimiter, or at the end).
+    ///
+    /// The delimiters are found 64 bytes at a time: `pending` has a bit set
+    /// for each one in the block at `block` that hasn't been passed yet, so
+    /// short views don't each need a search.
+    auto find(cstr start) noexcept -> void {
+      usize offset = static_cast<usize>(start - this->block);
+      if (offset >= 64) {
+        this->load(start);
+      } else {
+        this->pending &= ~u64(0) << offset;
+      }
+      while (this->pending == 0) {
+        if (this->last - this->block <= 64) {
+          usize len   = static_cast<usize>(this->last - start);
+          this->piece = Slice<u8>(start, len);
+          return;
+        }
+        this->load(this->block + 64);
+      }
+      cstr found  = this->block + std::countr_zero(this->pending);
+      this->piece = Slice<u8>(start, static_cast<usize>(found - start));
+    }
+
+    /// Finds the delimiters in the block at `block`.
+    auto load(cstr block) noexcept -> void {
+      this->block   = block;
+      this->pending = internal::bytes::matchMask(
+          block, static_cast<usize>(this->last - block), this->delim);
+    }
+
+    Slice<u8> piece{};
+    cstr      last;
+    cstr      block   = nullptr;
+    u64       pending = 0;
+    char      delim;
+    bool      done;
+  };
+
+  auto begin() const noexcept -> Iterator {
+    return Iterator(this->slice.begin(), this->slice.end(), this->delim,
+                    false);
+  }
+  auto end() const noexcept -> Iterator {
+    return Iterator(this->slice.end(), this->slice.end(), this->delim, true);
+  }
+
+private:
+  friend class Slice<u8>;
+
+  explicit Split(Slice<u8> slice, char delim) noexcept
+      : slice{slice}, delim{delim} {}
+
+  Slice<u8> slice;
+  char      delim;
+};
+
+inline auto Slice<u8>::split(char delim) const noexcept -> Split {
+  return Split(*this, delim);
+}
+
+inline auto Slice<u8>::chunks(usize size) const noexcept -> Chunks<u8> {
+  return Chunks<u8>(*this, size);
+}
+
+inline auto Slice<u8>::windows(usize size) const noexcept -> Windows<u8> {
+  return Windows<u8>(*this, size);
+}
+
 } // namespace mu
 
 #endif // !MU_SLICE_H
@@ -0,0 +1,319 @@
+#ifndef MU_SLOT_MAP_H
+#define MU_SLOT_MAP_H
+
+#include "mu/common.h"            // IndexOutOfBounds, OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/utils.h"         // TriviallyRelocatable, relocate
+#include "mu/primitives.h"        // usize, u32
+#include "mu/slice.h"             // Slice
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <type_traits>            // is_nothrow_move_constructible_v
+#include <utility>                // forward, move
+
+namespace mu {
+
+/// A container that stores its values contiguously and refers to them through
+/// generation-checked `Key`s.
+///
+/// Inserting and removing are O(1), and iterating only touches the (densely
+/// packed) live values, so this is a cache-friendly replacement for a graph of
+/// individually allocated objects.
+///
+/// ## Note
+/// Removing a value moves the last value into its place, so the order of the
+/// values is not preserved, and pointers into the map are invalidated by any
+/// insertion or removal; keys stay valid until their value is removed.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, class Allocator = mem::CAllocator> class SlotMap {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "`T` must be nothrow move constructible");
+
+  /// Maps a key's index to its value.
+  ///
+  /// Vacant slots have an even generation and occupied slots an odd one.
+  struct Slot {
+    u32 idx; // Index of the value if occupied; next free slot otherwise
+    u32 gen;
+  };
+
+public:
+  /// A handle to a value in a `SlotMap`.
+  ///
+  /// A key only refers to the value it was returned for: once that value is
+  /// removed, the key is stale even if its slot is reused. A default
+  /// constructed key is never valid.
+  struct Key {
+    u32  idx = 0;
+    u32  gen = 0;
+
+    auto operator==(const Key& other) const -> bool = default;
+  };
+
+  SlotMap(const SlotMap&)                    = delete;
+  auto operator=(const SlotMap&) -> SlotMap& = delete;
+
+  /// Creates an empty `SlotMap` that allocates using `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit SlotMap(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator}, slots{nullptr, 0}, vals{nullptr, 0},
+        owners{nullptr, 0} {}
+
+  /// Creates a `SlotMap` by transferring the values from `other`, which is left
+  /// empty.
+  SlotMap(SlotMap&& other) noexcept
+      : allocator{other.allocator}, slots{other.slots}, vals{other.vals},
+        owners{other.owners}, len_{other.len_}, num_slots{other.num_slots},
+        free_head{other.free_head} {
+    other.forget();
+  }
+
+  /// Move assignment operator.
+  auto operator=(SlotMap&& other) noexcept -> SlotMap& {
+    if (this != &other) {
+      this->release();
+      this->allocator = other.allocator;
+      this->slots     = other.slots;
+      this->vals      = other.vals;
+      this->owners    = other.owners;
+      this->len_      = other.len_;
+      this->num_slots = other.num_slots;
+      this->free_head = other.free_head;
+      other.forget();
+    }
+    return *this;
+  }
+
+  ~SlotMap() noexcept { this->release(); }
+
+  /// Inserts `val` into the map and returns its key.
+  auto insert(T val) -> Key { return this->emplace(std::move(val)); }
+
+  /// Constructs a value from `args` in the map and returns its key.
+  template <typename... Args> auto emplace(Args&&... args) -> Key {
+    if (this->free_head == NONE) {
+      this->reserveSlots(this->num_slots + usize(1));
+    }
+    this->reserveValues(this->len_ + usize(1));
+
+    // Construct the value before claiming a slot, in case it throws
+    new (this->vals.ptr() + this->len_) T(std::forward<Args>(args)...);
+
+    u32 idx;
+    if (this->free_head != NONE) {
+      idx             = this->free_head;
+      this->free_head = this->slots.ptr()[idx].idx;
+    } else {
+      idx                        = this->num_slots++;
+      this->slots.ptr()[idx].gen = 0;
+    }
+
+    Slot& slot                      = this->slots.ptr()[idx];
+    slot.idx                        = this->len_;
+    slot.gen                       += 1;
+    this->owners.ptr()[this->len_]  = idx;
+    this->len_++;
+    return Key{idx, slot.gen};
+  }
+
+  /// Removes the value referred to by `key`.
+  ///
+  /// Returns `false` if `key` is stale.
+  auto remove(Key key) noexcept -> bool {
+    if (!this->contains(key)) {
+      return false;
+    }
+
+    Slot& slot   = this->slots.ptr()[key.idx];
+    u32   last   = this->len_ - 1;
+    T*    vals   = this->vals.ptr();
+    u32*  owners = this->owners.ptr();
+    vals[slot.idx].~T();
+    if (slot.idx != last) {
+      // Move the last value into the hole
+      new (vals + slot.idx) T(std::move(vals[last]));
+      vals[last].~T();
+      owners[slot.idx]                    = owners[last];
+      this->slots.ptr()[owners[last]].idx = slot.idx;
+    }
+    this->len_--;
+    this->vacate(key.idx);
+    return true;
+  }
+
+  /// Returns `true` if `key` refers to a value in the map.
+  auto contains(Key key) const noexcept -> bool {
+    return (key.idx < this->num_slots) &&
+           (this->slots.ptr()[key.idx].gen == key.gen) && (key.gen & 1);
+  }
+
+  /// Returns a pointer to the value referred to by `key`, or `nullptr` if
+  /// `key` is stale.
+  auto get(Key key) noexcept -> T* {
+    if (!this->contains(key)) {
+      return nullptr;
+    }
+    return this->vals.ptr() + this->slots.ptr()[key.idx].idx;
+  }
+
+  /// Returns a pointer to the value referred to by `key`, or `nullptr` if
+  /// `key` is stale.
+  auto get(Key key) const noexcept -> const T* {
+    if (!this->contains(key)) {
+      return nullptr;
+    }
+    return this->vals.ptr() + this->slots.ptr()[key.idx].idx;
+  }
+
+  /// Returns the key of the value at index `idx` of `values()`.
+  auto keyAt(usize idx) const -> Key {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    u32 slot = this->owners.ptr()[idx];
+    return Key{slot, this->slots.ptr()[slot].gen};
+  }
+
+  /// Returns the live values, in no particular order.
+  auto values() noexcept -> Slice<T> {
+    return Slice<T>(this->vals.ptr(), this->len_);
+  }
+
+  /// Returns the live values, in no particular order.
+  auto values() const noexcept -> Slice<const T> {
+    return Slice<const T>(this->vals.ptr(), this->len_);
+  }
+
+  auto begin() noexcept -> T* { return this->vals.ptr(); }
+  auto end() noexcept -> T* { return this->vals.ptr() + this->len_; }
+  auto begin() const noexcept -> const T* { return this->vals.ptr(); }
+  auto end() const noexcept -> const T* {
+    return this->vals.ptr() + this->len_;
+  }
+
+  /// Returns the number of values in the map.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Returns the number of values the map can hold without reallocating.
+  auto capacity() const noexcept -> usize { return this->vals.len(); }
+
+  /// Reserves room for at least `capacity` values in total.
+  auto reserve(usize capacity) -> void {
+    this->reserveValues(capacity);
+    this->reserveSlots(capacity);
+  }
+
+  /// Removes all values from the map (keeping its memory).
+  ///
+  /// All keys into the map become stale.
+  auto clear() noexcept -> void {
+    for (u32 i = 0; i < this->len_; i++) {
+      this->vals.ptr()[i].~T();
+      this->vacate(this->owners.ptr()[i]);
+    }
+    this->len_ = 0;
+  }
+
+private:
+  /// Marks the end of the free list.
+  static constexpr u32   NONE         = std::numeric_limits<u32>::max();
+
+  /// Slots whose generation reaches this are retired, so that generations
+  /// never wrap around (which could make a stale key valid again).
+  static constexpr u32   RETIRED_GEN  = std::numeric_limits<u32>::max() - 1;
+
+  /// The maximum number of slots (indices must fit in a `u32`, besides `NONE`).
+  static constexpr usize MAX_SLOTS    = NONE;
+
+  /// The capacity of the first allocation.
+  static constexpr usize MIN_CAPACITY = 8;
+
+  /// Bumps the generation of the (occupied) slot `idx` and adds it to the free
+  /// list.
+  auto vacate(u32 idx) noexcept -> void {
+    Slot& slot  = this->slots.ptr()[idx];
+    slot.gen   += 1;
+    if (slot.gen != RETIRED_GEN) {
+      slot.idx        = this->free_head;
+      this->free_head = idx;
+    }
+  }
+
+  /// Returns the capacity to grow from `capacity` to hold `needed` items.
+  static auto grownCapacity(usize capacity, usize needed) -> usize {
+    if (needed > MAX_SLOTS) {
+      throw common::OutOfMemoryException(needed);
+    }
+    usize grown = (capacity < MIN_CAPACITY) ? MIN_CAPACITY : capacity * 2;
+    grown       = (grown < needed) ? needed : grown;
+    return (grown > MAX_SLOTS) ? MAX_SLOTS : grown;
+  }
+
+  auto reserveSlots(usize needed) -> void {
+    if (needed <= this->slots.len()) {
+      return;
+    }
+    usize capacity = grownCapacity(this->slots.len(), needed);
+    this->slots    = this->allocator.get().realloc(this->slots, capacity);
+  }
+
+  auto reserveValues(usize needed) -> void {
+    if (needed <= this->vals.len()) {
+      return;
+    }
+    auto&& allocator = this->allocator.get();
+    usize  capacity  = grownCapacity(this->vals.len(), needed);
+
+    // `owners` is grown first, so that it never holds less than `vals`
+    this->owners     = allocator.realloc(this->owners, capacity);
+    if constexpr (mem::TriviallyRelocatable<T>) {
+      this->vals = allocator.realloc(this->vals, capacity);
+    } else {
+      Slice<T> moved = allocator.template allocUninit<T>(capacity);
+      mem::relocate(moved.ptr(), this->vals.ptr(), this->len_);
+      allocator.free(this->vals);
+      this->vals = moved;
+    }
+  }
+
+  /// Destroys the values and frees the map's memory.
+  auto release() noexcept -> void {
+    for (u32 i = 0; i < this->len_; i++) {
+      this->vals.ptr()[i].~T();
+    }
+    auto&& allocator = this->allocator.get();
+    allocator.free(this->vals);
+    allocator.free(this->owners);
+    allocator.free(this->slots);
+    this->forget();
+  }
+
+  /// Leaves the map empty without freeing anything.
+  auto forget() noexcept -> void {
+    this->slots     = Slice<Slot>(nullptr, 0);
+    this->vals      = Slice<T>(nullptr, 0);
+    this->owners    = Slice<u32>(nullptr, 0);
+    this->len_      = 0;
+    this->num_slots = 0;
+    this->free_head = NONE;
+  }
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  Slice<Slot>                                        slots;
+  Slice<T>                                           vals;
+
+  /// The slot of each value.
+  Slice<u32>                                         owners;
+  u32                                                len_      = 0;
+  u32                                                num_slots = 0;
+  u32                                                free_head = NONE;
+};
+
+} // namespace mu
+
+#endif // !MU_SLOT_MAP_H
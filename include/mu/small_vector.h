@@ -0,0 +1,254 @@
+#ifndef MU_SMALL_VECTOR_H
+#define MU_SMALL_VECTOR_H
+
+#include "mu/cloneable.h"         // Copyable
+#include "mu/common.h"            // IndexOutOfBounds, OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/utils.h"         // TriviallyRelocatable, relocate
+#include "mu/optional.h"          // Optional
+#include "mu/primitives.h"        // usize, u8
+#include "mu/slice.h"             // Slice
+#include <cstring>                // memcpy
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <type_traits>            // is_nothrow_move_constructible_v
+#include <utility>                // forward, move
+
+namespace mu {
+
+/// A growable list that stores up to `N` items inline, and only allocates
+/// (from `Allocator`) once it grows past that.
+///
+/// ## Note
+/// Since the items may live inside the `SmallVector`, moving it moves the
+/// items, and invalidates pointers to them.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, usize N, class Allocator = mem::CAllocator>
+class SmallVector {
+  static_assert(N > 0, "`N` must be at least 1");
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "`T` must be nothrow move constructible");
+
+public:
+  SmallVector(const SmallVector&)                    = delete;
+  auto operator=(const SmallVector&) -> SmallVector& = delete;
+
+  /// Creates an empty list that spills to `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  explicit SmallVector(Allocator* allocator = nullptr) noexcept
+      : allocator{allocator} {}
+
+  /// Creates a list by transferring the items from `other`, which is left
+  /// empty.
+  SmallVector(SmallVector&& other) noexcept : allocator{other.allocator} {
+    this->take(other);
+  }
+
+  /// Move assignment operator.
+  auto operator=(SmallVector&& other) noexcept -> SmallVector& {
+    if (this != &other) {
+      this->release();
+      this->allocator = other.allocator;
+      this->take(other);
+    }
+    return *this;
+  }
+
+  ~SmallVector() noexcept { this->release(); }
+
+  /// Returns the items in the list.
+  ///
+  /// ## Note
+  /// The slice is invalidated when the list grows or is moved.
+  auto items() noexcept -> Slice<T> {
+    return Slice<T>(this->data(), this->len_);
+  }
+
+  /// Returns the items in the list.
+  auto items() const noexcept -> Slice<const T> {
+    return Slice<const T>(this->data(), this->len_);
+  }
+
+  /// Returns the number of items in the list.
+  auto len() const noexcept -> usize { return this->len_; }
+
+  /// Returns the number of items the list can hold without allocating.
+  auto capacity() const noexcept -> usize { return this->cap; }
+
+  /// Returns `true` if the items are stored inline (nothing is allocated).
+  auto isInline() const noexcept -> bool { return this->heap == nullptr; }
+
+  /// Indexes into the list.
+  auto operator[](usize idx) -> T& {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    return this->data()[idx];
+  }
+
+  /// Indexes into the list.
+  auto operator[](usize idx) const -> const T& {
+    if (idx >= this->len_) {
+      throw common::IndexOutOfBounds(idx, this->len_);
+    }
+    return this->data()[idx];
+  }
+
+  auto begin() noexcept -> T* { return this->data(); }
+  auto end() noexcept -> T* { return this->data() + this->len_; }
+  auto begin() const noexcept -> const T* { return this->data(); }
+  auto end() const noexcept -> const T* { return this->data() + this->len_; }
+
+  /// Makes sure the list can hold at least `capacity` items in total, moving
+  /// them to (a larger) allocation if needed.
+  auto ensureCapacity(usize capacity) -> void {
+    if (capacity <= this->cap) {
+      return;
+    }
+    if (capacity > std::numeric_limits<usize>::max() / (2 * sizeof(T))) {
+      throw common::OutOfMemoryException(capacity);
+    }
+
+    usize grown = this->cap * 2;
+    this->grow((grown < capacity) ? capacity : grown);
+  }
+
+  /// Appends `val` to the end of the list.
+  auto append(T val) -> void { this->emplace(std::move(val)); }
+
+  /// Constructs an item from `args` at the end of the list, and returns it.
+  template <typename... Args> auto emplace(Args&&... args) -> T& {
+    if (this->len_ == this->cap) {
+      this->ensureCapacity(this->len_ + 1);
+    }
+    T* item = this->data() + this->len_;
+    new (item) T(std::forward<Args>(args)...);
+    this->len_++;
+    return *item;
+  }
+
+  /// Appends copies of `items` to the end of the list.
+  ///
+  /// ## Note
+  /// `items` must not point into the list.
+  auto appendSlice(Slice<T> items) -> void {
+    // `Slice<u8>::ptr` returns a `cstr`
+    const T* src = reinterpret_cast<const T*>(items.ptr());
+    this->ensureCapacity(this->len_ + items.len());
+    T* dst = this->data() + this->len_;
+    if constexpr (Copyable<T>) {
+      if (items.len() != 0) {
+        std::memcpy(dst, src, sizeof(T) * items.len());
+      }
+      this->len_ += items.len();
+    } else {
+      for (usize i = 0; i < items.len(); i++) {
+        new (dst + i) T(src[i]);
+        this->len_++;
+      }
+    }
+  }
+
+  /// Removes and returns the last item, if there is one.
+  auto pop() -> Optional<T> {
+    if (this->len_ == 0) {
+      return Optional<T>();
+    }
+    this->len_--;
+    T* last = this->data() + this->len_;
+    T  res  = std::move(*last);
+    last->~T();
+    return Optional<T>(std::move(res));
+  }
+
+  /// Removes all items from the list (keeping its memory).
+  auto clear() noexcept -> void {
+    this->destroyItems();
+    this->len_ = 0;
+  }
+
+private:
+  /// Returns a pointer to the items (inline or allocated).
+  auto data() noexcept -> T* {
+    return (this->heap != nullptr) ? this->heap
+                                   : reinterpret_cast<T*>(this->inline_buf);
+  }
+
+  auto data() const noexcept -> const T* {
+    return (this->heap != nullptr)
+               ? this->heap
+               : reinterpret_cast<const T*>(this->inline_buf);
+  }
+
+  /// Moves the items to an allocation of `capacity` items.
+  auto grow(usize capacity) -> void {
+    auto&& allocator = this->allocator.get();
+    if constexpr (mem::TriviallyRelocatable<T>) {
+      if (this->heap != nullptr) {
+        Slice<T> old(this->heap, this->cap);
+        this->heap = allocator.realloc(old, capacity).ptr();
+        this->cap  = capacity;
+        return;
+      }
+    }
+
+    Slice<T> moved = allocator.template allocUninit<T>(capacity);
+    mem::relocate(moved.ptr(), this->data(), this->len_);
+    if (this->heap != nullptr) {
+      allocator.free(Slice<T>(this->heap, this->cap));
+    }
+    this->heap = moved.ptr();
+    this->cap  = capacity;
+  }
+
+  /// Moves the items of `other` (which is left empty) into `this`, which must
+  /// be empty.
+  auto take(SmallVector& other) noexcept -> void {
+    if (other.heap != nullptr) {
+      this->heap = other.heap;
+      this->cap  = other.cap;
+    } else {
+      mem::relocate(reinterpret_cast<T*>(this->inline_buf),
+                    reinterpret_cast<T*>(other.inline_buf), other.len_);
+    }
+    this->len_ = other.len_;
+    other.heap = nullptr;
+    other.len_ = 0;
+    other.cap  = N;
+  }
+
+  auto destroyItems() noexcept -> void {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      T* items = this->data();
+      for (usize i = 0; i < this->len_; i++) {
+        items[i].~T();
+      }
+    }
+  }
+
+  /// Destroys the items and frees the allocation (if any).
+  auto release() noexcept -> void {
+    this->destroyItems();
+    if (this->heap != nullptr) {
+      this->allocator.get().free(Slice<T>(this->heap, this->cap));
+    }
+    this->heap = nullptr;
+    this->len_ = 0;
+    this->cap  = N;
+  }
+
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  T*                                                 heap = nullptr;
+  usize                                              len_ = 0;
+  usize                                              cap  = N;
+  alignas(T) u8                                      inline_buf[sizeof(T) * N];
+};
+
+} // namespace mu
+
+#endif // !MU_SMALL_VECTOR_H
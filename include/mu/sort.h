@@ -0,0 +1,714 @@
+#ifndef MU_SORT_H
+#define MU_SORT_H
+
+#include "mu/array_list.h"        // ArrayList
+#include "mu/common.h"            // OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/optional.h"          // Optional
+#include "mu/primitives.h"        // usize, u8, u32, u64
+#include "mu/slice.h"             // Slice
+#include <algorithm>              // iter_swap, make_heap, sort_heap, max
+#include <bit>                    // bit_cast, bit_width
+#include <concepts>               // integral, floating_point, same_as
+#include <condition_variable>     // condition_variable
+#include <cstring>                // memcpy
+#include <functional>             // less, greater
+#include <mutex>                  // mutex, unique_lock, lock_guard
+#include <system_error>           // system_error
+#include <thread>                 // thread, hardware_concurrency
+#include <type_traits>            // is_arithmetic_v, is_same_v, ...
+#include <utility>                // move, swap, pair, index_sequence
+
+namespace mu {
+
+namespace internal::sort {
+/// Ranges shorter than this are insertion sorted.
+inline constexpr usize INSERTION_SORT_THRESHOLD = 24;
+
+/// Ranges longer than this use the pseudomedian of 9 as the pivot (instead of
+/// the median of 3).
+inline constexpr usize NINTHER_THRESHOLD = 128;
+
+/// The number of moves after which `partialInsertionSort` gives up.
+inline constexpr usize PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+/// The number of items the branchless partition classifies at a time.
+inline constexpr usize BLOCK_SIZE = 64;
+
+/// Determines if comparing two items is cheap enough (and free of branches)
+/// that partitioning should classify whole blocks before swapping anything.
+template <typename T, typename Less>
+inline constexpr bool IS_BRANCHLESS =
+    std::is_arithmetic_v<T> && (std::is_same_v<Less, std::less<T>> ||
+                                std::is_same_v<Less, std::greater<T>>);
+
+/// Sorts `[begin, end)` with an insertion sort.
+template <typename T, typename Less>
+auto insertionSort(T* begin, T* end, Less& less) -> void {
+  if (begin == end) {
+    return;
+  }
+  for (T* cur = begin + 1; cur != end; cur++) {
+    T* sift   = cur;
+    T* sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      T tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while ((sift != begin) && less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+/// Sorts `[begin, end)` with an insertion sort, where `begin[-1]` must not be
+/// greater than any item in the range (so it stops the sifts).
+template <typename T, typename Less>
+auto unguardedInsertionSort(T* begin, T* end, Less& less) -> void {
+  if (begin == end) {
+    return;
+  }
+  for (T* cur = begin + 1; cur != end; cur++) {
+    T* sift   = cur;
+    T* sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      T tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while (less(tmp, *--sift_1));
+      *sift = std::move(tmp);
+    }
+  }
+}
+
+/// Tries to sort `[begin, end)` with an insertion sort, giving up (and
+/// returning `false`) once more than `PARTIAL_INSERTION_SORT_LIMIT` items
+/// have been moved.
+template <typename T, typename Less>
+auto partialInsertionSort(T* begin, T* end, Less& less) -> bool {
+  if (begin == end) {
+    return true;
+  }
+  usize moves = 0;
+  for (T* cur = begin + 1; cur != end; cur++) {
+    T* sift   = cur;
+    T* sift_1 = cur - 1;
+    if (less(*sift, *sift_1)) {
+      T tmp = std::move(*sift);
+      do {
+        *sift-- = std::move(*sift_1);
+      } while ((sift != begin) && less(tmp, *--sift_1));
+      *sift  = std::move(tmp);
+      moves += static_cast<usize>(cur - sift);
+    }
+    if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T, typename Less>
+auto sort2(T* a, T* b, Less& less) -> void {
+  if (less(*b, *a)) {
+    std::iter_swap(a, b);
+  }
+}
+
+template <typename T, typename Less>
+auto sort3(T* a, T* b, T* c, Less& less) -> void {
+  sort2(a, b, less);
+  sort2(b, c, less);
+  sort2(a, b, less);
+}
+
+/// Moves the pivot of `[begin, end)` to `*begin`: the median of 3 items, or
+/// the pseudomedian of 9 for long ranges.
+template <typename T, typename Less>
+auto choosePivot(T* begin, T* end, Less& less) -> void {
+  usize len  = static_cast<usize>(end - begin);
+  usize half = len / 2;
+  if (len > NINTHER_THRESHOLD) {
+    sort3(begin, begin + half, end - 1, less);
+    sort3(begin + 1, begin + (half - 1), end - 2, less);
+    sort3(begin + 2, begin + (half + 1), end - 3, less);
+    sort3(begin + (half - 1), begin + half, begin + (half + 1), less);
+    std::iter_swap(begin, begin + half);
+  } else {
+    sort3(begin + half, begin, end - 1, less);
+  }
+}
+
+/// Partitions `[begin, end)` around the pivot `*begin`, putting the items
+/// equal to it on the right.
+///
+/// Returns the final position of the pivot, and whether the range was
+/// already partitioned.
+template <typename T, typename Less>
+auto partitionRight(T* begin, T* end, Less& less) -> std::pair<T*, bool> {
+  T  pivot = std::move(*begin);
+  T* first = begin;
+  T* last  = end;
+
+  // The pivot is a median, so neither of these can run off the range (unless
+  // nothing was found on the left)
+  while (less(*++first, pivot)) {
+  }
+  if (first - 1 == begin) {
+    while ((first < last) && !less(*--last, pivot)) {
+    }
+  } else {
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  bool already_partitioned = first >= last;
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (less(*++first, pivot)) {
+    }
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  T* pivot_pos = first - 1;
+  *begin       = std::move(*pivot_pos);
+  *pivot_pos   = std::move(pivot);
+  return {pivot_pos, already_partitioned};
+}
+
+/// Swaps the misplaced items found by `partitionRightBranchless`: the ones at
+/// `first + offsets_l[i]` with the ones at `last - offsets_r[i]`.
+template <typename T>
+auto swapOffsets(T* first, T* last, const u8* offsets_l, const u8* offsets_r,
+                 usize num, bool use_swaps) -> void {
+  if (use_swaps) {
+    // The counts were equal, so this keeps the blocks balanced
+    for (usize i = 0; i < num; i++) {
+      std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+    }
+  } else if (num > 0) {
+    // A cyclic permutation needs only one temporary
+    T* l   = first + offsets_l[0];
+    T* r   = last - offsets_r[0];
+    T  tmp = std::move(*l);
+    *l     = std::move(*r);
+    for (usize i = 1; i < num; i++) {
+      l  = first + offsets_l[i];
+      *r = std::move(*l);
+      r  = last - offsets_r[i];
+      *l = std::move(*r);
+    }
+    *r = std::move(tmp);
+  }
+}
+
+/// `partitionRight`, which first classifies blocks of items on both sides
+/// without branching on the comparisons, and then swaps the misplaced ones
+/// (from "BlockQuicksort: How Branch Mispredictions don't affect Quicksort").
+template <typename T, typename Less>
+auto partitionRightBranchless(T* begin, T* end,
+                              Less& less) -> std::pair<T*, bool> {
+  T  pivot = std::move(*begin);
+  T* first = begin;
+  T* last  = end;
+
+  while (less(*++first, pivot)) {
+  }
+  if (first - 1 == begin) {
+    while ((first < last) && !less(*--last, pivot)) {
+    }
+  } else {
+    while (!less(*--last, pivot)) {
+    }
+  }
+
+  bool already_partitioned = first >= last;
+  if (!already_partitioned) {
+    std::iter_swap(first, last);
+    first++;
+
+    alignas(64) u8 offsets_l[BLOCK_SIZE];
+    alignas(64) u8 offsets_r[BLOCK_SIZE];
+    T*             offsets_l_base = first;
+    T*             offsets_r_base = last;
+    usize          num_l          = 0;
+    usize          num_r          = 0;
+    usize          start_l        = 0;
+    usize          start_r        = 0;
+    while (first < last) {
+      // Only refill the side(s) whose misplaced items have all been swapped
+      usize num_unknown = static_cast<usize>(last - first);
+      usize left_split =
+          (num_l == 0) ? ((num_r == 0) ? num_unknown / 2 : num_unknown) : 0;
+      usize right_split = (num_r == 0) ? (num_unknown - left_split) : 0;
+
+      if (left_split >= BLOCK_SIZE) {
+        left_split = BLOCK_SIZE;
+      }
+      for (usize i = 0; i < left_split; i++) {
+        offsets_l[num_l]  = static_cast<u8>(i);
+        num_l            += !less(*first, pivot);
+        first++;
+      }
+      if (right_split >= BLOCK_SIZE) {
+        right_split = BLOCK_SIZE;
+      }
+      for (usize i = 0; i < right_split; i++) {
+        offsets_r[num_r]  = static_cast<u8>(i + 1);
+        num_r            += less(*--last, pivot);
+      }
+
+      usize num = std::min(num_l, num_r);
+      swapOffsets(offsets_l_base, offsets_r_base, offsets_l + start_l,
+                  offsets_r + start_r, num, num_l == num_r);
+      num_l   -= num;
+      num_r   -= num;
+      start_l += num;
+      start_r += num;
+      if (num_l == 0) {
+        start_l        = 0;
+        offsets_l_base = first;
+      }
+      if (num_r == 0) {
+        start_r        = 0;
+        offsets_r_base = last;
+      }
+    }
+
+    // At most one side has misplaced items left; move them to the middle
+    if (num_l != 0) {
+      while (num_l-- != 0) {
+        std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+      }
+      first = last;
+    }
+    if (num_r != 0) {
+      while (num_r-- != 0) {
+        std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+        first++;
+      }
+      last = first;
+    }
+  }
+
+  T* pivot_pos = first - 1;
+  *begin       = std::move(*pivot_pos);
+  *pivot_pos   = std::move(pivot);
+  return {pivot_pos, already_partitioned};
+}
+
+/// Partitions `[begin, end)` around the pivot `*begin`, putting the items
+/// equal to it on the left.
+///
+/// Returns the final position of the pivot.
+template <typename T, typename Less>
+auto partitionLeft(T* begin, T* end, Less& less) -> T* {
+  T  pivot = std::move(*begin);
+  T* first = begin;
+  T* last  = end;
+
+  while (less(pivot, *--last)) {
+  }
+  if (last + 1 == end) {
+    while ((first < last) && !less(pivot, *++first)) {
+    }
+  } else {
+    while (!less(pivot, *++first)) {
+    }
+  }
+
+  while (first < last) {
+    std::iter_swap(first, last);
+    while (less(pivot, *--last)) {
+    }
+    while (!less(pivot, *++first)) {
+    }
+  }
+
+  T* pivot_pos = last;
+  *begin       = std::move(*pivot_pos);
+  *pivot_pos   = std::move(pivot);
+  return pivot_pos;
+}
+
+/// Partitions `[begin, end)` around `*begin`, with the best scheme for `T`.
+template <typename T, typename Less>
+auto partition(T* begin, T* end, Less& less) -> std::pair<T*, bool> {
+  if constexpr (IS_BRANCHLESS<T, Less>) {
+    return partitionRightBranchless(begin, end, less);
+  } else {
+    return partitionRight(begin, end, less);
+  }
+}
+
+/// Swaps a few items of `[begin, end)` around, to break up the patterns that
+/// caused an unbalanced partition.
+template <typename T> auto breakPatterns(T* begin, T* end) -> void {
+  usize len = static_cast<usize>(end - begin);
+  if (len >= INSERTION_SORT_THRESHOLD) {
+    usize quarter = len / 4;
+    std::iter_swap(begin, begin + quarter);
+    std::iter_swap(end - 1, end - quarter);
+    if (len > NINTHER_THRESHOLD) {
+      std::iter_swap(begin + 1, begin + (quarter + 1));
+      std::iter_swap(begin + 2, begin + (quarter + 2));
+      std::iter_swap(end - 2, end - (quarter + 1));
+      std::iter_swap(end - 3, end - (quarter + 2));
+    }
+  }
+}
+
+/// Returns the number of unbalanced partitions `pdqSort` allows for `len`
+/// items, before it falls back to heapsort.
+inline auto badPartitionLimit(usize len) noexcept -> usize {
+  return static_cast<usize>(std::bit_width(len));
+}
+
+/// Sorts `[begin, end)` with a pattern-defeating quicksort.
+///
+/// `leftmost` is `false` if `begin[-1]` is an item that is not greater than
+/// any item in the range (the pivot of an enclosing partition).
+template <typename T, typename Less>
+auto pdqSort(T* begin, T* end, Less& less, usize bad_allowed,
+             bool leftmost) -> void {
+  for (;;) {
+    usize len = static_cast<usize>(end - begin);
+    if (len < INSERTION_SORT_THRESHOLD) {
+      if (leftmost) {
+        insertionSort(begin, end, less);
+      } else {
+        unguardedInsertionSort(begin, end, less);
+      }
+      return;
+    }
+
+    choosePivot(begin, end, less);
+
+    // If the pivot equals the enclosing pivot, it is the smallest item, so
+    // put all the items equal to it on the left (they are already sorted)
+    if (!leftmost && !less(begin[-1], *begin)) {
+      begin = partitionLeft(begin, end, less) + 1;
+      continue;
+    }
+
+    auto [pivot, already_partitioned] = partition(begin, end, less);
+    usize left_len  = static_cast<usize>(pivot - begin);
+    usize right_len = static_cast<usize>(end - (pivot + 1));
+    if ((left_len < len / 8) || (right_len < len / 8)) {
+      if (--bad_allowed == 0) {
+        std::make_heap(begin, end, less);
+        std::sort_heap(begin, end, less);
+        return;
+      }
+      breakPatterns(begin, pivot);
+      breakPatterns(pivot + 1, end);
+    } else if (already_partitioned &&
+               partialInsertionSort(begin, pivot, less) &&
+               partialInsertionSort(pivot + 1, end, less)) {
+      // The range was (nearly) sorted already
+      return;
+    }
+
+    pdqSort(begin, pivot, less, bad_allowed, leftmost);
+    begin    = pivot + 1;
+    leftmost = false;
+  }
+}
+
+/// Ranges shorter than this are sorted with `pdqSort` instead of `radixSort`
+/// (which has to clear and scan its histograms whatever the length).
+inline constexpr usize RADIX_SORT_THRESHOLD = 256;
+
+/// Maps `val` to an unsigned integer with the same order.
+///
+/// Signed integers have their sign bit flipped; floats also have all other
+/// bits flipped if they are negative (so `-0.0` comes before `0.0`, and
+/// negative NaNs before everything else).
+template <typename T> constexpr auto radixKey(T val) noexcept {
+  if constexpr (std::floating_point<T>) {
+    using U            = std::conditional_t<sizeof(T) == 4, u32, u64>;
+    constexpr U SIGN   = U(1) << (sizeof(U) * 8 - 1);
+    U           bits   = std::bit_cast<U>(val);
+    U           negate = U(0) - (bits >> (sizeof(U) * 8 - 1));
+    return static_cast<U>(bits ^ (negate | SIGN));
+  } else if constexpr (std::is_signed_v<T>) {
+    using U          = std::make_unsigned_t<T>;
+    constexpr U SIGN = static_cast<U>(U(1) << (sizeof(U) * 8 - 1));
+    return static_cast<U>(static_cast<U>(val) ^ SIGN);
+  } else {
+    return val;
+  }
+}
+
+/// Sorts `items[0..len]` with a least significant digit radix sort (one byte
+/// per pass), using `scratch[0..len]` as the other buffer.
+///
+/// Passes where every key has the same digit are skipped.
+template <typename T>
+auto radixSort(T* items, T* scratch, usize len) noexcept -> void {
+  constexpr usize DIGITS = sizeof(T);
+
+  // The histograms for every pass, counted in one read of the items (with
+  // the digits unrolled, since shifting by a variable amount is slow)
+  usize counts[DIGITS][256] = {};
+  for (usize i = 0; i < len; i++) {
+    auto key = radixKey(items[i]);
+    [&]<usize... D>(std::index_sequence<D...>) {
+      ((counts[D][(key >> (8 * D)) & 0xff]++), ...);
+    }(std::make_index_sequence<DIGITS>());
+  }
+
+  T*   src   = items;
+  T*   dst   = scratch;
+  auto first = radixKey(items[0]);
+  for (usize d = 0; d < DIGITS; d++) {
+    usize* count = counts[d];
+    if (count[(first >> (8 * d)) & 0xff] == len) {
+      continue;
+    }
+
+    usize offset = 0;
+    for (usize digit = 0; digit < 256; digit++) {
+      usize num     = count[digit];
+      count[digit]  = offset;
+      offset       += num;
+    }
+    for (usize i = 0; i < len; i++) {
+      T val                                            = src[i];
+      dst[count[(radixKey(val) >> (8 * d)) & 0xff]++] = val;
+    }
+    std::swap(src, dst);
+  }
+
+  if (src != items) {
+    std::memcpy(static_cast<void*>(items), static_cast<const void*>(src),
+                sizeof(T) * len);
+  }
+}
+
+/// Slices shorter than this are sorted on the calling thread by
+/// `parallelSort`.
+inline constexpr usize PARALLEL_SORT_THRESHOLD = usize(1) << 16;
+
+/// The number of tasks `parallelSort` splits the items into per thread, so
+/// that threads which finish early can take over some of the work.
+inline constexpr usize TASKS_PER_THREAD = 8;
+
+/// Sorts a range with a fixed set of threads, which take ranges from a shared
+/// stack, partition them, and push the right parts back until the ranges are
+/// short enough to sort with `pdqSort`.
+template <typename T, typename Less> class ParallelSorter {
+  /// A range to sort.
+  struct Task {
+    T*   begin;
+    T*   end;
+    bool leftmost;
+  };
+
+public:
+  ParallelSorter(T* begin, T* end, usize threads, const Less& less)
+      : less{less}, cutoff{std::max(static_cast<usize>(end - begin) /
+                                        (threads * TASKS_PER_THREAD),
+                                    INSERTION_SORT_THRESHOLD)} {
+    // Every task on the stack is a disjoint range longer than `cutoff`, so
+    // pushing never allocates (and never throws) once the threads run
+    this->tasks.ensureCapacity(static_cast<usize>(end - begin) / this->cutoff +
+                               1);
+    this->tasks.append(Task{begin, end, true});
+  }
+
+  /// Sorts the range with `threads` threads (including the calling one), and
+  /// waits for them to finish.
+  auto run(usize threads) -> void {
+    ArrayList<std::thread> workers{};
+    workers.ensureCapacity(threads - 1);
+    for (usize i = 1; i < threads; i++) {
+      try {
+        workers.append(std::thread([this] { this->work(); }));
+      } catch (const std::system_error&) {
+        break; // Make do with the threads that did start
+      }
+    }
+    this->work();
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+  }
+
+private:
+  Less                    less;
+  usize                   cutoff;
+  std::mutex              mutex{};
+  std::condition_variable ready{};
+  ArrayList<Task>         tasks{};
+  usize                   active = 0;
+
+  /// Runs tasks until the stack is empty and no thread is running a task
+  /// (that could push more).
+  auto work() -> void {
+    std::unique_lock<std::mutex> lock{this->mutex};
+    for (;;) {
+      this->ready.wait(lock, [this] {
+        return (this->tasks.len() != 0) || (this->active == 0);
+      });
+      Optional<Task> task = this->tasks.pop();
+      if (!task.isValid()) {
+        return;
+      }
+      this->active++;
+      lock.unlock();
+
+      this->process(task.unwrap());
+
+      lock.lock();
+      this->active--;
+      if ((this->active == 0) && (this->tasks.len() == 0)) {
+        this->ready.notify_all();
+      }
+    }
+  }
+
+  auto push(Task task) -> void {
+    {
+      std::lock_guard<std::mutex> lock{this->mutex};
+      this->tasks.append(task);
+    }
+    this->ready.notify_one();
+  }
+
+  /// Splits off the right parts of `task` (as new tasks) until it is short
+  /// enough to sort here.
+  auto process(Task task) -> void {
+    Less  less     = this->less;
+    T*    begin    = task.begin;
+    T*    end      = task.end;
+    bool  leftmost = task.leftmost;
+    usize len      = static_cast<usize>(end - begin);
+    while (len > this->cutoff) {
+      choosePivot(begin, end, less);
+      if (!leftmost && !less(begin[-1], *begin)) {
+        begin = partitionLeft(begin, end, less) + 1;
+        len   = static_cast<usize>(end - begin);
+        continue;
+      }
+
+      T*    pivot     = partition(begin, end, less).first;
+      usize left_len  = static_cast<usize>(pivot - begin);
+      usize right_len = static_cast<usize>(end - (pivot + 1));
+      if ((left_len < len / 8) || (right_len < len / 8)) {
+        // Leave awkward inputs to `pdqSort`, which can fall back to heapsort
+        pdqSort(begin, pivot, less, badPartitionLimit(left_len), leftmost);
+        begin    = pivot + 1;
+        leftmost = false;
+        break;
+      }
+
+      if (right_len > this->cutoff) {
+        this->push(Task{pivot + 1, end, false});
+      } else {
+        pdqSort(pivot + 1, end, less, badPartitionLimit(right_len), false);
+      }
+      end = pivot;
+      len = left_len;
+    }
+    pdqSort(begin, end, less,
+            badPartitionLimit(static_cast<usize>(end - begin)), leftmost);
+  }
+};
+} // namespace internal::sort
+
+/// Sorts `items` in place, so that `less(items[j], items[i])` is `false` for
+/// all `i < j`.
+///
+/// This is a pattern-defeating quicksort: it takes `O(n log n)` time in the
+/// worst case (falling back to heapsort after too many unbalanced
+/// partitions), and linear time for inputs that are already sorted. Arithmetic
+/// items compared with `std::less`/`std::greater` are partitioned branchlessly.
+///
+/// ## Note
+/// The sort is not stable, and `less` must be a strict weak ordering.
+template <typename T, typename Less = std::less<T>>
+auto sort(Slice<T> items, Less less = Less()) -> void {
+  T* begin = reinterpret_cast<T*>(items.ptr());
+  internal::sort::pdqSort(begin, begin + items.len(), less,
+                          internal::sort::badPartitionLimit(items.len()),
+                          true);
+}
+
+/// The item types `radixSort` can sort: integers and floats (but not `bool`).
+template <typename T>
+concept RadixSortable =
+    (std::integral<T> && !std::same_as<T, bool>) ||
+    (std::floating_point<T> && ((sizeof(T) == 4) || (sizeof(T) == 8)));
+
+/// Sorts `items` in ascending order with a least significant digit radix sort,
+/// using a scratch buffer of `items.len()` items from `allocator`.
+///
+/// This takes `O(n)` time, with one pass over the items per byte of `T`
+/// (skipping bytes that are the same in every item), so it is usually faster
+/// than `sort` for keys with only a few significant bytes.
+///
+/// ## Note
+/// Floats are ordered by their bits: `-0.0` comes before `0.0`, and NaNs come
+/// first or last depending on their sign bit.
+///
+/// `allocator` is ignored (and may be `nullptr`) for static allocators.
+template <RadixSortable T, class Allocator = mem::CAllocator>
+auto radixSort(Slice<T> items, Allocator* allocator = nullptr) -> void {
+  if (items.len() < internal::sort::RADIX_SORT_THRESHOLD) {
+    sort(items);
+    return;
+  }
+
+  // `Slice<u8>` hands out `char*`, which is signed on x86: the keys must be
+  // read as `T`
+  T*                           ptr       = reinterpret_cast<T*>(items.ptr());
+  usize                        byte_size = sizeof(T) * items.len();
+  mem::AllocatorRef<Allocator> ref{allocator};
+  void* scratch = ref.get().rawAlloc(byte_size, alignof(T));
+  if (scratch == nullptr) {
+    throw common::OutOfMemoryException(byte_size);
+  }
+  internal::sort::radixSort(ptr, static_cast<T*>(scratch), items.len());
+  ref.get().rawFree(scratch, byte_size, alignof(T));
+}
+
+/// Sorts `items` in place like `sort`, splitting the work across `threads`
+/// threads (including the calling one), or one per hardware thread if
+/// `threads` is 0.
+///
+/// The threads share a stack of ranges: each one takes a range, partitions
+/// it, and pushes the right part back for any idle thread, until the ranges
+/// are short enough to sort on their own.
+///
+/// ## Note
+/// The threads are started and joined on every call, so slices shorter than
+/// `internal::sort::PARALLEL_SORT_THRESHOLD` are sorted on the calling thread.
+///
+/// `less` is called from several threads at once (on copies), and must not
+/// throw.
+template <typename T, typename Less = std::less<T>>
+auto parallelSort(Slice<T> items, usize threads = 0,
+                  Less less = Less()) -> void {
+  if (threads == 0) {
+    threads = std::max(usize(std::thread::hardware_concurrency()), usize(1));
+  }
+  if ((threads == 1) ||
+      (items.len() < internal::sort::PARALLEL_SORT_THRESHOLD)) {
+    sort(items, std::move(less));
+    return;
+  }
+
+  T*                                      begin =
+      reinterpret_cast<T*>(items.ptr());
+  internal::sort::ParallelSorter<T, Less> sorter{
+      begin, begin + items.len(), threads, less};
+  sorter.run(threads);
+}
+
+} // namespace mu
+
+#endif // !MU_SORT_H
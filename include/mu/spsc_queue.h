@@ -0,0 +1,207 @@
+#ifndef MU_SPSC_QUEUE_H
+#define MU_SPSC_QUEUE_H
+
+#include "mu/common.h"            // OutOfMemoryException
+#include "mu/mem/allocator.h"     // Allocator
+#include "mu/mem/allocator_ref.h" // AllocatorRef
+#include "mu/mem/c_allocator.h"   // CAllocator
+#include "mu/mem/utils.h"         // CACHE_LINE_SIZE
+#include "mu/primitives.h"        // usize
+#include "mu/slice.h"             // Slice
+#include <atomic>                 // atomic, memory_order
+#include <bit>                    // bit_ceil
+#include <limits>                 // numeric_limits
+#include <new>                    // placement new
+#include <type_traits>            // is_nothrow_move_constructible_v
+#include <utility>                // move
+
+namespace mu {
+
+/// A bounded, lock-free queue for passing items from one thread (the
+/// producer) to another (the consumer).
+///
+/// The producer and consumer each own one index, on its own cache line, and
+/// keep a cached copy of the other's, so they only touch each other's cache
+/// line when the queue looks full (or empty).
+///
+/// ## Note
+/// Only one thread may push and only one thread may pop at a time.
+///
+/// If `Allocator` is a `mem::StaticAllocator`, no allocator pointer is stored.
+template <typename T, class Allocator = mem::CAllocator> class SpscQueue {
+  static_assert(std::is_nothrow_move_constructible_v<T>,
+                "`T` must be nothrow move constructible");
+
+public:
+  SpscQueue(const SpscQueue&)                    = delete;
+  SpscQueue(SpscQueue&&)                         = delete;
+  auto operator=(const SpscQueue&) -> SpscQueue& = delete;
+  auto operator=(SpscQueue&&) -> SpscQueue&      = delete;
+
+  /// Creates an empty queue that can hold at least `capacity` items (rounded
+  /// up to a power of 2), allocated from `allocator`.
+  ///
+  /// ## Note
+  /// `allocator` is ignored (and may be `nullptr`) for static allocators.
+  SpscQueue(Allocator* allocator, usize capacity)
+      : allocator{allocator}, cap{roundCapacity(capacity)}, mask{cap - 1} {
+    usize size = sizeof(T) * this->cap;
+    this->slots =
+        static_cast<T*>(this->allocator.get().rawAlloc(size, SLOTS_ALIGN));
+    if (this->slots == nullptr) {
+      throw common::OutOfMemoryException(size);
+    }
+  }
+
+  ~SpscQueue() noexcept {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      usize tail = this->tail.load(std::memory_order_relaxed);
+      for (usize i = this->head.load(std::memory_order_relaxed); i != tail;
+           i++) {
+        this->slots[i & this->mask].~T();
+      }
+    }
+    this->allocator.get().rawFree(this->slots, sizeof(T) * this->cap,
+                                  SLOTS_ALIGN);
+  }
+
+  /// Returns the number of items the queue can hold.
+  auto capacity() const noexcept -> usize { return this->cap; }
+
+  /// Returns the number of items in the queue.
+  ///
+  /// ## Note
+  /// This is only a snapshot if the other thread uses the queue concurrently.
+  auto len() const noexcept -> usize {
+    return this->tail.load(std::memory_order_acquire) -
+           this->head.load(std::memory_order_acquire);
+  }
+
+  /// Pushes `val` to the back of the queue (producer only).
+  ///
+  /// Returns `false` (leaving `val` untouched) if the queue is full.
+  auto tryPush(T&& val) noexcept -> bool {
+    usize tail = this->tail.load(std::memory_order_relaxed);
+    if (this->freeSlots(tail, 1) == 0) {
+      return false;
+    }
+    new (this->slots + (tail & this->mask)) T(std::move(val));
+    this->tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Pushes a copy of `val` to the back of the queue (producer only).
+  ///
+  /// Returns `false` if the queue is full.
+  auto tryPush(const T& val) -> bool {
+    T copy = val;
+    return this->tryPush(std::move(copy));
+  }
+
+  /// Pops the item at the front of the queue into `out` (consumer only).
+  ///
+  /// Returns `false` (leaving `out` untouched) if the queue is empty.
+  auto tryPop(T& out) -> bool {
+    usize head = this->head.load(std::memory_order_relaxed);
+    if (this->usedSlots(head, 1) == 0) {
+      return false;
+    }
+    T* slot = this->slots + (head & this->mask);
+    out     = std::move(*slot);
+    slot->~T();
+    this->head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Moves as many of `items` as fit to the back of the queue, in order
+  /// (producer only).
+  ///
+  /// Returns the number of items pushed: `items[0..n]` are moved from, and
+  /// the rest are left untouched. The items are published all at once.
+  auto pushMany(Slice<T> items) noexcept -> usize {
+    // `Slice<u8>::ptr` returns a `cstr`
+    T*    src  = reinterpret_cast<T*>(items.ptr());
+    usize tail = this->tail.load(std::memory_order_relaxed);
+    usize n    = this->freeSlots(tail, items.len());
+    for (usize i = 0; i < n; i++) {
+      new (this->slots + ((tail + i) & this->mask)) T(std::move(src[i]));
+    }
+    if (n != 0) {
+      this->tail.store(tail + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+  /// Pops up to `out.len()` items from the front of the queue into `out`, in
+  /// order (consumer only).
+  ///
+  /// Returns the number of items popped into `out[0..n]`.
+  auto popMany(Slice<T> out) -> usize {
+    T*    dst  = reinterpret_cast<T*>(out.ptr());
+    usize head = this->head.load(std::memory_order_relaxed);
+    usize n    = this->usedSlots(head, out.len());
+    for (usize i = 0; i < n; i++) {
+      T* slot = this->slots + ((head + i) & this->mask);
+      dst[i]  = std::move(*slot);
+      slot->~T();
+    }
+    if (n != 0) {
+      this->head.store(head + n, std::memory_order_release);
+    }
+    return n;
+  }
+
+private:
+  /// The alignment of the slots (at least a cache line).
+  static constexpr usize SLOTS_ALIGN = (alignof(T) > mem::CACHE_LINE_SIZE)
+                                           ? alignof(T)
+                                           : mem::CACHE_LINE_SIZE;
+
+  /// Rounds `capacity` up to a power of 2 (of at least 2).
+  static auto roundCapacity(usize capacity) -> usize {
+    if (capacity > std::numeric_limits<usize>::max() / (2 * sizeof(T))) {
+      throw common::OutOfMemoryException(capacity);
+    }
+    return std::bit_ceil((capacity < 2) ? usize(2) : capacity);
+  }
+
+  /// Returns the number of free slots after `tail` (up to `wanted`), only
+  /// reloading the consumer's index if the cached one shows too few.
+  auto freeSlots(usize tail, usize wanted) noexcept -> usize {
+    usize free = this->cap - (tail - this->cached_head);
+    if (free < wanted) {
+      this->cached_head = this->head.load(std::memory_order_acquire);
+      free              = this->cap - (tail - this->cached_head);
+    }
+    return (free < wanted) ? free : wanted;
+  }
+
+  /// Returns the number of items after `head` (up to `wanted`), only
+  /// reloading the producer's index if the cached one shows too few.
+  auto usedSlots(usize head, usize wanted) noexcept -> usize {
+    usize used = this->cached_tail - head;
+    if (used < wanted) {
+      this->cached_tail = this->tail.load(std::memory_order_acquire);
+      used              = this->cached_tail - head;
+    }
+    return (used < wanted) ? used : wanted;
+  }
+
+  // Read-only after construction
+  [[no_unique_address]] mem::AllocatorRef<Allocator> allocator;
+  T*                                                 slots = nullptr;
+  usize                                              cap;
+  usize                                              mask;
+
+  // Written by the consumer
+  alignas(mem::CACHE_LINE_SIZE) std::atomic<usize> head{0};
+  usize                                            cached_tail = 0;
+
+  // Written by the producer
+  alignas(mem::CACHE_LINE_SIZE) std::atomic<usize> tail{0};
+  usize                                            cached_head = 0;
+};
+
+} // namespace mu
+
+#endif // !MU_SPSC_QUEUE_H
@@ -0,0 +1,459 @@
+#include "mu/bytes.h"
+
+#include "mu/primitives.h" // usize, u8, u32, u64
+#include <bit>             // countr_zero, popcount
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(MU_BYTES_NO_SIMD)
+#define MU_BYTES_X86
+#include <immintrin.h> // _mm_*, _mm256_*, _mm512_*
+#endif
+
+namespace mu::internal::bytes {
+
+namespace {
+
+/// The largest set `indexOfAny` compares against with vectors (one compare
+/// per byte in the set); larger sets use a lookup table instead.
+constexpr usize MAX_VECTOR_SET = 16;
+
+/// A set of bytes, with one bit per byte value.
+struct ByteSet {
+  explicit ByteSet(const char* set, usize len) noexcept {
+    for (usize i = 0; i < len; i++) {
+      u8 byte                = static_cast<u8>(set[i]);
+      this->bits[byte >> 6] |= u64(1) << (byte & 63);
+    }
+  }
+
+  auto contains(char c) const noexcept -> bool {
+    u8 byte = static_cast<u8>(c);
+    return (this->bits[byte >> 6] >> (byte & 63)) & 1;
+  }
+
+  u64 bits[4] = {};
+};
+
+// Scalar kernels
+// =============================================
+
+auto indexOfScalar(const char* ptr, usize len, char byte) noexcept -> usize {
+  for (usize i = 0; i < len; i++) {
+    if (ptr[i] == byte) {
+      return i;
+    }
+  }
+  return len;
+}
+
+auto indexOfAnyScalar(const char* ptr, usize len, const char* set,
+                      usize set_len) noexcept -> usize {
+  ByteSet bytes{set, set_len};
+  for (usize i = 0; i < len; i++) {
+    if (bytes.contains(ptr[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+auto countScalar(const char* ptr, usize len, char byte) noexcept -> usize {
+  usize total = 0;
+  for (usize i = 0; i < len; i++) {
+    total += (ptr[i] == byte);
+  }
+  return total;
+}
+
+auto matchMaskScalar(const char* ptr, usize len, char byte) noexcept -> u64 {
+  u64 mask = 0;
+  len      = (len < 64) ? len : 64;
+  for (usize i = 0; i < len; i++) {
+    mask |= u64(ptr[i] == byte) << i;
+  }
+  return mask;
+}
+
+#ifdef MU_BYTES_X86
+// SSE2 kernels
+// =============================================
+
+__attribute__((target("sse2"))) auto load128(const char* ptr) noexcept
+    -> __m128i {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+__attribute__((target("sse2"))) auto
+indexOfSse2(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m128i needle = _mm_set1_epi8(byte);
+  usize   i      = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i eq   = _mm_cmpeq_epi8(load128(ptr + i), needle);
+    u32     mask = static_cast<u32>(_mm_movemask_epi8(eq));
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return i + indexOfScalar(ptr + i, len - i, byte);
+}
+
+__attribute__((target("sse2"))) auto
+matchMaskSse2(const char* ptr, usize len, char byte) noexcept -> u64 {
+  if (len < 64) {
+    return matchMaskScalar(ptr, len, byte);
+  }
+  __m128i needle = _mm_set1_epi8(byte);
+  u64     mask   = 0;
+  for (usize i = 0; i < 64; i += 16) {
+    __m128i eq  = _mm_cmpeq_epi8(load128(ptr + i), needle);
+    mask       |= u64(static_cast<u32>(_mm_movemask_epi8(eq))) << i;
+  }
+  return mask;
+}
+
+__attribute__((target("sse2"))) auto
+indexOfAnySse2(const char* ptr, usize len, const char* set,
+               usize set_len) noexcept -> usize {
+  __m128i needles[MAX_VECTOR_SET];
+  for (usize s = 0; s < set_len; s++) {
+    needles[s] = _mm_set1_epi8(set[s]);
+  }
+  usize i = 0;
+  for (; i + 16 <= len; i += 16) {
+    __m128i chunk = load128(ptr + i);
+    __m128i eq    = _mm_setzero_si128();
+    for (usize s = 0; s < set_len; s++) {
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi8(chunk, needles[s]));
+    }
+    u32 mask = static_cast<u32>(_mm_movemask_epi8(eq));
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return i + indexOfAnyScalar(ptr + i, len - i, set, set_len);
+}
+
+__attribute__((target("sse2"))) auto
+countSse2(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m128i needle = _mm_set1_epi8(byte);
+  usize   total  = 0;
+  usize   i      = 0;
+  while (i + 16 <= len) {
+    // Each matching byte subtracts -1 from its lane, so the lanes can count
+    // up to 255 blocks before they are summed
+    usize   blocks = (len - i) / 16;
+    __m128i lanes  = _mm_setzero_si128();
+    blocks         = (blocks < 255) ? blocks : 255;
+    for (usize b = 0; b < blocks; b++, i += 16) {
+      lanes = _mm_sub_epi8(lanes, _mm_cmpeq_epi8(load128(ptr + i), needle));
+    }
+    __m128i sums  = _mm_sad_epu8(lanes, _mm_setzero_si128());
+    total        += static_cast<usize>(_mm_cvtsi128_si64(sums));
+    total        += static_cast<usize>(_mm_extract_epi16(sums, 4));
+  }
+  return total + countScalar(ptr + i, len - i, byte);
+}
+
+// AVX2 kernels
+// =============================================
+
+__attribute__((target("avx2"))) auto load256(const char* ptr) noexcept
+    -> __m256i {
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+__attribute__((target("avx2"))) auto mask256(__m256i eq) noexcept -> u32 {
+  return static_cast<u32>(_mm256_movemask_epi8(eq));
+}
+
+__attribute__((target("avx2"))) auto
+indexOfAvx2(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m256i needle = _mm256_set1_epi8(byte);
+  usize   i      = 0;
+  // Two vectors per iteration, with one branch for both
+  for (; i + 64 <= len; i += 64) {
+    __m256i lo = _mm256_cmpeq_epi8(load256(ptr + i), needle);
+    __m256i hi = _mm256_cmpeq_epi8(load256(ptr + i + 32), needle);
+    __m256i eq = _mm256_or_si256(lo, hi);
+    if (!_mm256_testz_si256(eq, eq)) {
+      u64 mask = mask256(lo) | (u64(mask256(hi)) << 32);
+      return i + std::countr_zero(mask);
+    }
+  }
+  for (; i + 32 <= len; i += 32) {
+    u32 mask = mask256(_mm256_cmpeq_epi8(load256(ptr + i), needle));
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return i + indexOfSse2(ptr + i, len - i, byte);
+}
+
+__attribute__((target("avx2"))) auto
+matchMaskAvx2(const char* ptr, usize len, char byte) noexcept -> u64 {
+  if (len < 64) {
+    return matchMaskScalar(ptr, len, byte);
+  }
+  __m256i needle = _mm256_set1_epi8(byte);
+  u64     lo     = mask256(_mm256_cmpeq_epi8(load256(ptr), needle));
+  u64     hi     = mask256(_mm256_cmpeq_epi8(load256(ptr + 32), needle));
+  return lo | (hi << 32);
+}
+
+__attribute__((target("avx2"))) auto
+indexOfAnyAvx2(const char* ptr, usize len, const char* set,
+               usize set_len) noexcept -> usize {
+  __m256i needles[MAX_VECTOR_SET];
+  for (usize s = 0; s < set_len; s++) {
+    needles[s] = _mm256_set1_epi8(set[s]);
+  }
+  usize i = 0;
+  for (; i + 32 <= len; i += 32) {
+    __m256i chunk = load256(ptr + i);
+    __m256i eq    = _mm256_setzero_si256();
+    for (usize s = 0; s < set_len; s++) {
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(chunk, needles[s]));
+    }
+    u32 mask = mask256(eq);
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return i + indexOfAnySse2(ptr + i, len - i, set, set_len);
+}
+
+__attribute__((target("avx2"))) auto
+countAvx2(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m256i needle = _mm256_set1_epi8(byte);
+  usize   total  = 0;
+  usize   i      = 0;
+  while (i + 32 <= len) {
+    usize   blocks = (len - i) / 32;
+    __m256i lanes  = _mm256_setzero_si256();
+    blocks         = (blocks < 255) ? blocks : 255;
+    for (usize b = 0; b < blocks; b++, i += 32) {
+      lanes = _mm256_sub_epi8(lanes,
+                              _mm256_cmpeq_epi8(load256(ptr + i), needle));
+    }
+    __m256i sums  = _mm256_sad_epu8(lanes, _mm256_setzero_si256());
+    __m128i half  = _mm_add_epi64(_mm256_castsi256_si128(sums),
+                                  _mm256_extracti128_si256(sums, 1));
+    half          = _mm_add_epi64(half, _mm_unpackhi_epi64(half, half));
+    total        += static_cast<usize>(_mm_cvtsi128_si64(half));
+  }
+  return total + countSse2(ptr + i, len - i, byte);
+}
+
+// AVX-512 kernels
+// =============================================
+
+/// Returns the mask of the first `left` lanes (of 64).
+inline auto lanesMask(usize left) noexcept -> u64 {
+  return (left >= 64) ? ~u64(0) : (u64(1) << left) - 1;
+}
+
+/// Loads the first `left` bytes at `ptr` (and zeroes the rest); masked-out
+/// bytes are never read, so this can't fault past the end.
+__attribute__((target("avx512f,avx512bw"))) auto
+load512(const char* ptr, usize left) noexcept -> __m512i {
+  return _mm512_maskz_loadu_epi8(lanesMask(left), ptr);
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto
+indexOfAvx512(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m512i needle = _mm512_set1_epi8(byte);
+  usize   i      = 0;
+  // Two full vectors per iteration, then masked ones for the tail
+  for (; i + 128 <= len; i += 128) {
+    u64 lo = _mm512_cmpeq_epi8_mask(load512(ptr + i, 64), needle);
+    u64 hi = _mm512_cmpeq_epi8_mask(load512(ptr + i + 64, 64), needle);
+    if ((lo | hi) != 0) {
+      return i + ((lo != 0) ? std::countr_zero(lo) : 64 + std::countr_zero(hi));
+    }
+  }
+  for (; i < len; i += 64) {
+    u64 mask = _mm512_mask_cmpeq_epi8_mask(lanesMask(len - i),
+                                           load512(ptr + i, len - i), needle);
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return len;
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto
+matchMaskAvx512(const char* ptr, usize len, char byte) noexcept -> u64 {
+  return _mm512_mask_cmpeq_epi8_mask(lanesMask(len), load512(ptr, len),
+                                     _mm512_set1_epi8(byte));
+}
+
+__attribute__((target("avx512f,avx512bw"))) auto
+indexOfAnyAvx512(const char* ptr, usize len, const char* set,
+                 usize set_len) noexcept -> usize {
+  __m512i needles[MAX_VECTOR_SET];
+  for (usize s = 0; s < set_len; s++) {
+    needles[s] = _mm512_set1_epi8(set[s]);
+  }
+  for (usize i = 0; i < len; i += 64) {
+    __m512i chunk = load512(ptr + i, len - i);
+    u64     mask  = 0;
+    for (usize s = 0; s < set_len; s++) {
+      mask |= _mm512_cmpeq_epi8_mask(chunk, needles[s]);
+    }
+    mask &= lanesMask(len - i);
+    if (mask != 0) {
+      return i + std::countr_zero(mask);
+    }
+  }
+  return len;
+}
+
+__attribute__((target("avx512f,avx512bw,popcnt"))) auto
+countAvx512(const char* ptr, usize len, char byte) noexcept -> usize {
+  __m512i needle = _mm512_set1_epi8(byte);
+  usize   total  = 0;
+  usize   i      = 0;
+  for (; i + 64 <= len; i += 64) {
+    u64 mask  = _mm512_cmpeq_epi8_mask(load512(ptr + i, 64), needle);
+    total    += static_cast<usize>(std::popcount(mask));
+  }
+  u64 tail = _mm512_mask_cmpeq_epi8_mask(lanesMask(len - i),
+                                         load512(ptr + i, len - i), needle);
+  return total + static_cast<usize>(std::popcount(tail));
+}
+#endif
+
+// Dispatch
+// =============================================
+
+/// The kernels for one instruction set.
+struct Kernels {
+  usize (*index_of)(const char*, usize, char) noexcept;
+  usize (*index_of_any)(const char*, usize, const char*, usize) noexcept;
+  usize (*count)(const char*, usize, char) noexcept;
+  u64 (*match_mask)(const char*, usize, char) noexcept;
+};
+
+constexpr Kernels SCALAR{indexOfScalar, indexOfAnyScalar, countScalar,
+                         matchMaskScalar};
+#ifdef MU_BYTES_X86
+constexpr Kernels SSE2{indexOfSse2, indexOfAnySse2, countSse2,
+                       matchMaskSse2};
+constexpr Kernels AVX2{indexOfAvx2, indexOfAnyAvx2, countAvx2,
+                       matchMaskAvx2};
+constexpr Kernels AVX512{indexOfAvx512, indexOfAnyAvx512, countAvx512,
+                         matchMaskAvx512};
+#endif
+
+auto kernelsFor(Isa isa) noexcept -> const Kernels& {
+#ifdef MU_BYTES_X86
+  switch (isa) {
+  case Isa::Sse2:
+    return SSE2;
+  case Isa::Avx2:
+    return AVX2;
+  case Isa::Avx512:
+    return AVX512;
+  case Isa::Scalar:
+    break;
+  }
+#else
+  (void)isa;
+#endif
+  return SCALAR;
+}
+
+auto detect() noexcept -> Isa {
+  const Isa best_first[] = {Isa::Avx512, Isa::Avx2, Isa::Sse2};
+  for (Isa isa : best_first) {
+    if (isSupported(isa)) {
+      return isa;
+    }
+  }
+  return Isa::Scalar;
+}
+
+/// Returns the kernels for the best supported instruction set.
+auto active() noexcept -> const Kernels& {
+  static const Kernels& kernels = kernelsFor(bestIsa());
+  return kernels;
+}
+
+/// Runs the `indexOfAny` kernel from `kernels`, except for the sets that
+/// don't need (or can't use) it.
+auto indexOfAnyWith(const Kernels& kernels, const char* ptr, usize len,
+                    const char* set, usize set_len) noexcept -> usize {
+  if (set_len == 0) {
+    return len;
+  }
+  if (set_len == 1) {
+    return kernels.index_of(ptr, len, set[0]);
+  }
+  if (set_len > MAX_VECTOR_SET) {
+    return indexOfAnyScalar(ptr, len, set, set_len);
+  }
+  return kernels.index_of_any(ptr, len, set, set_len);
+}
+
+} // namespace
+
+auto bestIsa() noexcept -> Isa {
+  static const Isa best = detect();
+  return best;
+}
+
+auto isSupported(Isa isa) noexcept -> bool {
+#ifdef MU_BYTES_X86
+  switch (isa) {
+  case Isa::Scalar:
+  case Isa::Sse2:
+    return true;
+  case Isa::Avx2:
+    return __builtin_cpu_supports("avx2");
+  case Isa::Avx512:
+    return __builtin_cpu_supports("avx512f") &&
+           __builtin_cpu_supports("avx512bw") &&
+           __builtin_cpu_supports("popcnt");
+  }
+  return false;
+#else
+  return isa == Isa::Scalar;
+#endif
+}
+
+auto indexOf(const char* ptr, usize len, char byte) noexcept -> usize {
+  return active().index_of(ptr, len, byte);
+}
+
+auto indexOfAny(const char* ptr, usize len, const char* set,
+                usize set_len) noexcept -> usize {
+  return indexOfAnyWith(active(), ptr, len, set, set_len);
+}
+
+auto count(const char* ptr, usize len, char byte) noexcept -> usize {
+  return active().count(ptr, len, byte);
+}
+
+auto matchMask(const char* ptr, usize len, char byte) noexcept -> u64 {
+  return active().match_mask(ptr, len, byte);
+}
+
+auto indexOf(Isa isa, const char* ptr, usize len, char byte) noexcept
+    -> usize {
+  return kernelsFor(isa).index_of(ptr, len, byte);
+}
+
+auto indexOfAny(Isa isa, const char* ptr, usize len, const char* set,
+                usize set_len) noexcept -> usize {
+  return indexOfAnyWith(kernelsFor(isa), ptr, len, set, set_len);
+}
+
+auto count(Isa isa, const char* ptr, usize len, char byte) noexcept -> usize {
+  return kernelsFor(isa).count(ptr, len, byte);
+}
+
+auto matchMask(Isa isa, const char* ptr, usize len, char byte) noexcept
+    -> u64 {
+  return kernelsFor(isa).match_mask(ptr, len, byte);
+}
+
+} // namespace mu::internal::bytes
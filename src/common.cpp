@@ -10,6 +10,11 @@ auto IndexOutOfBounds::what() const throw() -> const_cstr {
   return "IndexOutOfBounds: The index must be less than the length";
 }
 
+auto AllocatorMismatchException::what() const throw() -> const_cstr {
+  return "AllocatorMismatchException: The allocator passed in is not an "
+         "instance of the container's static allocator type";
+}
+
 auto OptionUnwrapException::what() const throw() -> const_cstr {
   return "OptionUnwrapException: Called `unwrap` on an empty optional; use "
          "`isValid` to check if the optional value exists first";
@@ -0,0 +1,210 @@
+#include "mu/crc32c.h"
+
+#include "mu/primitives.h" // usize, u8, u32, u64, i64
+#include <array>           // array
+#include <bit>             // endian
+#include <cstring>         // memcpy
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(MU_BYTES_NO_SIMD)
+#define MU_CRC32C_X86
+#include <immintrin.h> // _mm_crc32_*, _mm_clmulepi64_si128
+#endif
+
+namespace mu::internal::crc32c {
+
+namespace {
+
+/// The Castagnoli polynomial, bit-reflected (without the `x^32` term).
+constexpr u32 POLY = 0x82f63b78;
+
+/// `TABLES[k][b]` is the CRC of byte `b` followed by `k` zero bytes.
+constexpr auto makeTables() noexcept -> std::array<std::array<u32, 256>, 8> {
+  std::array<std::array<u32, 256>, 8> tables{};
+  for (u32 b = 0; b < 256; b++) {
+    u32 crc = b;
+    for (usize bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ ((crc & 1) ? POLY : 0);
+    }
+    tables[0][b] = crc;
+  }
+  for (usize k = 1; k < 8; k++) {
+    for (usize b = 0; b < 256; b++) {
+      u32 prev     = tables[k - 1][b];
+      tables[k][b] = (prev >> 8) ^ tables[0][prev & 0xff];
+    }
+  }
+  return tables;
+}
+
+constexpr std::array<std::array<u32, 256>, 8> TABLES = makeTables();
+
+// Table kernel
+// =============================================
+
+/// Updates the (uninverted) register `crc` with `ptr[0..len]`.
+auto updateTable(u32 crc, const u8* ptr, usize len) noexcept -> u32 {
+  for (; len >= 8; len -= 8, ptr += 8) {
+    u32 lo, hi;
+    std::memcpy(&lo, ptr, sizeof(lo));
+    std::memcpy(&hi, ptr + 4, sizeof(hi));
+    if constexpr (std::endian::native == std::endian::big) {
+      lo = __builtin_bswap32(lo);
+      hi = __builtin_bswap32(hi);
+    }
+    lo  ^= crc;
+    crc  = TABLES[7][lo & 0xff] ^ TABLES[6][(lo >> 8) & 0xff] ^
+          TABLES[5][(lo >> 16) & 0xff] ^ TABLES[4][lo >> 24] ^
+          TABLES[3][hi & 0xff] ^ TABLES[2][(hi >> 8) & 0xff] ^
+          TABLES[1][(hi >> 16) & 0xff] ^ TABLES[0][hi >> 24];
+  }
+  for (; len > 0; len--, ptr++) {
+    crc = (crc >> 8) ^ TABLES[0][(crc ^ *ptr) & 0xff];
+  }
+  return crc;
+}
+
+#ifdef MU_CRC32C_X86
+// SSE4.2 kernel
+// =============================================
+
+__attribute__((target("sse4.2"))) auto read64(const u8* ptr) noexcept -> u64 {
+  u64 val;
+  std::memcpy(&val, ptr, sizeof(val));
+  return val;
+}
+
+__attribute__((target("sse4.2"))) auto
+updateSse42(u32 crc, const u8* ptr, usize len) noexcept -> u32 {
+  u64 wide = crc;
+  for (; len >= 8; len -= 8, ptr += 8) {
+    wide = _mm_crc32_u64(wide, read64(ptr));
+  }
+  crc = static_cast<u32>(wide);
+  for (; len > 0; len--, ptr++) {
+    crc = _mm_crc32_u8(crc, *ptr);
+  }
+  return crc;
+}
+
+// PCLMUL kernel
+// =============================================
+
+/// The length of each of the three streams in a block.
+constexpr usize STREAM_LEN = 1024;
+
+/// Returns `x^exp mod P`, bit-reflected.
+constexpr auto xPow(usize exp) noexcept -> u32 {
+  u32 val = u32(1) << 31; // x^0
+  for (usize i = 0; i < exp; i++) {
+    val = (val >> 1) ^ ((val & 1) ? POLY : 0);
+  }
+  return val;
+}
+
+// With the reflected bit order, `crc32(0, clmul(crc, K))` is
+// `crc * K * x^33 mod P` (the instruction multiplies its 64-bit input by
+// `x^32`, and the product of two reflected values is off by one more degree),
+// so shifting a register past `n` bytes takes `K = x^(8n - 33)` (see Intel's
+// "Fast CRC Computation for iSCSI Polynomial Using CRC32 Instruction").
+constexpr u64 SHIFT_1 = xPow(8 * STREAM_LEN - 33);
+constexpr u64 SHIFT_2 = xPow(16 * STREAM_LEN - 33);
+
+/// Returns the register `crc` would become after `n` zero bytes, where `key`
+/// is the `SHIFT_*` constant for `n`.
+__attribute__((target("sse4.2,pclmul"))) auto shift(u32 crc, u64 key) noexcept
+    -> u32 {
+  __m128i reg     = _mm_cvtsi32_si128(static_cast<int>(crc));
+  __m128i factor  = _mm_cvtsi64_si128(static_cast<i64>(key));
+  __m128i product = _mm_clmulepi64_si128(reg, factor, 0x00);
+  return static_cast<u32>(
+      _mm_crc32_u64(0, static_cast<u64>(_mm_cvtsi128_si64(product))));
+}
+
+__attribute__((target("sse4.2,pclmul"))) auto
+updatePclmul(u32 crc, const u8* ptr, usize len) noexcept -> u32 {
+  // The streams are independent, so their `crc32`s overlap (each one has a
+  // latency of 3 cycles, but the CPU can start one per cycle)
+  for (; len >= 3 * STREAM_LEN; len -= 3 * STREAM_LEN) {
+    u64 a = crc;
+    u64 b = 0;
+    u64 c = 0;
+    for (usize i = 0; i < STREAM_LEN; i += 8) {
+      a = _mm_crc32_u64(a, read64(ptr + i));
+      b = _mm_crc32_u64(b, read64(ptr + STREAM_LEN + i));
+      c = _mm_crc32_u64(c, read64(ptr + 2 * STREAM_LEN + i));
+    }
+    // The register is linear in its input: `a` is followed by the other two
+    // streams, and `b` by the last one
+    crc  = shift(static_cast<u32>(a), SHIFT_2) ^
+          shift(static_cast<u32>(b), SHIFT_1) ^ static_cast<u32>(c);
+    ptr += 3 * STREAM_LEN;
+  }
+  return updateSse42(crc, ptr, len);
+}
+#endif
+
+/// Updates the (uninverted) register with the kernel for `impl`.
+auto update(Impl impl, u32 crc, const u8* ptr, usize len) noexcept -> u32 {
+#ifdef MU_CRC32C_X86
+  switch (impl) {
+  case Impl::Sse42:
+    return updateSse42(crc, ptr, len);
+  case Impl::Pclmul:
+    return updatePclmul(crc, ptr, len);
+  case Impl::Table:
+    break;
+  }
+#else
+  (void)impl;
+#endif
+  return updateTable(crc, ptr, len);
+}
+
+auto detect() noexcept -> Impl {
+  const Impl best_first[] = {Impl::Pclmul, Impl::Sse42};
+  for (Impl impl : best_first) {
+    if (isSupported(impl)) {
+      return impl;
+    }
+  }
+  return Impl::Table;
+}
+
+} // namespace
+
+auto bestImpl() noexcept -> Impl {
+  static const Impl best = detect();
+  return best;
+}
+
+auto isSupported(Impl impl) noexcept -> bool {
+#ifdef MU_CRC32C_X86
+  switch (impl) {
+  case Impl::Table:
+    return true;
+  case Impl::Sse42:
+    return __builtin_cpu_supports("sse4.2");
+  case Impl::Pclmul:
+    return __builtin_cpu_supports("sse4.2") &&
+           __builtin_cpu_supports("pclmul");
+  }
+  return false;
+#else
+  return impl == Impl::Table;
+#endif
+}
+
+auto crc32c(Impl impl, const void* data, usize len, u32 crc) noexcept -> u32 {
+  return ~update(impl, ~crc, static_cast<const u8*>(data), len);
+}
+
+} // namespace mu::internal::crc32c
+
+namespace mu {
+
+auto crc32c(const void* data, usize len, u32 crc) noexcept -> u32 {
+  using namespace internal::crc32c;
+  return ~update(bestImpl(), ~crc, static_cast<const u8*>(data), len);
+}
+
+} // namespace mu
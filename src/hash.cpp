@@ -0,0 +1,387 @@
+#include "mu/hash.h"
+
+#include "mu/bytes.h"      // Isa, bestIsa, isSupported
+#include "mu/primitives.h" // usize, u8, u64
+#include <cstring>         // memcpy
+
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(MU_BYTES_NO_SIMD)
+#define MU_HASH_X86
+#include <immintrin.h> // _mm_*, _mm256_*, _mm512_*
+#endif
+
+namespace mu::internal::hash {
+
+namespace {
+
+using bytes::Isa;
+
+/// The initial values of the accumulators.
+constexpr u64 INIT_ACC[8] = {PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+                             PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1};
+
+/// Where the secret for the last stripe starts (unaligned, so it differs
+/// from the secret of every other stripe).
+constexpr usize LAST_STRIPE_OFFSET = SECRET_LEN - STRIPE_LEN - 7;
+
+/// Where the secret for scrambling the accumulators starts.
+constexpr usize SCRAMBLE_OFFSET = SECRET_LEN - STRIPE_LEN;
+
+/// Where the secret for merging the accumulators starts.
+constexpr usize MERGE_OFFSET = 11;
+
+/// Writes `val` to `ptr` as 8 little-endian bytes.
+auto write64(u8* ptr, u64 val) noexcept -> void {
+  if constexpr (std::endian::native == std::endian::big) {
+    val = __builtin_bswap64(val);
+  }
+  std::memcpy(ptr, &val, sizeof(val));
+}
+
+/// Writes the secret for `seed` (the default one, with `seed` added to and
+/// subtracted from alternate words) to `secret`.
+auto deriveSecret(u8* secret, u64 seed) noexcept -> void {
+  const u8* base = DEFAULT_SECRET.data();
+  for (usize i = 0; i < SECRET_LEN; i += 16) {
+    write64(secret + i, read64(base + i) + seed);
+    write64(secret + i + 8, read64(base + i + 8) - seed);
+  }
+}
+
+/// Folds the accumulators into the final hash.
+auto merge(const u64* acc, u64 len, const u8* secret) noexcept -> u64 {
+  u64 result = len * PRIME64_1;
+  for (usize i = 0; i < 4; i++) {
+    result += mulFold(acc[2 * i] ^ read64(secret + 16 * i),
+                      acc[2 * i + 1] ^ read64(secret + 16 * i + 8));
+  }
+  return mix64(result);
+}
+
+// Scalar kernels
+// =============================================
+
+/// Adds `stripes` stripes from `ptr` to the accumulators, where stripe `n`
+/// is keyed with the secret from `secret + 8 * n`.
+///
+/// Each lane adds the product of the (keyed) halves of its input, and its
+/// neighbour adds the raw input (so no input bits are lost in the products).
+auto accumulateScalar(u64* acc, const u8* ptr, const u8* secret,
+                      usize stripes) noexcept -> void {
+  for (usize n = 0; n < stripes; n++, ptr += STRIPE_LEN, secret += 8) {
+    for (usize i = 0; i < 8; i++) {
+      u64 data    = read64(ptr + 8 * i);
+      u64 key     = data ^ read64(secret + 8 * i);
+      acc[i ^ 1] += data;
+      acc[i]     += (key & 0xffffffff) * (key >> 32);
+    }
+  }
+}
+
+/// Mixes the high bits of the accumulators back into the low bits (which is
+/// all the 32-bit products read).
+auto scrambleScalar(u64* acc, const u8* secret) noexcept -> void {
+  for (usize i = 0; i < 8; i++) {
+    u64 val  = acc[i];
+    val     ^= val >> 47;
+    val     ^= read64(secret + 8 * i);
+    acc[i]   = val * PRIME32_1;
+  }
+}
+
+#ifdef MU_HASH_X86
+// SSE2 kernels
+// =============================================
+
+auto load128(const void* ptr) noexcept -> __m128i {
+  return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+}
+
+auto accumulateSse2(u64* acc, const u8* ptr, const u8* secret,
+                    usize stripes) noexcept -> void {
+  __m128i lanes[4];
+  for (usize i = 0; i < 4; i++) {
+    lanes[i] = load128(acc + 2 * i);
+  }
+  for (usize n = 0; n < stripes; n++, ptr += STRIPE_LEN, secret += 8) {
+    for (usize i = 0; i < 4; i++) {
+      __m128i data    = load128(ptr + 16 * i);
+      __m128i key     = _mm_xor_si128(data, load128(secret + 16 * i));
+      __m128i product = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));
+      __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(swapped, product));
+    }
+  }
+  for (usize i = 0; i < 4; i++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * i), lanes[i]);
+  }
+}
+
+auto scrambleSse2(u64* acc, const u8* secret) noexcept -> void {
+  __m128i prime = _mm_set1_epi32(static_cast<int>(PRIME32_1));
+  for (usize i = 0; i < 4; i++) {
+    __m128i val = load128(acc + 2 * i);
+    val         = _mm_xor_si128(val, _mm_srli_epi64(val, 47));
+    val         = _mm_xor_si128(val, load128(secret + 16 * i));
+    __m128i lo  = _mm_mul_epu32(val, prime);
+    __m128i hi  = _mm_mul_epu32(_mm_srli_epi64(val, 32), prime);
+    val         = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * i), val);
+  }
+}
+
+// AVX2 kernels
+// =============================================
+
+__attribute__((target("avx2"))) auto load256(const void* ptr) noexcept
+    -> __m256i {
+  return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+}
+
+__attribute__((target("avx2"))) auto
+accumulateAvx2(u64* acc, const u8* ptr, const u8* secret,
+               usize stripes) noexcept -> void {
+  __m256i lo = load256(acc);
+  __m256i hi = load256(acc + 4);
+  for (usize n = 0; n < stripes; n++, ptr += STRIPE_LEN, secret += 8) {
+    __m256i data_lo = load256(ptr);
+    __m256i data_hi = load256(ptr + 32);
+    __m256i key_lo  = _mm256_xor_si256(data_lo, load256(secret));
+    __m256i key_hi  = _mm256_xor_si256(data_hi, load256(secret + 32));
+    lo              = _mm256_add_epi64(
+        lo, _mm256_mul_epu32(key_lo, _mm256_srli_epi64(key_lo, 32)));
+    hi = _mm256_add_epi64(
+        hi, _mm256_mul_epu32(key_hi, _mm256_srli_epi64(key_hi, 32)));
+    lo = _mm256_add_epi64(
+        lo, _mm256_shuffle_epi32(data_lo, _MM_SHUFFLE(1, 0, 3, 2)));
+    hi = _mm256_add_epi64(
+        hi, _mm256_shuffle_epi32(data_hi, _MM_SHUFFLE(1, 0, 3, 2)));
+  }
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), lo);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4), hi);
+}
+
+__attribute__((target("avx2"))) auto
+scrambleAvx2(u64* acc, const u8* secret) noexcept -> void {
+  __m256i prime = _mm256_set1_epi32(static_cast<int>(PRIME32_1));
+  for (usize i = 0; i < 2; i++) {
+    __m256i val = load256(acc + 4 * i);
+    val         = _mm256_xor_si256(val, _mm256_srli_epi64(val, 47));
+    val         = _mm256_xor_si256(val, load256(secret + 32 * i));
+    __m256i lo  = _mm256_mul_epu32(val, prime);
+    __m256i hi  = _mm256_mul_epu32(_mm256_srli_epi64(val, 32), prime);
+    val         = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4 * i), val);
+  }
+}
+
+// AVX-512 kernels
+// =============================================
+
+// GCC 12's headers trip `-Wuninitialized` on the unmasked AVX-512 shifts and
+// multiplies (GCC bug 105593)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f"))) auto
+accumulateAvx512(u64* acc, const u8* ptr, const u8* secret,
+                 usize stripes) noexcept -> void {
+  __m512i lanes = _mm512_loadu_si512(acc);
+  for (usize n = 0; n < stripes; n++, ptr += STRIPE_LEN, secret += 8) {
+    __m512i data = _mm512_loadu_si512(ptr);
+    __m512i key  = _mm512_xor_si512(data, _mm512_loadu_si512(secret));
+    lanes        = _mm512_add_epi64(
+        lanes, _mm512_mul_epu32(key, _mm512_srli_epi64(key, 32)));
+    lanes        = _mm512_add_epi64(lanes,
+                                    _mm512_shuffle_epi32(data, _MM_PERM_BADC));
+  }
+  _mm512_storeu_si512(acc, lanes);
+}
+
+__attribute__((target("avx512f"))) auto
+scrambleAvx512(u64* acc, const u8* secret) noexcept -> void {
+  __m512i prime = _mm512_set1_epi32(static_cast<int>(PRIME32_1));
+  __m512i val   = _mm512_loadu_si512(acc);
+  val           = _mm512_xor_si512(val, _mm512_srli_epi64(val, 47));
+  val           = _mm512_xor_si512(val, _mm512_loadu_si512(secret));
+  __m512i lo    = _mm512_mul_epu32(val, prime);
+  __m512i hi    = _mm512_mul_epu32(_mm512_srli_epi64(val, 32), prime);
+  _mm512_storeu_si512(acc, _mm512_add_epi64(lo, _mm512_slli_epi64(hi, 32)));
+}
+#pragma GCC diagnostic pop
+#endif
+
+// Dispatch
+// =============================================
+
+/// The stripe kernels for one instruction set.
+struct Kernels {
+  void (*accumulate)(u64*, const u8*, const u8*, usize) noexcept;
+  void (*scramble)(u64*, const u8*) noexcept;
+};
+
+constexpr Kernels SCALAR{accumulateScalar, scrambleScalar};
+#ifdef MU_HASH_X86
+constexpr Kernels SSE2{accumulateSse2, scrambleSse2};
+constexpr Kernels AVX2{accumulateAvx2, scrambleAvx2};
+constexpr Kernels AVX512{accumulateAvx512, scrambleAvx512};
+#endif
+
+auto kernelsFor(Isa isa) noexcept -> const Kernels& {
+#ifdef MU_HASH_X86
+  switch (isa) {
+  case Isa::Sse2:
+    return SSE2;
+  case Isa::Avx2:
+    return AVX2;
+  case Isa::Avx512:
+    return AVX512;
+  case Isa::Scalar:
+    break;
+  }
+#else
+  (void)isa;
+#endif
+  return SCALAR;
+}
+
+/// Returns the kernels for the best supported instruction set.
+auto active() noexcept -> const Kernels& {
+  static const Kernels& kernels = kernelsFor(bytes::bestIsa());
+  return kernels;
+}
+
+/// Adds `count` stripes from `ptr`, where `stripes` is the number of stripes
+/// already added since the last scramble.
+auto consume(const Kernels& kernels, u64* acc, usize& stripes, const u8* ptr,
+             usize count, const u8* secret) noexcept -> void {
+  while (count > 0) {
+    usize num = STRIPES_PER_BLOCK - stripes;
+    num       = (count < num) ? count : num;
+    kernels.accumulate(acc, ptr, secret + 8 * stripes, num);
+    stripes += num;
+    ptr     += num * STRIPE_LEN;
+    count   -= num;
+    if (stripes == STRIPES_PER_BLOCK) {
+      kernels.scramble(acc, secret + SCRAMBLE_OFFSET);
+      stripes = 0;
+    }
+  }
+}
+
+auto hashLongWith(const Kernels& kernels, const u8* ptr, usize len,
+                  u64 seed) noexcept -> u64 {
+  alignas(64) u8 custom[SECRET_LEN];
+  const u8*      secret = DEFAULT_SECRET.data();
+  if (seed != 0) {
+    deriveSecret(custom, seed);
+    secret = custom;
+  }
+
+  alignas(64) u64 acc[8];
+  std::memcpy(acc, INIT_ACC, sizeof(acc));
+  usize stripes = 0;
+
+  // Every stripe except the last, which is hashed separately (it may
+  // overlap the ones before it)
+  consume(kernels, acc, stripes, ptr, (len - 1) / STRIPE_LEN, secret);
+  kernels.accumulate(acc, ptr + len - STRIPE_LEN, secret + LAST_STRIPE_OFFSET,
+                     1);
+  return merge(acc, len, secret + MERGE_OFFSET);
+}
+
+} // namespace
+
+auto hashLong(const u8* ptr, usize len, u64 seed) noexcept -> u64 {
+  return hashLongWith(active(), ptr, len, seed);
+}
+
+auto hash64(Isa isa, const void* data, usize len, u64 seed) noexcept -> u64 {
+  const u8* ptr = static_cast<const u8*>(data);
+  if (len <= MID_MAX_LEN) {
+    return mu::hash64(ptr, len, seed);
+  }
+  return hashLongWith(kernelsFor(isa), ptr, len, seed);
+}
+
+} // namespace mu::internal::hash
+
+namespace mu {
+
+using namespace internal::hash;
+
+Hasher::Hasher(u64 seed) noexcept : seed{seed} { this->reset(); }
+
+auto Hasher::update(const void* data, usize len) noexcept -> void {
+  const u8* ptr  = static_cast<const u8*>(data);
+  this->total   += len;
+  if (this->buffered + len <= BUFFER_LEN) {
+    if (len != 0) {
+      std::memcpy(this->buffer + this->buffered, ptr, len);
+    }
+    this->buffered += len;
+    return;
+  }
+
+  const Kernels& kernels = active();
+  if (this->buffered != 0) {
+    usize fill = BUFFER_LEN - this->buffered;
+    std::memcpy(this->buffer + this->buffered, ptr, fill);
+    ptr += fill;
+    len -= fill;
+    consume(kernels, this->acc, this->stripes, this->buffer,
+            BUFFER_LEN / STRIPE_LEN, this->secret);
+  }
+
+  // Always keep some bytes buffered, since the last stripe is hashed
+  // differently (and only `finish` knows which one it is)
+  if (len > BUFFER_LEN) {
+    usize count = (len - 1) / STRIPE_LEN;
+    consume(kernels, this->acc, this->stripes, ptr, count, this->secret);
+    ptr += count * STRIPE_LEN;
+    len -= count * STRIPE_LEN;
+
+    // The last stripe may need some of these bytes
+    std::memcpy(this->buffer + BUFFER_LEN - STRIPE_LEN, ptr - STRIPE_LEN,
+                STRIPE_LEN);
+  }
+  std::memcpy(this->buffer, ptr, len);
+  this->buffered = len;
+}
+
+auto Hasher::finish() const noexcept -> u64 {
+  if (this->total <= MID_MAX_LEN) {
+    return hash64(this->buffer, this->total, this->seed);
+  }
+
+  const Kernels&  kernels = active();
+  alignas(64) u64 acc[8];
+  std::memcpy(acc, this->acc, sizeof(acc));
+  usize stripes = this->stripes;
+  consume(kernels, acc, stripes, this->buffer,
+          (this->buffered - 1) / STRIPE_LEN, this->secret);
+
+  // The end of the last stripe is buffered, and the start of it (if any) is
+  // still at the end of the buffer
+  u8        joined[STRIPE_LEN];
+  const u8* last = joined;
+  if (this->buffered >= STRIPE_LEN) {
+    last = this->buffer + this->buffered - STRIPE_LEN;
+  } else {
+    usize previous = STRIPE_LEN - this->buffered;
+    std::memcpy(joined, this->buffer + BUFFER_LEN - previous, previous);
+    std::memcpy(joined + previous, this->buffer, this->buffered);
+  }
+  kernels.accumulate(acc, last, this->secret + LAST_STRIPE_OFFSET, 1);
+  return merge(acc, this->total, this->secret + MERGE_OFFSET);
+}
+
+auto Hasher::reset() noexcept -> void {
+  std::memcpy(this->acc, INIT_ACC, sizeof(this->acc));
+  deriveSecret(this->secret, this->seed);
+  this->buffered = 0;
+  this->stripes  = 0;
+  this->total    = 0;
+}
+
+} // namespace mu
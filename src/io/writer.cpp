@@ -15,8 +15,11 @@ auto Writer::format(const_cstr fmt, ...) -> void {
 auto Writer::writeAll(Slice<u8> buf) -> void {
   usize idx = 0;
   while (idx != buf.len()) {
-    idx += this->write(buf);
-    buf  = Slice(buf.ptr() + idx, buf.len());
+    usize written = this->write(Slice<u8>(buf.ptr() + idx, buf.len() - idx));
+    if (written == 0) {
+      return;
+    }
+    idx += written;
   }
 }
 
@@ -1,40 +1,77 @@
 #include "mu/mem/allocator.h"
 
 #include "mu/primitives.h" // usize, u8
-#include <cassert>         // assert
+#include <cstring>         // memcpy, memmove
 
 namespace mu::mem {
 
-constexpr auto isPowerOf2(u8 val) noexcept -> bool {
-  return (val != 0) && ((val & (val - 1)) == 0);
-  ;
+auto Allocator::freeWithHeader(void* ptr, usize byte_size,
+                               usize align) noexcept -> void {
+  u8* aligned = reinterpret_cast<u8*>(ptr);
+  this->free_fn(aligned - readHeader(aligned, align),
+                byte_size + headerSize(align), 1);
 }
 
-// NOTE: Impl from:
-// https://johanmabille.github.io/blog/2014/12/06/aligned-memory-allocator/
-auto Allocator::rawAlloc(usize byte_size, u8 align) -> void* {
-  assert(isPowerOf2(align));
-  u8*   res = nullptr;
-  void* ptr = this->alloc_fn(byte_size + align);
-  if (ptr != nullptr) {
-    // Align allocation
-    res = reinterpret_cast<u8*>(
-        (reinterpret_cast<usize>(ptr) & ~(usize(align - 1))) + align);
-
-    // Set offset
-    u8 offset      = res - reinterpret_cast<u8*>(ptr);
-    *(res - align) = offset;
+auto Allocator::rawResize(void* ptr, usize old_size, usize new_size,
+                          usize align) noexcept -> bool {
+  if (ptr == nullptr) {
+    return false;
   }
-  return res;
+  if (align <= this->native_align_fn()) {
+    return this->resize_fn(ptr, old_size, new_size, align);
+  }
+
+  // The alignment offset stays the same, since the allocation doesn't move
+  u8*   aligned = reinterpret_cast<u8*>(ptr);
+  usize header  = headerSize(align);
+  return this->resize_fn(aligned - readHeader(aligned, align),
+                         old_size + header, new_size + header, 1);
 }
 
-auto Allocator::rawFree(void* ptr, u8 align) noexcept -> void {
-  if (ptr != nullptr) {
-    u8* aligned = reinterpret_cast<u8*>(ptr);
-    u8* offset  = aligned - align;
-    u8* alloced = aligned - *offset;
-    this->free_fn(alloced);
+auto Allocator::rawRemap(void* ptr, usize old_size, usize new_size,
+                         usize align) -> void* {
+  if (this->rawResize(ptr, old_size, new_size, align)) {
+    return ptr;
+  }
+  if (align <= this->native_align_fn()) {
+    return this->remap_fn(ptr, old_size, new_size, align);
+  }
+
+  u8*   aligned  = reinterpret_cast<u8*>(ptr);
+  usize offset   = readHeader(aligned, align);
+  usize header   = headerSize(align);
+  void* remapped = this->remap_fn(aligned - offset, old_size + header,
+                                  new_size + header, 1);
+  if (remapped == nullptr) {
+    return nullptr;
+  }
+
+  // Re-align the data, since the new block may have a different offset
+  u8* old_res = reinterpret_cast<u8*>(remapped) + offset;
+  u8* res     = alignAfterHeader(remapped, align);
+  if (res != old_res) {
+    std::memmove(res, old_res, old_size < new_size ? old_size : new_size);
   }
+  return writeHeader(remapped, align);
+}
+
+auto Allocator::rawRealloc(void* ptr, usize old_size, usize new_size,
+                           usize align) -> void* {
+  if (ptr == nullptr) {
+    return this->rawAlloc(new_size, align);
+  }
+  void* remapped = this->rawRemap(ptr, old_size, new_size, align);
+  if (remapped != nullptr) {
+    return remapped;
+  }
+
+  // Fall back to allocate, copy, free
+  void* res = this->rawAlloc(new_size, align);
+  if (res != nullptr) {
+    std::memcpy(res, ptr, old_size < new_size ? old_size : new_size);
+    this->rawFree(ptr, old_size, align);
+  }
+  return res;
 }
 
 } // namespace mu::mem
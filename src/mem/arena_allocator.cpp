@@ -0,0 +1,196 @@
+#include "mu/mem/arena_allocator.h"
+
+#include "mu/primitives.h" // usize, u8
+#include <cstddef>         // max_align_t
+#include <limits>          // numeric_limits
+#include <utility>         // swap
+
+namespace mu::mem {
+
+/// Alignment of every chunk.
+static constexpr usize MAX_ALIGN = alignof(std::max_align_t);
+
+static constexpr auto alignUp(usize val, usize align) noexcept -> usize {
+  return (val + align - 1) & ~(align - 1);
+}
+
+/// Size of the chunk header, padded so the chunk data stays aligned.
+static constexpr usize CHUNK_HEADER_SIZE =
+    alignUp(2 * sizeof(usize), MAX_ALIGN);
+
+/// Returns a pointer to the first usable byte of `chunk`.
+static inline auto chunkData(void* chunk) noexcept -> u8* {
+  return reinterpret_cast<u8*>(chunk) + CHUNK_HEADER_SIZE;
+}
+
+ArenaAllocator::ArenaAllocator(Allocator* backing, usize chunk_size) noexcept
+    : backing{backing}, chunk_size{chunk_size} {}
+
+ArenaAllocator::ArenaAllocator(ArenaAllocator&& other) noexcept
+    : backing{other.backing}, chunk_size{other.chunk_size}, head{other.head},
+      current{other.current}, used{other.used} {
+  other.head    = nullptr;
+  other.current = nullptr;
+  other.used    = 0;
+}
+
+ArenaAllocator& ArenaAllocator::operator=(ArenaAllocator&& other) noexcept {
+  if (this == &other) {
+    return *this;
+  }
+  this->release();
+  std::swap(this->backing, other.backing);
+  std::swap(this->chunk_size, other.chunk_size);
+  std::swap(this->head, other.head);
+  std::swap(this->current, other.current);
+  std::swap(this->used, other.used);
+  return *this;
+}
+
+ArenaAllocator::~ArenaAllocator() { this->release(); }
+
+auto ArenaAllocator::checkpoint() const noexcept -> Checkpoint {
+  return Checkpoint{this->current, this->used};
+}
+
+auto ArenaAllocator::rollback(Checkpoint checkpoint) noexcept -> void {
+  if (checkpoint.chunk == nullptr) {
+    this->reset();
+    return;
+  }
+  this->current = checkpoint.chunk;
+  this->used    = checkpoint.used;
+}
+
+auto ArenaAllocator::reset() noexcept -> void {
+  this->current = this->head;
+  this->used    = 0;
+}
+
+auto ArenaAllocator::release() noexcept -> void {
+  Chunk* chunk = this->head;
+  while (chunk != nullptr) {
+    Chunk* next = chunk->next;
+    this->backing->rawFree(chunk, CHUNK_HEADER_SIZE + chunk->cap, MAX_ALIGN);
+    chunk = next;
+  }
+  this->head    = nullptr;
+  this->current = nullptr;
+  this->used    = 0;
+}
+
+auto ArenaAllocator::capacity() const noexcept -> usize {
+  usize cap = 0;
+  for (Chunk* chunk = this->head; chunk != nullptr; chunk = chunk->next) {
+    cap += chunk->cap;
+  }
+  return cap;
+}
+
+auto ArenaAllocator::owns(void* ptr) const noexcept -> bool {
+  u8* addr = reinterpret_cast<u8*>(ptr);
+  for (Chunk* chunk = this->head; chunk != nullptr; chunk = chunk->next) {
+    u8* data = chunkData(chunk);
+    if ((addr >= data) && (addr < data + chunk->cap)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+auto ArenaAllocator::nextChunk(usize byte_size) -> bool {
+  // Reuse chunks kept around by `reset`/`rollback`
+  if ((this->current != nullptr) && (this->current->next != nullptr) &&
+      (this->current->next->cap >= byte_size)) {
+    this->current = this->current->next;
+    this->used    = 0;
+    return true;
+  }
+
+  usize  min_cap = byte_size > this->chunk_size ? byte_size : this->chunk_size;
+  usize  cap     = alignUp(min_cap, MAX_ALIGN);
+  Chunk* chunk   = reinterpret_cast<Chunk*>(
+      this->backing->rawAlloc(CHUNK_HEADER_SIZE + cap, MAX_ALIGN));
+  if (chunk == nullptr) {
+    return false;
+  }
+  chunk->cap = cap;
+  if (this->current == nullptr) {
+    chunk->next = nullptr;
+    this->head  = chunk;
+  } else {
+    chunk->next         = this->current->next;
+    this->current->next = chunk;
+  }
+  this->current = chunk;
+  this->used    = 0;
+  return true;
+}
+
+/// Returns the offset of the first address at or after `offset` in `chunk`
+/// that is aligned to `align`.
+static inline auto alignedOffset(void* chunk, usize offset,
+                                 usize align) noexcept -> usize {
+  usize addr = reinterpret_cast<usize>(chunkData(chunk)) + offset;
+  return offset + (alignUp(addr, align) - addr);
+}
+
+auto ArenaAllocator::alloc_fn(usize byte_size, usize align) noexcept -> void* {
+  usize start = 0;
+  if (this->current != nullptr) {
+    start = alignedOffset(this->current, this->used, align);
+  }
+  if ((this->current == nullptr) ||
+      (start + byte_size > this->current->cap)) {
+    // Leave room to align the start of the allocation
+    if (!this->nextChunk(byte_size + align - 1)) {
+      return nullptr;
+    }
+    start = alignedOffset(this->current, 0, align);
+  }
+  this->used = start + byte_size;
+  return chunkData(this->current) + start;
+}
+
+auto ArenaAllocator::topOffset(void* ptr, usize byte_size) const noexcept
+    -> usize {
+  if (this->current == nullptr) {
+    return static_cast<usize>(-1);
+  }
+  u8* data = chunkData(this->current);
+  u8* top  = reinterpret_cast<u8*>(ptr) + byte_size;
+  if ((ptr < data) || (top != data + this->used)) {
+    return static_cast<usize>(-1);
+  }
+  return static_cast<usize>(reinterpret_cast<u8*>(ptr) - data);
+}
+
+auto ArenaAllocator::free_fn(void* ptr, usize byte_size,
+                             usize /*align*/) noexcept -> void {
+  // Only the allocation at the top of the arena can be given back, so frees in
+  // reverse order of allocation reclaim everything
+  usize offset = this->topOffset(ptr, byte_size);
+  if (offset != static_cast<usize>(-1)) {
+    this->used = offset;
+  }
+}
+
+auto ArenaAllocator::resize_fn(void* ptr, usize old_size, usize new_size,
+                               usize /*align*/) noexcept -> bool {
+  // The allocation at the top can grow into the rest of the chunk
+  usize offset = this->topOffset(ptr, old_size);
+  if (offset != static_cast<usize>(-1)) {
+    if (offset + new_size > this->current->cap) {
+      return false;
+    }
+    this->used = offset + new_size;
+    return true;
+  }
+  return new_size <= old_size;
+}
+
+auto ArenaAllocator::native_align_fn() const noexcept -> usize {
+  return std::numeric_limits<usize>::max();
+}
+
+} // namespace mu::mem
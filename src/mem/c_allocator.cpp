@@ -2,13 +2,34 @@
 #include "mu/mem/c_allocator.h"
 
 #include "mu/primitives.h" // usize, u8
+#include <cstddef>         // max_align_t
+#include <cstdlib>         // realloc
+
+#if defined(__GLIBC__)
+#include <malloc.h> // malloc_usable_size
+#endif
 
 namespace mu::mem {
 
-auto CAllocator::alloc_fn(usize byte_size) noexcept -> void* {
-  return std::calloc(1, byte_size);
+auto CAllocator::resize_fn(void* ptr, usize /*old_size*/, usize new_size,
+                           usize /*align*/) noexcept -> bool {
+#if defined(__GLIBC__)
+  // The block may already be larger than requested
+  return new_size <= malloc_usable_size(ptr);
+#else
+  (void)ptr;
+  (void)new_size;
+  return false;
+#endif
 }
 
-auto CAllocator::free_fn(void* ptr) noexcept -> void { std::free(ptr); }
+auto CAllocator::remap_fn(void* ptr, usize /*old_size*/, usize new_size,
+                          usize align) noexcept -> void* {
+  // `realloc` only guarantees the fundamental alignment
+  if (align > alignof(std::max_align_t)) {
+    return nullptr;
+  }
+  return std::realloc(ptr, new_size);
+}
 
 } // namespace mu::mem
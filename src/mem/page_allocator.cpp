@@ -0,0 +1,149 @@
+#include "mu/mem/page_allocator.h"
+
+#include "mu/primitives.h" // usize, u8
+#include <limits>          // numeric_limits
+#include <sys/mman.h>      // mmap, munmap, mremap, madvise
+#include <unistd.h>        // sysconf
+
+namespace mu::mem {
+
+namespace {
+
+inline auto alignUp(usize val, usize align) noexcept -> usize {
+  return (val + align - 1) & ~(align - 1);
+}
+
+inline auto mapAnonymous(usize len, int flags) noexcept -> u8* {
+  void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | flags, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : reinterpret_cast<u8*>(ptr);
+}
+
+} // namespace
+
+auto PageAllocator::pageSize() noexcept -> usize {
+  static const usize page_size = static_cast<usize>(sysconf(_SC_PAGESIZE));
+  return page_size;
+}
+
+auto PageAllocator::discard(void* ptr, usize byte_size) noexcept -> void {
+  madvise(ptr, alignUp(byte_size, pageSize()), MADV_DONTNEED);
+}
+
+auto PageAllocator::usesHugePages(usize byte_size) const noexcept -> bool {
+  return (this->huge_pages != HugePages::None) &&
+         (alignUp(byte_size, pageSize()) >= HUGE_PAGE_SIZE);
+}
+
+auto PageAllocator::mappingSize(usize byte_size) const noexcept -> usize {
+  return alignUp(byte_size, this->usesHugePages(byte_size) ? HUGE_PAGE_SIZE
+                                                           : pageSize());
+}
+
+auto PageAllocator::alloc_fn(usize byte_size, usize align) noexcept -> void* {
+  usize page = pageSize();
+  usize len  = this->mappingSize(byte_size);
+  bool  huge = this->usesHugePages(byte_size);
+  if (align < page) {
+    align = page;
+  }
+  if (huge && (align < HUGE_PAGE_SIZE)) {
+    align = HUGE_PAGE_SIZE;
+  }
+
+#if defined(MAP_HUGETLB)
+  // Huge TLB mappings are always aligned to the huge page size
+  if (huge && (this->huge_pages == HugePages::Explicit) &&
+      (align == HUGE_PAGE_SIZE)) {
+    u8* data = mapAnonymous(len, MAP_HUGETLB);
+    if (data != nullptr) {
+      return data;
+    }
+  }
+#endif
+
+  // Over-map so the data can be aligned, then trim the excess
+  usize over = len + (align - page);
+  u8*   base = mapAnonymous(over, 0);
+  if (base == nullptr) {
+    return nullptr;
+  }
+  u8* data =
+      reinterpret_cast<u8*>(alignUp(reinterpret_cast<usize>(base), align));
+  if (data > base) {
+    munmap(base, static_cast<usize>(data - base));
+  }
+  if (base + over > data + len) {
+    munmap(data + len, static_cast<usize>(base + over - (data + len)));
+  }
+
+  if (huge) {
+    madvise(data, len, MADV_HUGEPAGE);
+  }
+  return data;
+}
+
+auto PageAllocator::alloc_zeroed_fn(usize byte_size,
+                                    usize align) noexcept -> void* {
+  // Every allocation gets a fresh mapping, which the kernel zeroes
+  return this->alloc_fn(byte_size, align);
+}
+
+auto PageAllocator::free_fn(void* ptr, usize byte_size,
+                            usize /*align*/) noexcept -> void {
+  munmap(ptr, this->mappingSize(byte_size));
+}
+
+auto PageAllocator::native_align_fn() const noexcept -> usize {
+  return std::numeric_limits<usize>::max();
+}
+
+auto PageAllocator::resize_fn(void* ptr, usize old_size, usize new_size,
+                              usize /*align*/) noexcept -> bool {
+  // The mapping size must stay derivable from the allocation size
+  bool huge = this->usesHugePages(old_size);
+  if (huge != this->usesHugePages(new_size)) {
+    return false;
+  }
+
+  usize old_len = this->mappingSize(old_size);
+  usize new_len = this->mappingSize(new_size);
+  if (new_len <= old_len) {
+    // Return the pages that are no longer needed
+    if (new_len < old_len) {
+      munmap(reinterpret_cast<u8*>(ptr) + new_len, old_len - new_len);
+    }
+    return true;
+  }
+
+#if defined(__linux__)
+  // Try to extend the mapping without moving it
+  if (!huge && (mremap(ptr, old_len, new_len, 0) != MAP_FAILED)) {
+    return true;
+  }
+#endif
+  return false;
+}
+
+auto PageAllocator::remap_fn(void* ptr, usize old_size, usize new_size,
+                             usize align) noexcept -> void* {
+#if defined(__linux__)
+  // The kernel only guarantees page alignment for the moved mapping
+  if (this->usesHugePages(old_size) || this->usesHugePages(new_size) ||
+      (align > pageSize())) {
+    return nullptr;
+  }
+
+  void* res = mremap(ptr, this->mappingSize(old_size),
+                     this->mappingSize(new_size), MREMAP_MAYMOVE);
+  return res == MAP_FAILED ? nullptr : res;
+#else
+  (void)ptr;
+  (void)old_size;
+  (void)new_size;
+  (void)align;
+  return nullptr;
+#endif
+}
+
+} // namespace mu::mem
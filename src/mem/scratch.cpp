@@ -0,0 +1,16 @@
+#include "mu/mem/scratch.h"
+
+#include "mu/mem/arena_allocator.h" // ArenaAllocator
+#include "mu/mem/c_allocator.h"     // CAllocator
+
+namespace mu::mem {
+
+/// Backs the scratch arenas of all threads.
+static CAllocator scratch_backing{};
+
+auto scratchArena() noexcept -> ArenaAllocator& {
+  thread_local ArenaAllocator arena{&scratch_backing, SCRATCH_CHUNK_SIZE};
+  return arena;
+}
+
+} // namespace mu::mem
@@ -0,0 +1,354 @@
+#include "mu/mem/thread_safe_allocator.h"
+
+#include "mu/primitives.h" // usize, u8, u64
+#include <atomic>          // atomic
+#include <bit>             // bit_width
+#include <cstdlib>         // posix_memalign, free
+#include <memory>          // shared_ptr, weak_ptr, make_shared
+#include <mutex>           // mutex, lock_guard
+
+namespace mu::mem {
+
+/// Size of the chunks that small blocks are carved out of.
+static constexpr usize CHUNK_SIZE        = 256 * 1024;
+
+/// Size of the chunk header, padded to a cache line.
+static constexpr usize CHUNK_HEADER_SIZE = 64;
+
+/// Alignment of every block.
+static constexpr usize MIN_ALIGN         = 16;
+
+/// Largest allocation served from the size classes.
+static constexpr usize MAX_SMALL_SIZE    = 16 * 1024;
+
+/// Size classes are 16 byte steps up to 128 bytes, then 4 classes per power of
+/// two up to `MAX_SMALL_SIZE`.
+static constexpr usize NUM_CLASSES       = 36;
+
+/// Maximum number of allocators a thread keeps caches for at once.
+static constexpr usize MAX_CACHES        = 8;
+
+static constexpr auto  classOf(usize byte_size) noexcept -> usize {
+  if (byte_size <= 128) {
+    return byte_size == 0 ? 0 : (byte_size - 1) / 16;
+  }
+  usize pow  = std::bit_width(byte_size - 1);
+  usize step = ((byte_size - 1) >> (pow - 3)) - 4;
+  return 8 + ((pow - 8) * 4) + step;
+}
+
+static constexpr auto classSize(usize size_class) noexcept -> usize {
+  if (size_class < 8) {
+    return (size_class + 1) * 16;
+  }
+  usize group   = (size_class - 8) / 4;
+  usize step    = (size_class - 8) % 4;
+  usize quarter = usize(1) << (group + 5);
+  return (5 + step) * quarter;
+}
+
+/// Number of blocks moved between a thread cache and the shared heap at once.
+static constexpr auto batchSize(usize size_class) noexcept -> usize {
+  usize count = (32 * 1024) / classSize(size_class);
+  return count < 2 ? 2 : (count > 64 ? 64 : count);
+}
+
+static_assert(classSize(NUM_CLASSES - 1) == MAX_SMALL_SIZE);
+static_assert(classOf(MAX_SMALL_SIZE) == NUM_CLASSES - 1);
+static_assert(classOf(129) == 8 && classSize(8) == 160);
+
+namespace {
+
+struct Block {
+  Block* next;
+  Block* next_batch;
+};
+
+struct ChunkHeader {
+  ChunkHeader* next;
+};
+
+/// Allocates `byte_size` bytes aligned to `MIN_ALIGN`.
+inline auto sysAlloc(usize byte_size) noexcept -> void* {
+  void* ptr = nullptr;
+  if (posix_memalign(&ptr, MIN_ALIGN, byte_size) != 0) {
+    return nullptr;
+  }
+  return ptr;
+}
+
+} // namespace
+
+namespace internal {
+
+/// The heap shared by all threads, which thread caches refill from.
+struct ThreadSafeHeap {
+  struct SizeClass {
+    std::mutex mutex;
+
+    /// Stack of full batches (linked through `Block::next_batch`).
+    Block*     batches     = nullptr;
+
+    /// Blocks that did not make up a full batch.
+    Block*     loose       = nullptr;
+    usize      loose_count = 0;
+
+    /// The uncarved part of the most recent chunk of this class.
+    u8*        bump        = nullptr;
+    u8*        bump_end    = nullptr;
+  };
+
+  explicit ThreadSafeHeap(u64 id) : id{id} {}
+  ThreadSafeHeap(const ThreadSafeHeap& other)            = delete;
+  ThreadSafeHeap& operator=(const ThreadSafeHeap& other) = delete;
+
+  ~ThreadSafeHeap() {
+    ChunkHeader* chunk = this->chunks;
+    while (chunk != nullptr) {
+      ChunkHeader* next = chunk->next;
+      std::free(chunk);
+      chunk = next;
+    }
+  }
+
+  /// Takes a batch of free blocks of `size_class`, returning the number of
+  /// blocks in the batch.
+  auto fetch(usize size_class, Block** head) noexcept -> usize {
+    SizeClass&                        cls   = this->classes[size_class];
+    usize                             batch = batchSize(size_class);
+    const std::lock_guard<std::mutex> lock(cls.mutex);
+
+    if (cls.batches != nullptr) {
+      *head       = cls.batches;
+      cls.batches = cls.batches->next_batch;
+      return batch;
+    }
+
+    if (cls.loose != nullptr) {
+      Block* tail  = cls.loose;
+      usize  count = 1;
+      while ((count < batch) && (tail->next != nullptr)) {
+        tail = tail->next;
+        count++;
+      }
+      *head            = cls.loose;
+      cls.loose        = tail->next;
+      cls.loose_count -= count;
+      tail->next       = nullptr;
+      return count;
+    }
+
+    usize size = classSize(size_class);
+    if (static_cast<usize>(cls.bump_end - cls.bump) < size) {
+      ChunkHeader* chunk =
+          reinterpret_cast<ChunkHeader*>(sysAlloc(CHUNK_SIZE));
+      if (chunk == nullptr) {
+        *head = nullptr;
+        return 0;
+      }
+      {
+        const std::lock_guard<std::mutex> chunks_lock(this->chunks_mutex);
+        chunk->next  = this->chunks;
+        this->chunks = chunk;
+      }
+      cls.bump     = reinterpret_cast<u8*>(chunk) + CHUNK_HEADER_SIZE;
+      cls.bump_end = reinterpret_cast<u8*>(chunk) + CHUNK_SIZE;
+    }
+
+    // Carve a fresh batch
+    usize available = static_cast<usize>(cls.bump_end - cls.bump) / size;
+    usize count     = available < batch ? available : batch;
+    *head           = reinterpret_cast<Block*>(cls.bump);
+    for (usize i = 0; i < count; i++) {
+      Block* block = reinterpret_cast<Block*>(cls.bump);
+      cls.bump    += size;
+      block->next  = (i + 1 == count) ? nullptr
+                                      : reinterpret_cast<Block*>(cls.bump);
+    }
+    return count;
+  }
+
+  /// Gives a full batch of blocks back to the heap.
+  auto releaseBatch(usize size_class, Block* batch) noexcept -> void {
+    SizeClass&                        cls = this->classes[size_class];
+    const std::lock_guard<std::mutex> lock(cls.mutex);
+    batch->next_batch = cls.batches;
+    cls.batches       = batch;
+  }
+
+  /// Gives a list of `count` blocks ending in `tail` back to the heap.
+  auto releaseLoose(usize size_class, Block* head, Block* tail,
+                    usize count) noexcept -> void {
+    SizeClass&                        cls = this->classes[size_class];
+    const std::lock_guard<std::mutex> lock(cls.mutex);
+    tail->next       = cls.loose;
+    cls.loose        = head;
+    cls.loose_count += count;
+  }
+
+  u64          id;
+  std::mutex   chunks_mutex;
+  ChunkHeader* chunks = nullptr;
+  SizeClass    classes[NUM_CLASSES];
+};
+
+} // namespace internal
+
+namespace {
+
+using internal::ThreadSafeHeap;
+
+/// A thread's cache of free blocks for a single allocator.
+struct ThreadCache {
+  struct FreeList {
+    Block* head  = nullptr;
+    usize  count = 0;
+  };
+
+  /// Returns all cached blocks to the heap (if it is still alive).
+  auto flush() noexcept -> void {
+    if (std::shared_ptr<ThreadSafeHeap> owner = this->heap.lock()) {
+      for (usize c = 0; c < NUM_CLASSES; c++) {
+        FreeList& list = this->lists[c];
+        if (list.head == nullptr) {
+          continue;
+        }
+        Block* tail = list.head;
+        while (tail->next != nullptr) {
+          tail = tail->next;
+        }
+        owner->releaseLoose(c, list.head, tail, list.count);
+      }
+    }
+    *this = ThreadCache{};
+  }
+
+  u64                           id = 0;
+  std::weak_ptr<ThreadSafeHeap> heap;
+  FreeList                      lists[NUM_CLASSES];
+};
+
+/// The caches of the current thread, one per allocator it has used.
+struct CacheTable {
+  CacheTable() = default;
+  CacheTable(const CacheTable& other)            = delete;
+  CacheTable& operator=(const CacheTable& other) = delete;
+
+  ~CacheTable() {
+    for (ThreadCache& cache : this->caches) {
+      cache.flush();
+    }
+  }
+
+  auto get(const std::shared_ptr<ThreadSafeHeap>& heap) noexcept
+      -> ThreadCache* {
+    if ((this->last != nullptr) && (this->last->id == heap->id)) {
+      return this->last;
+    }
+
+    ThreadCache* slot = nullptr;
+    for (ThreadCache& cache : this->caches) {
+      if (cache.id == heap->id) {
+        this->last = &cache;
+        return this->last;
+      }
+      if ((slot == nullptr) && ((cache.id == 0) || cache.heap.expired())) {
+        slot = &cache;
+      }
+    }
+
+    // Evict a cache in round-robin order if all slots are in use
+    if (slot == nullptr) {
+      slot             = &this->caches[this->next_evict];
+      this->next_evict = (this->next_evict + 1) % MAX_CACHES;
+    }
+    slot->flush();
+    slot->id   = heap->id;
+    slot->heap = heap;
+    this->last = slot;
+    return slot;
+  }
+
+  ThreadCache  caches[MAX_CACHES];
+  ThreadCache* last       = nullptr;
+  usize        next_evict = 0;
+};
+
+thread_local CacheTable cache_table;
+std::atomic<u64>        next_heap_id{1};
+
+} // namespace
+
+ThreadSafeAllocator::ThreadSafeAllocator()
+    : heap{std::make_shared<ThreadSafeHeap>(
+          next_heap_id.fetch_add(1, std::memory_order_relaxed))} {}
+
+ThreadSafeAllocator::~ThreadSafeAllocator() = default;
+
+auto ThreadSafeAllocator::alloc_fn(usize byte_size,
+                                   usize /*align*/) noexcept -> void* {
+  if (byte_size > MAX_SMALL_SIZE) {
+    return sysAlloc(byte_size);
+  }
+
+  usize                  size_class = classOf(byte_size);
+  ThreadCache::FreeList& list = cache_table.get(this->heap)->lists[size_class];
+  if (list.head == nullptr) {
+    list.count = this->heap->fetch(size_class, &list.head);
+    if (list.head == nullptr) {
+      return nullptr;
+    }
+  }
+  Block* block = list.head;
+  list.head    = block->next;
+  list.count--;
+  return block;
+}
+
+auto ThreadSafeAllocator::free_fn(void* ptr, usize byte_size,
+                                  usize /*align*/) noexcept -> void {
+  // The size class follows from the size, so no block header is needed
+  if (byte_size > MAX_SMALL_SIZE) {
+    std::free(ptr);
+    return;
+  }
+
+  usize                  size_class = classOf(byte_size);
+  ThreadCache::FreeList& list = cache_table.get(this->heap)->lists[size_class];
+  Block*                 block = reinterpret_cast<Block*>(ptr);
+  block->next                  = list.head;
+  list.head                    = block;
+  list.count++;
+
+  // Give a batch back to the heap once the cache holds too many blocks
+  usize batch = batchSize(size_class);
+  if (list.count >= 2 * batch) {
+    Block* tail = list.head;
+    for (usize i = 1; i < batch; i++) {
+      tail = tail->next;
+    }
+    Block* batch_head  = list.head;
+    list.head          = tail->next;
+    list.count        -= batch;
+    tail->next         = nullptr;
+    this->heap->releaseBatch(size_class, batch_head);
+  }
+}
+
+auto ThreadSafeAllocator::resize_fn(void* /*ptr*/, usize old_size,
+                                    usize new_size,
+                                    usize /*align*/) noexcept -> bool {
+  // Blocks can be resized as long as they stay in the same size class, so
+  // that they are freed to the right class
+  if (old_size > MAX_SMALL_SIZE) {
+    return (new_size > MAX_SMALL_SIZE) && (new_size <= old_size);
+  }
+  return (new_size <= MAX_SMALL_SIZE) &&
+         (classOf(new_size) == classOf(old_size));
+}
+
+auto ThreadSafeAllocator::native_align_fn() const noexcept -> usize {
+  return MIN_ALIGN;
+}
+
+} // namespace mu::mem
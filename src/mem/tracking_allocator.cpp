@@ -0,0 +1,136 @@
+#include "mu/mem/tracking_allocator.h"
+
+#include "mu/io/writer.h"  // Writer
+#include "mu/primitives.h" // usize, u64
+#include <atomic>          // atomic, memory_order_relaxed
+#include <bit>             // bit_width
+#include <cinttypes>       // PRIu64
+#include <limits>          // numeric_limits
+
+namespace mu::mem {
+
+static constexpr std::memory_order RELAXED = std::memory_order_relaxed;
+
+auto TrackingAllocator::sizeClass(usize byte_size) noexcept -> usize {
+  return byte_size == 0 ? 0 : static_cast<usize>(std::bit_width(byte_size)) - 1;
+}
+
+auto TrackingAllocator::stats() const noexcept -> Stats {
+  Stats stats{};
+  stats.allocs     = this->allocs.load(RELAXED);
+  stats.frees      = this->frees.load(RELAXED);
+  stats.resizes    = this->resizes.load(RELAXED);
+  stats.failures   = this->failures.load(RELAXED);
+  stats.live_bytes = this->live_bytes.load(RELAXED);
+  stats.peak_bytes = this->peak_bytes.load(RELAXED);
+  for (usize i = 0; i < NUM_SIZE_CLASSES; i++) {
+    stats.histogram[i] = this->histogram[i].load(RELAXED);
+  }
+  return stats;
+}
+
+auto TrackingAllocator::reset() noexcept -> void {
+  this->allocs.store(0, RELAXED);
+  this->frees.store(0, RELAXED);
+  this->resizes.store(0, RELAXED);
+  this->failures.store(0, RELAXED);
+  this->peak_bytes.store(this->live_bytes.load(RELAXED), RELAXED);
+  for (usize i = 0; i < NUM_SIZE_CLASSES; i++) {
+    this->histogram[i].store(0, RELAXED);
+  }
+}
+
+auto TrackingAllocator::dump(io::Writer& writer) const -> void {
+  Stats stats = this->stats();
+  writer.format("TrackingAllocator {\n");
+  writer.format("  allocs     = %" PRIu64 "\n", stats.allocs);
+  writer.format("  frees      = %" PRIu64 "\n", stats.frees);
+  writer.format("  live       = %" PRIu64 "\n", stats.liveAllocs());
+  writer.format("  resizes    = %" PRIu64 "\n", stats.resizes);
+  writer.format("  failures   = %" PRIu64 "\n", stats.failures);
+  writer.format("  live_bytes = %zu\n", stats.live_bytes);
+  writer.format("  peak_bytes = %zu\n", stats.peak_bytes);
+  writer.format("  histogram  = {\n");
+  for (usize i = 0; i < NUM_SIZE_CLASSES; i++) {
+    if (stats.histogram[i] != 0) {
+      writer.format("    [2^%zu, 2^%zu) = %" PRIu64 "\n", i, i + 1,
+                    stats.histogram[i]);
+    }
+  }
+  writer.format("  }\n}\n");
+}
+
+auto TrackingAllocator::track(void* ptr, usize byte_size) noexcept -> void* {
+  if (ptr == nullptr) {
+    this->failures.fetch_add(1, RELAXED);
+    return nullptr;
+  }
+  this->allocs.fetch_add(1, RELAXED);
+  this->histogram[sizeClass(byte_size)].fetch_add(1, RELAXED);
+  this->grow(byte_size);
+  return ptr;
+}
+
+auto TrackingAllocator::trackResize(usize old_size,
+                                    usize new_size) noexcept -> void {
+  this->resizes.fetch_add(1, RELAXED);
+  if (new_size > old_size) {
+    this->grow(new_size - old_size);
+  } else {
+    this->live_bytes.fetch_sub(old_size - new_size, RELAXED);
+  }
+}
+
+auto TrackingAllocator::grow(usize byte_size) noexcept -> void {
+  usize live = this->live_bytes.fetch_add(byte_size, RELAXED) + byte_size;
+  usize peak = this->peak_bytes.load(RELAXED);
+  while ((live > peak) &&
+         !this->peak_bytes.compare_exchange_weak(peak, live, RELAXED)) {
+  }
+}
+
+auto TrackingAllocator::alloc_fn(usize byte_size,
+                                 usize align) noexcept -> void* {
+  return this->track(this->backing->rawAlloc(byte_size, align), byte_size);
+}
+
+auto TrackingAllocator::alloc_zeroed_fn(usize byte_size,
+                                        usize align) noexcept -> void* {
+  return this->track(this->backing->rawAllocZeroed(byte_size, align),
+                     byte_size);
+}
+
+auto TrackingAllocator::free_fn(void* ptr, usize byte_size,
+                                usize align) noexcept -> void {
+  this->frees.fetch_add(1, RELAXED);
+  this->live_bytes.fetch_sub(byte_size, RELAXED);
+  this->backing->rawFree(ptr, byte_size, align);
+}
+
+auto TrackingAllocator::native_align_fn() const noexcept -> usize {
+  // Every alignment is forwarded to the backing allocator
+  return std::numeric_limits<usize>::max();
+}
+
+auto TrackingAllocator::resize_fn(void* ptr, usize old_size, usize new_size,
+                                  usize align) noexcept -> bool {
+  if (!this->backing->rawResize(ptr, old_size, new_size, align)) {
+    return false;
+  }
+  this->trackResize(old_size, new_size);
+  return true;
+}
+
+auto TrackingAllocator::remap_fn(void* ptr, usize old_size, usize new_size,
+                                 usize align) noexcept -> void* {
+  // Only the backing allocator's cheap paths: otherwise `rawRealloc` falls
+  // back to `alloc_fn` (which counts the failure, if there is one), so the
+  // backing allocator is never asked for the new block twice
+  void* res = this->backing->rawRemap(ptr, old_size, new_size, align);
+  if (res != nullptr) {
+    this->trackResize(old_size, new_size);
+  }
+  return res;
+}
+
+} // namespace mu::mem
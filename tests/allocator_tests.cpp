@@ -5,6 +5,8 @@
 #include "mu/slice.h"
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 using namespace mu;
 
@@ -24,46 +26,105 @@ struct Dbgl : Debug<Dbgl> {
   int                          val = NUM;
 };
 
+/// An allocator that never returns aligned memory, to exercise the alignment
+/// header.
+class MisalignedAllocator : public mem::Allocator {
+  auto alloc_fn(usize byte_size, usize /*align*/) noexcept -> void* override {
+    u8* ptr = reinterpret_cast<u8*>(std::malloc(byte_size + 1));
+    return ptr == nullptr ? nullptr : ptr + 1;
+  }
+
+  auto free_fn(void* ptr, usize /*byte_size*/,
+               usize /*align*/) noexcept -> void override {
+    std::free(reinterpret_cast<u8*>(ptr) - 1);
+  }
+};
+
+static auto isAligned(void* ptr, usize align) -> bool {
+  return (reinterpret_cast<usize>(ptr) % align) == 0;
+}
+
 int main(void) {
   mem::CAllocator allocator{};
 
   {
-    Tst* val     = allocator.create<Tst>();
-    u8*  aligned = reinterpret_cast<u8*>(val);
-    u8*  offset  = aligned - alignof(Tst);
-    u8*  alloced = aligned - *offset;
-    assert((reinterpret_cast<u8*>(val) - alloced) == alignof(Tst));
+    Tst* val = allocator.create<Tst>();
+    assert(isAligned(val, alignof(Tst)));
     allocator.destroy(val);
   }
 
   {
-    int* val     = allocator.create<int>();
-    u8*  aligned = reinterpret_cast<u8*>(val);
-    u8*  offset  = aligned - alignof(int);
-    u8*  alloced = aligned - *offset;
-    assert((reinterpret_cast<u8*>(val) - alloced) == alignof(int));
+    int* val = allocator.create<int>();
+    assert(isAligned(val, alignof(int)));
     allocator.destroy(val);
   }
 
   {
-    constexpr u8 alignment = 16;
-    Slice<int>   val       = allocator.allocAligned<int>(2, alignment);
-    u8*          aligned   = reinterpret_cast<u8*>(val.ptr());
-    u8*          offset    = aligned - alignment;
-    u8*          alloced   = aligned - *offset;
-    assert((reinterpret_cast<u8*>(val.ptr()) - alloced) == alignment);
+    // Page and huge page alignments are served natively
+    constexpr usize PAGE      = 4096;
+    constexpr usize HUGE_PAGE = 2 * 1024 * 1024;
+    Slice<char>     page      = allocator.allocAligned<char>(100, PAGE);
+    Slice<f64>      huge      = allocator.allocAligned<f64>(8, HUGE_PAGE);
+    assert(isAligned(page.ptr(), PAGE));
+    assert(isAligned(huge.ptr(), HUGE_PAGE));
+    assert(huge.align() == HUGE_PAGE);
+    allocator.free(huge);
+    allocator.free(page);
+  }
+
+  {
+    // Zeroed allocations are zeroed even when reusing freed memory
+    for (usize align : {usize{8}, usize{64}, usize{4096}}) {
+      Slice<char> dirty = allocator.allocUninit<char>(4096, align);
+      std::memset(dirty.ptr(), 0xFF, dirty.len());
+      allocator.free(dirty);
+
+      Slice<u64> zeroed = allocator.allocZeroed<u64>(512, align);
+      assert(isAligned(zeroed.ptr(), align));
+      for (usize i = 0; i < zeroed.len(); i++) {
+        assert(zeroed[i] == 0);
+      }
+      allocator.free(zeroed);
+
+      MisalignedAllocator misaligned{};
+      Slice<u32>          header = misaligned.allocZeroed<u32>(100, align);
+      assert(isAligned(header.ptr(), align));
+      assert((header[0] == 0) && (header[99] == 0));
+      misaligned.free(header);
+    }
+  }
+
+  {
+    // Backends without native alignment store the offset in a header
+    MisalignedAllocator misaligned{};
+    for (usize align = 1; align <= 8192; align *= 2) {
+      Slice<char> val = misaligned.allocAligned<char>(3, align);
+      assert(isAligned(val.ptr(), align));
+      val[2] = 'x';
+      val    = misaligned.realloc(val, 5000);
+      assert(isAligned(val.ptr(), align));
+      assert(val[2] == 'x');
+      misaligned.free(val);
+    }
+  }
+
+  {
+    constexpr usize alignment = 16;
+    Slice<int>      val       = allocator.allocAligned<int>(2, alignment);
+    assert(isAligned(val.ptr(), alignment));
 
     auto xxx = Dbgl{};
     dbg(xxx);
 
     // Testing slice
+    val[0] = 1;
+    val[1] = 2;
+    dbg(val);
+    dbg(val[0]);
+    assert(val[0] == 1); // Doesn't throw
+    assert(val[1] == 2); // Doesn't throw
+#ifndef MU_SLICE_UNCHECKED
     try {
-      val[0] = 1;
-      val[1] = 2;
-      dbg(val);
-      dbg(val[0]);
-      assert(val[0] == 1);         // Doesn't throw
-      assert(val[1] == 2);         // Doesn't throw
       printf("Error: %d", val[3]); // Throws error
     } catch (common::IndexOutOfBounds& e) {
       const usize BUFSIZE = 128;
@@ -74,6 +135,35 @@ int main(void) {
       written             = fprintf(stderr, "%s", str);
       assert(written != 0);
     }
+#endif
+    allocator.free(val);
+  }
+
+  {
+    // Growing and shrinking keeps the contents
+    Slice<int> val = allocator.alloc<int>(4);
+    for (usize i = 0; i < val.len(); i++) {
+      val[i] = static_cast<int>(i);
+    }
+    val = allocator.realloc(val, 1024);
+    assert(val.len() == 1024);
+    assert(val[3] == 3);
+    val = allocator.realloc(val, 2);
+    assert(val.len() == 2);
+    assert(val[1] == 1);
+    allocator.free(val);
+  }
+
+  {
+    // Over-aligned reallocations stay aligned
+    constexpr usize alignment = 64;
+    Slice<u64>      val       = allocator.allocAligned<u64>(3, alignment);
+    val[2]                    = 42;
+    for (usize len = 8; len <= 4096; len *= 2) {
+      val = allocator.realloc(val, len);
+      assert((reinterpret_cast<usize>(val.ptr()) % alignment) == 0);
+      assert(val[2] == 42);
+    }
     allocator.free(val);
   }
 
@@ -0,0 +1,139 @@
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstddef>
+
+using namespace mu;
+
+struct Tst {
+  int  x;
+  int  y;
+  int  z;
+  bool b;
+};
+
+static auto isAligned(void* ptr, usize align) -> bool {
+  return (reinterpret_cast<usize>(ptr) % align) == 0;
+}
+
+static auto bumpAllocations() -> void {
+  mem::CAllocator     backing{};
+  mem::ArenaAllocator arena{&backing, 1024};
+
+  Tst*                a = arena.create<Tst>();
+  Tst*                b = arena.create<Tst>();
+  assert(a != b);
+  assert(isAligned(a, alignof(Tst)));
+  assert(isAligned(b, alignof(Tst)));
+  a->x = 1;
+  b->x = 2;
+  assert(a->x == 1);
+
+  Slice<u64> slice = arena.allocAligned<u64>(4, 64);
+  assert(isAligned(slice.ptr(), 64));
+  slice[3] = 42;
+  assert(slice[3] == 42);
+
+  Slice<u64> page = arena.allocAligned<u64>(4, 4096);
+  assert(isAligned(page.ptr(), 4096));
+
+  // Larger than a chunk
+  Slice<char> big = arena.alloc<char>(4096);
+  assert(big.len() == 4096);
+  assert(arena.capacity() >= 4096 + 1024);
+}
+
+static auto checkpointRollback() -> void {
+  mem::CAllocator     backing{};
+  mem::ArenaAllocator arena{&backing, 256};
+
+  int*                first = arena.create<int>();
+  *first                    = 7;
+  auto checkpoint           = arena.checkpoint();
+  int* second               = arena.create<int>();
+  for (usize i = 0; i < 64; i++) {
+    arena.alloc<u64>(8); // Spills into new chunks
+  }
+  usize cap = arena.capacity();
+  arena.rollback(checkpoint);
+  int* third = arena.create<int>();
+  assert(third == second);
+  assert(*first == 7);
+
+  // Chunks are reused after rollback
+  for (usize i = 0; i < 64; i++) {
+    arena.alloc<u64>(8);
+  }
+  assert(arena.capacity() == cap);
+}
+
+static auto resetAndFreeLast() -> void {
+  mem::CAllocator     backing{};
+  mem::ArenaAllocator arena{&backing};
+
+  int*                a = arena.create<int>();
+  int*                b = arena.create<int>();
+  arena.destroy(a); // Not the last allocation: no-op
+  arena.destroy(b); // Last allocation: given back
+  int* c = arena.create<int>();
+  assert(c == b);
+
+  arena.reset();
+  int* d = arena.create<int>();
+  assert(d == a);
+
+  arena.release();
+  assert(arena.capacity() == 0);
+  int* e = arena.create<int>();
+  *e     = 3;
+  assert(*e == 3);
+}
+
+static auto freeInReverse() -> void {
+  mem::CAllocator     backing{};
+  mem::ArenaAllocator arena{&backing};
+
+  Slice<u64>          a = arena.alloc<u64>(3);
+  Slice<u64>          b = arena.alloc<u64>(5);
+  Slice<u64>          c = arena.alloc<u64>(7);
+
+  // Frees in reverse order of allocation give everything back
+  arena.free(c);
+  arena.free(b);
+  arena.free(a);
+  Slice<u64> d = arena.alloc<u64>(3);
+  assert(d.ptr() == a.ptr());
+}
+
+static auto resizeLast() -> void {
+  mem::CAllocator     backing{};
+  mem::ArenaAllocator arena{&backing, 1024};
+
+  Slice<u32>          a = arena.alloc<u32>(4);
+  a[3]                  = 3;
+  assert(arena.resize(a, 64));
+  assert(a.len() == 64);
+  assert(a[3] == 3);
+
+  // Only the most recent allocation can grow in place
+  Slice<u32> b = arena.alloc<u32>(4);
+  assert(!arena.resize(a, 128));
+  Slice<u32> moved = arena.realloc(a, 128);
+  assert(moved.ptr() != a.ptr());
+  assert(moved[3] == 3);
+
+  // Shrinking always works
+  assert(arena.resize(b, 2));
+  assert(b.len() == 2);
+}
+
+int main(void) {
+  bumpAllocations();
+  checkpointRollback();
+  resetAndFreeLast();
+  freeInReverse();
+  resizeLast();
+  return 0;
+}
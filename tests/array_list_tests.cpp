@@ -0,0 +1,186 @@
+#include "mu/array_list.h"
+#include "mu/mem/allocator.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/mem/unique_ptr.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <string>
+#include <utility>
+
+using namespace mu;
+
+/// Counts the live instances, to check that items are moved and destroyed.
+struct Counted {
+  static inline i64 live = 0;
+
+  u64               val;
+
+  explicit Counted(u64 val) : val{val} { live++; }
+  Counted(const Counted& other) : val{other.val} { live++; }
+  Counted(Counted&& other) noexcept : val{other.val} { live++; }
+  ~Counted() { live--; }
+};
+
+static auto appendAndIndex() -> void {
+  ArrayList<u64> list{};
+  for (u64 i = 0; i < 1000; i++) {
+    list.append(i);
+  }
+  assert(list.len() == 1000);
+  assert(list.capacity() >= 1000);
+  for (u64 i = 0; i < 1000; i++) {
+    assert(list[i] == i);
+  }
+
+  Slice<u64> items = list.items();
+  assert(items.len() == 1000);
+  assert(items[999] == 999);
+
+  bool threw = false;
+  try {
+    list[1000];
+  } catch (const common::IndexOutOfBounds&) {
+    threw = true;
+  }
+  assert(threw);
+
+  assert(list.pop().unwrap() == 999);
+  list.clear();
+  assert(list.len() == 0);
+  assert(!list.pop().isValid());
+}
+
+static auto appendSliceAndRemove() -> void {
+  u64            src[] = {1, 2, 3, 4, 5};
+  ArrayList<u64> list{};
+  list.appendSlice(Slice<u64>(src, 5));
+  list.appendSlice(Slice<u64>(src, 5));
+  assert(list.len() == 10);
+  assert(list[7] == 3);
+
+  list.insert(0, 0);
+  list.insert(11, 6);
+  assert(list[0] == 0);
+  assert(list[1] == 1);
+  assert(list[11] == 6);
+
+  assert(list.orderedRemove(1) == 1);
+  assert(list[1] == 2);
+  assert(list.swapRemove(0) == 0);
+  assert(list[0] == 6);
+  assert(list.len() == 10);
+}
+
+static auto ensureCapacity() -> void {
+  ArrayList<u32> list = ArrayList<u32>::withCapacity(nullptr, 100);
+  assert(list.capacity() >= 100);
+  u32* first = list.begin();
+  for (u32 i = 0; i < 100; i++) {
+    list.append(i);
+  }
+  assert(list.begin() == first);
+
+  list.ensureUnusedCapacity(1000);
+  assert(list.capacity() >= 1100);
+  assert(list[99] == 99);
+}
+
+static auto nonTrivialItems() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    ArrayList<Counted, mem::Allocator> list{&tracking};
+    for (u64 i = 0; i < 100; i++) {
+      list.emplace(i);
+    }
+    assert(Counted::live == 100);
+
+    // Growing moves the items without leaking any
+    list.ensureCapacity(10000);
+    assert(Counted::live == 100);
+    assert(list[42].val == 42);
+
+    list.insert(0, Counted(1000));
+    assert(list[0].val == 1000);
+    assert(list[1].val == 0);
+    assert(list.orderedRemove(0).val == 1000);
+    assert(list.swapRemove(0).val == 0);
+    assert(list[0].val == 99);
+    assert(Counted::live == 99);
+
+    // The popped item is destroyed once, by the `Optional`
+    assert(list.pop().unwrap().val == 98);
+    assert(Counted::live == 98);
+
+    auto moved = std::move(list);
+    assert(list.len() == 0);
+    assert(moved.len() == 98);
+    assert(Counted::live == 98);
+  }
+  assert(Counted::live == 0);
+  assert(tracking.stats().live_bytes == 0);
+
+  {
+    ArrayList<std::string, mem::Allocator> list{&tracking};
+    for (usize i = 0; i < 10; i++) {
+      // Long enough to be heap-allocated
+      list.append(std::string(32, char('a' + i)));
+    }
+    assert(list.pop().unwrap() == std::string(32, 'j'));
+    std::string popped = list.pop().unwrap();
+    assert(popped == std::string(32, 'i'));
+    assert(list.len() == 8);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto toOwnedSlice() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    ArrayList<u64, mem::Allocator> list{&tracking};
+    for (u64 i = 0; i < 100; i++) {
+      list.append(i);
+    }
+
+    // The buffer is shrunk to fit, and handed over
+    UniquePtr<Slice<u64>, mem::Allocator> owned = list.toOwnedSlice();
+    assert(owned.get().len() == 100);
+    assert(owned[99] == 99);
+    assert(list.len() == 0);
+    assert(list.capacity() == 0);
+    assert(tracking.stats().live_bytes == 100 * sizeof(u64));
+  }
+  assert(tracking.stats().live_bytes == 0);
+
+  // Static allocators don't need an allocator pointer
+  ArrayList<u64>                         list{};
+  list.append(1);
+  UniquePtr<Slice<u64>, mem::CAllocator> owned = list.toOwnedSlice();
+  assert(owned[0] == 1);
+}
+
+static auto resizeInPlace() -> void {
+  // The arena can grow its last allocation, so growing doesn't move the items
+  mem::CAllocator                backing{};
+  mem::ArenaAllocator            arena{&backing};
+  ArrayList<u64, mem::Allocator> list{&arena};
+  list.append(1);
+  u64* first = list.begin();
+  list.ensureCapacity(1000);
+  assert(list.begin() == first);
+  assert(list[0] == 1);
+}
+
+int main(void) {
+  appendAndIndex();
+  appendSliceAndRemove();
+  ensureCapacity();
+  nonTrivialItems();
+  toOwnedSlice();
+  resizeInPlace();
+  return 0;
+}
@@ -0,0 +1,281 @@
+#include "mu/btree_map.h"
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace mu;
+
+/// Small nodes, so that the tests build deep trees.
+template <typename K, typename V, class Less = std::less<K>>
+using SmallMap = BTreeMap<K, V, mem::Allocator, Less, 128>;
+
+/// Compares without a scan (so the binary search is used).
+struct Greater {
+  auto operator()(u64 lhs, u64 rhs) const noexcept -> bool {
+    return lhs > rhs;
+  }
+};
+
+/// Checks that `map` holds exactly the entries of `expected`, in order.
+template <typename Map, typename Expected>
+static auto sameEntries(const Map& map, const Expected& expected) -> void {
+  assert(map.len() == expected.size());
+  auto it = expected.begin();
+  for (auto entry : map) {
+    assert(it != expected.end());
+    assert(entry.key == it->first);
+    assert(entry.val == it->second);
+    ++it;
+  }
+  assert(it == expected.end());
+}
+
+static auto putGetRemove() -> void {
+  BTreeMap<u64, u64> map{};
+  assert(map.get(1) == nullptr);
+  assert(!map.remove(1));
+  assert(map.begin() == map.end());
+
+  assert(map.put(2, 20));
+  assert(map.put(1, 10));
+  assert(!map.put(1, 11));
+  assert(map.len() == 2);
+  assert(*map.get(1) == 11);
+  assert(*map.get(2) == 20);
+  assert(map.contains(2));
+  assert(!map.contains(3));
+
+  assert(map.remove(1));
+  assert(!map.contains(1));
+  assert(map.len() == 1);
+
+  map.clear();
+  assert(map.len() == 0);
+  assert(!map.contains(2));
+  assert(map.put(3, 30));
+  assert(*map.get(3) == 30);
+}
+
+template <class Less> static auto matchesStdMap() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    SmallMap<u64, u64, Less> map{&tracking};
+    std::map<u64, u64, Less> expected{};
+    u64                      rng = 42;
+    for (usize i = 0; i < 100000; i++) {
+      rng     = rng * 6364136223846793005 + 1442695040888963407;
+      u64 key = (rng >> 33) % 3000;
+      // Grows the map for a while, then shrinks it
+      u64 op = (rng >> 20) % 8;
+      if ((i > 60000) && (op < 4)) {
+        op += 4;
+      }
+      if (op < 4) {
+        assert(map.put(key, i) == (expected.find(key) == expected.end()));
+        expected[key] = i;
+      } else if (op < 7) {
+        assert(map.remove(key) == (expected.erase(key) == 1));
+      } else {
+        auto found = expected.find(key);
+        assert((found == expected.end()) ? (map.get(key) == nullptr)
+                                         : (*map.get(key) == found->second));
+      }
+    }
+    sameEntries(map, expected);
+
+    for (auto& [key, val] : expected) {
+      assert(map.remove(key));
+    }
+    assert(map.len() == 0);
+    assert(map.begin() == map.end());
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto ranges() -> void {
+  mem::CAllocator    backing{};
+  SmallMap<u64, u64> map{&backing};
+  for (u64 i = 0; i < 1000; i++) {
+    map.put(i * 2, i);
+  }
+
+  // Odd bounds fall between keys
+  u64 expected = 101;
+  for (auto entry : map.range(201, 401)) {
+    assert(entry.key == expected * 2);
+    entry.val++;
+    expected++;
+  }
+  assert(expected == 201);
+  assert(*map.get(202) == 102);
+
+  const SmallMap<u64, u64>& view = map;
+  assert(view.range(300, 300).begin() == view.range(300, 300).end());
+  assert(view.range(5000, 6000).begin() == view.end());
+  assert((*view.lowerBound(0)).key == 0);
+  assert((*view.lowerBound(1997)).key == 1998);
+  assert(view.lowerBound(1999) == view.end());
+
+  usize count = 0;
+  for (auto entry : view.range(0, 2000)) {
+    assert(entry.key == count * 2);
+    count++;
+  }
+  assert(count == 1000);
+}
+
+static auto fromSorted() -> void {
+  using Map = SmallMap<u64, u64>;
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+
+  // Sizes around the node capacities
+  for (usize len : {0, 1, 5, 6, 7, 13, 50, 100, 1000, 12345}) {
+    std::vector<Map::Entry> entries{};
+    std::map<u64, u64>      expected{};
+    for (u64 i = 0; i < len; i++) {
+      entries.push_back(Map::Entry{i * 3, i});
+      expected[i * 3] = i;
+    }
+    {
+      Map map = Map::fromSorted(
+          &tracking, Slice<Map::Entry>(entries.data(), entries.size()));
+      sameEntries(map, expected);
+
+      // The bulk loaded tree must keep working
+      for (u64 i = 0; i < len; i += 2) {
+        assert(map.remove(i * 3));
+        expected.erase(i * 3);
+      }
+      for (u64 i = 0; i < len; i += 3) {
+        map.put(i * 3 + 1, i);
+        expected[i * 3 + 1] = i;
+      }
+      sameEntries(map, expected);
+    }
+    assert(tracking.stats().live_bytes == 0);
+  }
+}
+
+/// Fails every allocation after the first `remaining`.
+struct FailingAllocator : public mem::Allocator {
+  mem::Allocator* backing;
+  usize           remaining;
+
+  FailingAllocator(mem::Allocator* backing, usize remaining)
+      : backing{backing}, remaining{remaining} {}
+
+private:
+  auto alloc_fn(usize byte_size, usize align) -> void* override {
+    if (this->remaining == 0) {
+      return nullptr;
+    }
+    this->remaining--;
+    return this->backing->rawAlloc(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size, usize align) -> void override {
+    this->backing->rawFree(ptr, byte_size, align);
+  }
+};
+
+static auto fromSortedUnwinds() -> void {
+  using Map = SmallMap<u64, u64>;
+  mem::CAllocator         backing{};
+  mem::TrackingAllocator  tracking{&backing};
+  std::vector<Map::Entry> entries{};
+  for (u64 i = 0; i < 1000; i++) {
+    entries.push_back(Map::Entry{i, i});
+  }
+  Slice<Map::Entry> slice(entries.data(), entries.size());
+
+  usize before = tracking.stats().allocs;
+  { Map map = Map::fromSorted(&tracking, slice); }
+  usize num_nodes = tracking.stats().allocs - before;
+
+  // Running out of memory at any node (leaf or inner) frees the ones built
+  for (usize limit = 0; limit < num_nodes; limit++) {
+    FailingAllocator failing{&tracking, limit};
+    bool             threw = false;
+    try {
+      Map map = Map::fromSorted(&failing, slice);
+    } catch (const common::OutOfMemoryException&) {
+      threw = true;
+    }
+    assert(threw);
+    assert(tracking.stats().live_bytes == 0);
+  }
+}
+
+static auto nonTrivialEntries() -> void {
+  using Map = BTreeMap<std::string, std::string, mem::Allocator>;
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    Map                                map{&tracking};
+    std::map<std::string, std::string> expected{};
+    for (u64 i = 0; i < 2000; i++) {
+      std::string key = "key number " + std::to_string(i * 7919 % 2000);
+      std::string val = "a value long enough to allocate " + std::to_string(i);
+      map.put(key, val);
+      expected[key] = val;
+    }
+    for (u64 i = 0; i < 2000; i += 3) {
+      std::string key = "key number " + std::to_string(i);
+      assert(map.remove(key));
+      expected.erase(key);
+    }
+    sameEntries(map, expected);
+
+    Map moved{std::move(map)};
+    assert(map.len() == 0);
+    sameEntries(moved, expected);
+    map = std::move(moved);
+    sameEntries(map, expected);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto pooledNodes() -> void {
+  using Map = BTreeMap<u64, u64, mem::Allocator>;
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    mem::PoolAllocator<Map::NodeBlock> pool{&tracking};
+    Map                                map{&pool};
+    for (u64 i = 0; i < 10000; i++) {
+      map.put(i, i);
+    }
+    usize allocs = tracking.stats().allocs;
+    for (u64 i = 0; i < 10000; i++) {
+      assert(map.remove(i));
+    }
+    for (u64 i = 0; i < 10000; i++) {
+      map.put(i, i);
+    }
+    // The freed nodes are reused
+    assert(tracking.stats().allocs == allocs);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+auto main() -> int {
+  putGetRemove();
+  matchesStdMap<std::less<u64>>();
+  matchesStdMap<Greater>();
+  ranges();
+  fromSorted();
+  fromSortedUnwinds();
+  nonTrivialEntries();
+  pooledNodes();
+  return 0;
+}
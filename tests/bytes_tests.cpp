@@ -0,0 +1,154 @@
+#include "mu/bytes.h"
+#include "mu/primitives.h"
+#include <cassert>
+#include <initializer_list>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace mu;
+using namespace mu::internal::bytes;
+
+static constexpr Isa ISAS[] = {Isa::Scalar, Isa::Sse2, Isa::Avx2,
+                               Isa::Avx512};
+
+/// Fills `buf` with bytes from a small alphabet, so that there are matches.
+static auto fill(char* buf, usize len, u64 seed) -> void {
+  u64 rng = seed;
+  for (usize i = 0; i < len; i++) {
+    rng    = rng * 6364136223846793005 + 1442695040888963407;
+    buf[i] = static_cast<char>('a' + (rng >> 59) % 20);
+  }
+}
+
+static auto naiveIndexOf(const char* ptr, usize len, char byte) -> usize {
+  usize i = 0;
+  while ((i < len) && (ptr[i] != byte)) {
+    i++;
+  }
+  return i;
+}
+
+/// Checks every kernel against a naive search, for all lengths (and
+/// alignments) up to a few vectors.
+static auto matchesNaive() -> void {
+  char       buf[512];
+  const char set[] = "xyz\xff-q";
+  for (u64 seed = 1; seed < 20; seed++) {
+    fill(buf, sizeof(buf), seed);
+    buf[(seed * 37) % sizeof(buf)] = '\xff'; // A byte with the sign bit set
+    for (Isa isa : ISAS) {
+      if (!isSupported(isa)) {
+        continue;
+      }
+      for (usize start = 0; start < 64; start += 7) {
+        for (usize len = 0; start + len <= sizeof(buf); len += 3) {
+          const char* ptr = buf + start;
+          for (char byte : {'a', 'e', 't', '\xff', '!'}) {
+            usize naive = naiveIndexOf(ptr, len, byte);
+            assert(indexOf(isa, ptr, len, byte) == naive);
+
+            usize matches = 0;
+            for (usize i = 0; i < len; i++) {
+              matches += (ptr[i] == byte);
+            }
+            assert(count(isa, ptr, len, byte) == matches);
+
+            u64 mask = 0;
+            for (usize i = 0; (i < len) && (i < 64); i++) {
+              mask |= u64(ptr[i] == byte) << i;
+            }
+            assert(matchMask(isa, ptr, len, byte) == mask);
+          }
+
+          for (usize set_len = 0; set_len <= 6; set_len++) {
+            usize naive = len;
+            for (usize i = 0; (i < len) && (naive == len); i++) {
+              for (usize s = 0; s < set_len; s++) {
+                naive = (ptr[i] == set[s]) ? i : naive;
+              }
+            }
+            assert(indexOfAny(isa, ptr, len, set, set_len) == naive);
+          }
+        }
+      }
+    }
+  }
+}
+
+static auto largeSets() -> void {
+  // Sets past the vector limit use a lookup table
+  char set[40];
+  for (usize i = 0; i < sizeof(set); i++) {
+    set[i] = static_cast<char>('0' + i); // '0' to 'W'
+  }
+  char buf[300];
+  fill(buf, sizeof(buf), 7);
+  buf[250] = 'W';
+  for (Isa isa : ISAS) {
+    if (isSupported(isa)) {
+      assert(indexOfAny(isa, buf, sizeof(buf), set, sizeof(set)) == 250);
+      assert(indexOfAny(isa, buf, sizeof(buf), set, 10) == sizeof(buf));
+    }
+  }
+}
+
+static auto longInputs() -> void {
+  // Counts need more than 255 vectors per lane
+  static char buf[100000];
+  for (usize i = 0; i < sizeof(buf); i++) {
+    buf[i] = ((i % 3) == 0) ? '\n' : 'x';
+  }
+  for (Isa isa : ISAS) {
+    if (isSupported(isa)) {
+      assert(count(isa, buf, sizeof(buf), '\n') == (sizeof(buf) + 2) / 3);
+      assert(indexOf(isa, buf, sizeof(buf), 'y') == sizeof(buf));
+    }
+  }
+}
+
+static auto pageBoundaries() -> void {
+  // The kernels must not read past the end, even into an unmapped page
+  usize page = static_cast<usize>(sysconf(_SC_PAGESIZE));
+  void* map  = mmap(nullptr, page * 2, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  assert(map != MAP_FAILED);
+  char* mem = static_cast<char*>(map);
+  assert(mprotect(mem + page, page, PROT_NONE) == 0);
+  for (usize i = 0; i < page; i++) {
+    mem[i] = 'x';
+  }
+
+  for (Isa isa : ISAS) {
+    if (!isSupported(isa)) {
+      continue;
+    }
+    for (usize len = 0; len <= 130; len++) {
+      const char* ptr = mem + page - len;
+      assert(indexOf(isa, ptr, len, 'y') == len);
+      assert(indexOfAny(isa, ptr, len, "yz", 2) == len);
+      assert(count(isa, ptr, len, 'x') == len);
+      assert(matchMask(isa, ptr, len, 'y') == 0);
+    }
+  }
+  munmap(map, page * 2);
+}
+
+static auto dispatch() -> void {
+  assert(isSupported(Isa::Scalar));
+  assert(isSupported(bestIsa()));
+
+  const char text[] = "hello, world";
+  assert(indexOf(text, 12, 'w') == 7);
+  assert(indexOfAny(text, 12, " ,", 2) == 5);
+  assert(count(text, 12, 'l') == 3);
+  assert(matchMask(text, 12, 'l') == 0b10000001100);
+}
+
+auto main() -> int {
+  matchesNaive();
+  largeSets();
+  longInputs();
+  pageBoundaries();
+  dispatch();
+  return 0;
+}
@@ -0,0 +1,178 @@
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/combinators.h"
+#include "mu/mem/page_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <tuple>
+#include <utility>
+
+using namespace mu;
+
+struct alignas(16) Small {
+  u8 bytes[32];
+};
+
+static auto fallback() -> void {
+  mem::CAllocator backing{};
+  mem::FallbackAllocator<mem::PoolAllocator<Small>, mem::CAllocator> allocator{
+      std::piecewise_construct, std::make_tuple(&backing, 4), std::tuple<>{}};
+
+  // Blocks that fit the pool come from it, everything else falls back
+  Small*     small = allocator.create<Small>();
+  Slice<u64> big   = allocator.alloc<u64>(100);
+  assert(allocator.primary().owns(small));
+  assert(!allocator.primary().owns(big.ptr()));
+
+  // Reallocating out of the pool moves the data to the secondary allocator
+  Slice<char> grown = allocator.alloc<char>(16);
+  assert(allocator.primary().owns(grown.ptr()));
+  grown[15] = 'x';
+  grown     = allocator.realloc(grown, 1000);
+  assert(!allocator.primary().owns(grown.ptr()));
+  assert(grown[15] == 'x');
+
+  allocator.free(grown);
+  allocator.free(big);
+  allocator.destroy(small);
+  Small* reused = allocator.create<Small>();
+  assert(reused == small);
+  allocator.destroy(reused);
+}
+
+static auto segregator() -> void {
+  using Allocator = mem::Segregator<256, mem::TrackingAllocator,
+                                    mem::TrackingAllocator>;
+  static_assert(mem::StaticAllocator<
+                mem::Segregator<64, mem::CAllocator, mem::CAllocator>>);
+  static_assert(!mem::StaticAllocator<Allocator>);
+
+  mem::CAllocator backing{};
+  Allocator       allocator{std::piecewise_construct, std::make_tuple(&backing),
+                      std::make_tuple(&backing)};
+
+  Slice<char>     small = allocator.alloc<char>(256);
+  Slice<char>     large = allocator.alloc<char>(257);
+  assert(allocator.small().stats().live_bytes == 256);
+  assert(allocator.large().stats().live_bytes == 257);
+
+  // Growing across the threshold moves the allocation
+  small[0] = 'a';
+  small    = allocator.realloc(small, 1024);
+  assert(small[0] == 'a');
+  assert(allocator.small().stats().live_bytes == 0);
+  assert(allocator.large().stats().live_bytes == 257 + 1024);
+
+  allocator.free(small);
+  allocator.free(large);
+  assert(allocator.large().stats().live_bytes == 0);
+}
+
+/// An allocator that fails every allocation larger than `limit`, counting
+/// the attempts.
+struct LimitedAllocator : public mem::Allocator {
+  mem::CAllocator backing{};
+  usize           limit;
+  usize           attempts = 0;
+
+  explicit LimitedAllocator(usize limit) : limit{limit} {}
+
+private:
+  auto alloc_fn(usize byte_size, usize align) -> void* override {
+    this->attempts++;
+    return byte_size > this->limit ? nullptr
+                                   : this->backing.rawAlloc(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size, usize align) -> void override {
+    this->backing.rawFree(ptr, byte_size, align);
+  }
+};
+
+static auto failedRealloc() -> void {
+  // A failed realloc asks the allocator that would hold the block once
+  LimitedAllocator backing{4096};
+  using Segregated = mem::Segregator<256, mem::TrackingAllocator,
+                                     mem::TrackingAllocator>;
+  Segregated segregated{std::piecewise_construct, std::make_tuple(&backing),
+                        std::make_tuple(&backing)};
+  void*      ptr = segregated.rawAlloc(300, 8);
+  backing.attempts = 0;
+  assert(segregated.rawRealloc(ptr, 300, 8192, 8) == nullptr);
+  assert(backing.attempts == 1);
+  assert(segregated.large().stats().failures == 1);
+  segregated.rawFree(ptr, 300, 8);
+
+  mem::CAllocator pool_backing{};
+  mem::FallbackAllocator<mem::PoolAllocator<Small>, LimitedAllocator> fallback{
+      std::piecewise_construct, std::make_tuple(&pool_backing, 4),
+      std::make_tuple(4096)};
+  ptr                           = fallback.rawAlloc(1000, 8);
+  fallback.secondary().attempts = 0;
+  assert(fallback.rawRealloc(ptr, 1000, 8192, 8) == nullptr);
+  assert(fallback.secondary().attempts == 1);
+  fallback.rawFree(ptr, 1000, 8);
+}
+
+static auto bucketizer() -> void {
+  using Allocator = mem::Bucketizer<mem::ArenaAllocator, 1, 256, 64>;
+  static_assert(Allocator::NUM_BUCKETS == 4);
+  static_assert(Allocator::bucketOf(64) == 0);
+  static_assert(Allocator::bucketOf(65) == 1);
+
+  mem::CAllocator backing{};
+  Allocator       allocator{&backing, usize{4096}};
+
+  Slice<char>     a = allocator.alloc<char>(10);
+  Slice<char>     b = allocator.alloc<char>(100);
+  Slice<char>     c = allocator.alloc<char>(256);
+  assert(allocator.bucket(0).owns(a.ptr()));
+  assert(allocator.bucket(1).owns(b.ptr()));
+  assert(allocator.bucket(3).owns(c.ptr()));
+  assert(allocator.owns(c.ptr()));
+
+  // Sizes outside of the buckets fail
+  assert(allocator.rawAlloc(257, 1) == nullptr);
+  assert(allocator.rawAlloc(0, 1) == nullptr);
+
+  // Resizing stays within the bucket
+  assert(allocator.resize(a, 64));
+  assert(!allocator.resize(a, 65));
+}
+
+static auto composed() -> void {
+  // small -> pool, medium -> arena, large -> pages
+  using SmallAlloc =
+      mem::FallbackAllocator<mem::PoolAllocator<Small>, mem::CAllocator>;
+  using MediumAlloc =
+      mem::Segregator<64 * 1024, mem::ArenaAllocator, mem::PageAllocator>;
+  using Allocator = mem::Segregator<sizeof(Small), SmallAlloc, MediumAlloc>;
+
+  mem::CAllocator backing{};
+  auto            args = std::make_tuple(
+      std::piecewise_construct, std::make_tuple(&backing), std::tuple<>{});
+  Allocator       allocator{std::piecewise_construct, args, args};
+
+  Small*          small  = allocator.create<Small>();
+  Slice<u64>      medium = allocator.alloc<u64>(1000);
+  Slice<u64>      large  = allocator.alloc<u64>(100000);
+  assert(allocator.small().primary().owns(small));
+  assert(allocator.large().small().owns(medium.ptr()));
+  medium[999]  = 1;
+  large[99999] = 2;
+  allocator.free(large);
+  allocator.free(medium);
+  allocator.destroy(small);
+}
+
+int main(void) {
+  fallback();
+  segregator();
+  failedRealloc();
+  bucketizer();
+  composed();
+  return 0;
+}
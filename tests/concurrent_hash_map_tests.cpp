@@ -0,0 +1,128 @@
+#include "mu/concurrent_hash_map.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/thread_safe_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize THREADS    = 8;
+static constexpr usize PER_THREAD = 10000;
+
+static auto basics() -> void {
+  ConcurrentHashMap<u64, u64> map{};
+  assert(map.put(1, 10));
+  assert(!map.put(1, 11));
+  assert(map.put(2, 20));
+  assert(map.get(1).unwrap() == 11);
+  assert(!map.get(3).isValid());
+  assert(map.contains(2));
+  assert(map.len() == 2);
+
+  assert(map.update(2, [](u64& val) { val++; }));
+  assert(!map.update(3, [](u64& val) { val++; }));
+  assert(map.get(2).unwrap() == 21);
+
+  assert(map.remove(1));
+  assert(!map.remove(1));
+  map.clear();
+  assert(map.len() == 0);
+}
+
+static auto batches() -> void {
+  ConcurrentHashMap<u64, u64> map{};
+  u64                         keys[1000];
+  u64                         vals[1000];
+  bool                        found[1000];
+  for (u64 i = 0; i < 1000; i++) {
+    keys[i] = i;
+    vals[i] = i * 3;
+  }
+  assert(map.putMany(Slice<u64>(keys, 500), Slice<u64>(vals, 500)) == 500);
+  assert(map.putMany(Slice<u64>(keys, 1000), Slice<u64>(vals, 1000)) == 500);
+  assert(map.len() == 1000);
+
+  for (u64 i = 0; i < 1000; i += 2) {
+    map.remove(i);
+  }
+  u64   out[1000] = {};
+  usize hits      = map.getMany(Slice<u64>(keys, 1000), Slice<u64>(out, 1000),
+                                Slice<bool>(found, 1000));
+  assert(hits == 500);
+  for (u64 i = 0; i < 1000; i++) {
+    assert(found[i] == (i % 2 == 1));
+    assert(out[i] == (found[i] ? i * 3 : 0));
+  }
+}
+
+static auto concurrentUse() -> void {
+  mem::ThreadSafeAllocator                    allocator{};
+  ConcurrentHashMap<u64, u64, mem::Allocator> map{&allocator};
+
+  // Each thread writes its own keys and reads everyone's
+  std::vector<std::thread>                    workers;
+  for (usize t = 0; t < THREADS; t++) {
+    workers.emplace_back([&map, t] {
+      for (u64 i = 0; i < PER_THREAD; i++) {
+        u64 key = t * PER_THREAD + i;
+        map.put(key, key * 2);
+        map.update(key, [](u64& val) { val++; });
+        // Other keys are either missing, written, or written and updated
+        u64           other = (key * 7919) % (THREADS * PER_THREAD);
+        Optional<u64> val   = map.get(other);
+        assert(!val.isValid() || (val.unwrap() / 2 == other));
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+
+  assert(map.len() == THREADS * PER_THREAD);
+  for (u64 key = 0; key < THREADS * PER_THREAD; key++) {
+    assert(map.get(key).unwrap() == key * 2 + 1);
+  }
+}
+
+static auto shardAllocators() -> void {
+  // Each shard has its own (non thread-safe) arena
+  using Map = ConcurrentHashMap<u64, u64, mem::Allocator>;
+
+  mem::CAllocator                  backing{};
+  std::vector<mem::ArenaAllocator> arenas;
+  mem::Allocator*                  allocators[Map::NUM_SHARDS];
+  arenas.reserve(Map::NUM_SHARDS);
+  for (usize i = 0; i < Map::NUM_SHARDS; i++) {
+    arenas.emplace_back(&backing);
+    allocators[i] = &arenas[i];
+  }
+
+  {
+    Map                      map{Slice<mem::Allocator*>(allocators,
+                                                        Map::NUM_SHARDS)};
+    std::vector<std::thread> workers;
+    for (usize t = 0; t < THREADS; t++) {
+      workers.emplace_back([&map, t] {
+        for (u64 i = 0; i < PER_THREAD; i++) {
+          map.put(t * PER_THREAD + i, i);
+        }
+      });
+    }
+    for (std::thread& worker : workers) {
+      worker.join();
+    }
+    assert(map.len() == THREADS * PER_THREAD);
+  }
+}
+
+int main(void) {
+  basics();
+  batches();
+  concurrentUse();
+  shardAllocators();
+  return 0;
+}
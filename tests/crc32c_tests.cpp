@@ -0,0 +1,151 @@
+#include "mu/crc32c.h"
+#include "mu/io/checksum_writer.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace mu;
+using internal::crc32c::Impl;
+
+/// Fills `buf` with pseudorandom bytes.
+static auto fill(u8* buf, usize len, u64 seed) -> void {
+  u64 rng = seed;
+  for (usize i = 0; i < len; i++) {
+    rng    = rng * 6364136223846793005 + 1442695040888963407;
+    buf[i] = static_cast<u8>(rng >> 56);
+  }
+}
+
+static auto knownValues() -> void {
+  assert(crc32c("", 0) == 0);
+  assert(crc32c("123456789", 9) == 0xe3069283);
+  assert(crc32c(Slice<u8>("123456789")) == 0xe3069283);
+
+  // The iSCSI test vectors (RFC 3720, B.4)
+  u8 buf[32];
+  std::memset(buf, 0, sizeof(buf));
+  assert(crc32c(buf, sizeof(buf)) == 0x8a9136aa);
+  std::memset(buf, 0xff, sizeof(buf));
+  assert(crc32c(buf, sizeof(buf)) == 0x62a8ab43);
+  for (usize i = 0; i < sizeof(buf); i++) {
+    buf[i] = static_cast<u8>(i);
+  }
+  assert(crc32c(buf, sizeof(buf)) == 0x46dd794e);
+  for (usize i = 0; i < sizeof(buf); i++) {
+    buf[i] = static_cast<u8>(31 - i);
+  }
+  assert(crc32c(buf, sizeof(buf)) == 0x113fdb5c);
+}
+
+static auto everyImplAgrees() -> void {
+  // Long enough for several blocks of the interleaved kernel, at every offset
+  // (so the loads are misaligned)
+  std::vector<u8> buf(20000);
+  fill(buf.data(), buf.size(), 1);
+  for (usize len = 0; len <= 16000; len += (len < 1100) ? 1 : 97) {
+    for (usize offset : {0, 1, 3, 7}) {
+      for (u32 crc : {u32(0), u32(0xdeadbeef)}) {
+        const u8* ptr = buf.data() + offset;
+        u32       expected =
+            internal::crc32c::crc32c(Impl::Table, ptr, len, crc);
+        assert(crc32c(ptr, len, crc) == expected);
+        for (Impl impl : {Impl::Sse42, Impl::Pclmul}) {
+          if (internal::crc32c::isSupported(impl)) {
+            assert(internal::crc32c::crc32c(impl, ptr, len, crc) == expected);
+          }
+        }
+      }
+    }
+  }
+}
+
+static auto chaining() -> void {
+  std::vector<u8> buf(10000);
+  fill(buf.data(), buf.size(), 2);
+  u32 expected = crc32c(buf.data(), buf.size());
+  for (usize split : {0, 1, 8, 100, 3071, 3072, 3073, 9999, 10000}) {
+    u32 first = crc32c(buf.data(), split);
+    assert(crc32c(buf.data() + split, buf.size() - split, first) == expected);
+  }
+
+  // Any single bit flip is caught
+  for (usize bit = 0; bit < 8 * 4096; bit += 13) {
+    buf[bit / 8] ^= u8(1) << (bit % 8);
+    assert(crc32c(buf.data(), buf.size()) != expected);
+    buf[bit / 8] ^= u8(1) << (bit % 8);
+  }
+}
+
+/// A writer into memory, that accepts at most `limit` bytes per `write` (to
+/// test short writes).
+struct MemoryWriter {
+  std::string bytes;
+  usize       limit = ~usize(0);
+
+  auto        write(Slice<u8> buf) -> usize {
+    usize len = (buf.len() < this->limit) ? buf.len() : this->limit;
+    this->bytes.append(buf.ptr(), len);
+    return len;
+  }
+
+  auto formatV(const_cstr fmt, va_list args) -> void {
+    char text[1024];
+    int  len = std::vsnprintf(text, sizeof(text), fmt, args);
+    this->bytes.append(text, static_cast<usize>(len));
+  }
+};
+
+static auto checksumWriter() -> void {
+  std::vector<u8> buf(5000);
+  fill(buf.data(), buf.size(), 3);
+  cstr data = reinterpret_cast<cstr>(buf.data());
+
+  // Whole writes
+  io::ChecksumWriter<MemoryWriter> writer{MemoryWriter{}};
+  writer.writeAll(Slice<u8>(data, 1000));
+  writer.writeAll(Slice<u8>(data + 1000, 4000));
+  assert(writer.inner().bytes.size() == 5000);
+  assert(writer.bytesWritten() == 5000);
+  assert(writer.checksum() == crc32c(buf.data(), 5000));
+
+  // Short writes only checksum what the inner writer took
+  io::ChecksumWriter<MemoryWriter> limited{MemoryWriter{"", 7}};
+  usize written = limited.write(Slice<u8>(data, 100));
+  assert(written == 7);
+  assert(limited.checksum() == crc32c(buf.data(), 7));
+  limited.writeAll(Slice<u8>(data + 7, 4993));
+  assert(std::memcmp(limited.inner().bytes.data(), data, 5000) == 0);
+  assert(limited.checksum() == crc32c(buf.data(), 5000));
+
+  // Formatted output goes through `write`, whether it fits on the stack or
+  // not
+  io::ChecksumWriter<MemoryWriter> formatted{MemoryWriter{}};
+  formatted.format("%d-%s", 42, "abc");
+  std::string long_text(3000, 'x');
+  formatted.format("[%s]", long_text.c_str());
+  const std::string& out = formatted.inner().bytes;
+  assert(out == "42-abc[" + long_text + "]");
+  assert(formatted.checksum() == crc32c(out.data(), out.size()));
+
+  // `reset` starts a new checksum; a reference wraps without owning
+  formatted.reset();
+  assert(formatted.checksum() == 0 && formatted.bytesWritten() == 0);
+  MemoryWriter                      sink{};
+  io::ChecksumWriter<MemoryWriter&> borrowed{sink};
+  borrowed.writeAll(Slice<u8>("123456789"));
+  assert(sink.bytes == "123456789");
+  assert(borrowed.checksum() == 0xe3069283);
+}
+
+auto main() -> int {
+  knownValues();
+  everyImplAgrees();
+  chaining();
+  checksumWriter();
+  return 0;
+}
@@ -0,0 +1,230 @@
+#include "mu/hash.h"
+#include "mu/hash_map.h"
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+using namespace mu;
+
+/// Counts the live instances, to check that values are moved and destroyed.
+struct Counted {
+  static inline i64 live = 0;
+
+  u64               val;
+
+  explicit Counted(u64 val) : val{val} { live++; }
+  Counted(Counted&& other) noexcept : val{other.val} { live++; }
+  auto operator=(Counted&& other) noexcept -> Counted& {
+    this->val = other.val;
+    return *this;
+  }
+  ~Counted() { live--; }
+};
+
+/// A hash that sends every key to the same group, to test collisions.
+struct BadHash {
+  auto operator()(u64 val) const noexcept -> u64 { return val & 0x7f; }
+};
+
+/// Converts a mask into a bitset of positions, one bit per position.
+template <typename Mask> static auto positions(Mask mask) -> u64 {
+  u64 res = 0;
+  for (; mask; mask.clearLowest()) {
+    res |= u64(1) << mask.lowest();
+  }
+  return res;
+}
+
+/// Checks the group implementations against each other (and a direct scan).
+static auto groups() -> void {
+  using namespace internal::swiss;
+
+  ctrl_t ctrl[64];
+  u64    rng = 1;
+  for (usize iter = 0; iter < 1000; iter++) {
+    for (ctrl_t& byte : ctrl) {
+      rng       = rng * 6364136223846793005 + 1442695040888963407;
+      u8 choice = static_cast<u8>(rng >> 60);
+      byte      = (choice == 0)   ? EMPTY
+                  : (choice == 1) ? DELETED
+                                  : static_cast<ctrl_t>((rng >> 40) & 0x3);
+    }
+
+    GroupPortable portable{ctrl};
+    Group         group{ctrl};
+    u64           empty = 0, free = 0, full = 0, tag = 0;
+    for (usize i = 0; i < Group::WIDTH; i++) {
+      empty |= u64(ctrl[i] == EMPTY) << i;
+      free  |= u64(ctrl[i] < 0) << i;
+      full  |= u64(ctrl[i] >= 0) << i;
+      tag   |= u64(ctrl[i] == 1) << i;
+    }
+    assert(positions(group.matchEmpty()) == empty);
+    assert(positions(group.matchEmptyOrDeleted()) == free);
+    assert(positions(group.matchFull()) == full);
+    if constexpr (!std::is_same_v<Group, GroupPortable>) {
+      assert(positions(group.match(1)) == tag);
+    }
+
+    // The portable group may report false positives for `match`
+    u64 low = (u64(1) << GroupPortable::WIDTH) - 1;
+    assert(positions(portable.matchEmpty()) == (empty & low));
+    assert(positions(portable.matchEmptyOrDeleted()) == (free & low));
+    assert(positions(portable.matchFull()) == (full & low));
+    assert((positions(portable.match(1)) & (tag & low)) == (tag & low));
+  }
+}
+
+static auto putGetRemove() -> void {
+  HashMap<u64, u64> map{};
+  assert(map.get(1) == nullptr);
+  assert(!map.remove(1));
+
+  assert(map.put(1, 10));
+  assert(map.put(2, 20));
+  assert(!map.put(1, 11));
+  assert(map.len() == 2);
+  assert(*map.get(1) == 11);
+  assert(*map.get(2) == 20);
+  assert(map.contains(2));
+  assert(!map.contains(3));
+
+  map.getOrPut(3, u64(30)) += 1;
+  map.getOrPut(3, u64(0))  += 1;
+  assert(*map.get(3) == 32);
+
+  assert(map.remove(1));
+  assert(!map.contains(1));
+  assert(map.len() == 2);
+
+  map.clear();
+  assert(map.len() == 0);
+  assert(!map.contains(2));
+}
+
+static auto matchesStdMap() -> void {
+  HashMap<u64, u64>            map{};
+  std::unordered_map<u64, u64> expected{};
+  u64                          rng = 42;
+  for (usize i = 0; i < 200000; i++) {
+    rng     = rng * 6364136223846793005 + 1442695040888963407;
+    u64 key = (rng >> 33) % 5000;
+    switch ((rng >> 20) % 3) {
+    case 0:
+      assert(map.put(key, i) == (expected.find(key) == expected.end()));
+      expected[key] = i;
+      break;
+    case 1:
+      assert(map.remove(key) == (expected.erase(key) == 1));
+      break;
+    default:
+      auto found = expected.find(key);
+      if (found == expected.end()) {
+        assert(map.get(key) == nullptr);
+      } else {
+        assert(*map.get(key) == found->second);
+      }
+    }
+  }
+  assert(map.len() == expected.size());
+
+  usize visited = 0;
+  for (auto& entry : map) {
+    assert(expected.at(entry.key) == entry.val);
+    visited++;
+  }
+  assert(visited == expected.size());
+}
+
+static auto tombstones() -> void {
+  // Inserting and removing keys shouldn't grow the table forever
+  HashMap<u64, u64> map{};
+  map.reserve(100);
+  usize cap = map.capacity();
+  for (u64 i = 0; i < 100000; i++) {
+    map.put(i, i);
+    assert(map.remove(i));
+  }
+  assert(map.capacity() == cap);
+  assert(map.len() == 0);
+}
+
+static auto collisions() -> void {
+  HashMap<u64, u64, mem::CAllocator, BadHash> map{};
+  for (u64 i = 0; i < 1000; i++) {
+    map.put(i << 7, i);
+  }
+  for (u64 i = 0; i < 1000; i += 2) {
+    assert(map.remove(i << 7));
+  }
+  for (u64 i = 0; i < 1000; i++) {
+    u64* val = map.get(i << 7);
+    assert((i % 2 == 0) ? (val == nullptr) : (*val == i));
+  }
+}
+
+static auto sliceKeys() -> void {
+  char                      buf[] = "hello world hello";
+  HashMap<Slice<char>, u64> map{};
+  map.put(Slice<char>(buf, 5), 1);
+  map.put(Slice<char>(buf + 6, 5), 2);
+
+  // Keys are compared by contents, not by address
+  assert(*map.get(Slice<char>(buf + 12, 5)) == 1);
+  assert(map.get(Slice<char>(buf, 4)) == nullptr);
+  Hash<Slice<char>> hash{};
+  assert(hash(Slice<char>(buf, 5)) == hash(Slice<char>(buf + 12, 5)));
+  assert(hash(Slice<char>(buf, 5)) != hash(Slice<char>(buf + 6, 5)));
+  assert(hash(Slice<char>(buf, 5)) == hash64(buf, 5));
+
+  // A block starting with a secret word must not erase the blocks before it
+  // (the byte hash this map used to have was open to this)
+  const u64 secret  = 0xe7037ed1a0b428db;
+  char      lhs[64] = {1};
+  char      rhs[64] = {2};
+  std::memcpy(lhs + 16, &secret, sizeof(secret));
+  std::memcpy(rhs + 16, &secret, sizeof(secret));
+  assert(hash(Slice<char>(lhs, 64)) != hash(Slice<char>(rhs, 64)));
+}
+
+static auto nonTrivialValues() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    HashMap<u64, Counted, mem::Allocator> map{&tracking};
+    for (u64 i = 0; i < 1000; i++) {
+      map.put(i, Counted(i));
+    }
+    assert(Counted::live == 1000);
+    for (u64 i = 0; i < 1000; i += 2) {
+      map.remove(i);
+    }
+    assert(Counted::live == 500);
+    assert(map.get(501)->val == 501);
+
+    auto moved = std::move(map);
+    assert(map.len() == 0);
+    assert(moved.len() == 500);
+    assert(Counted::live == 500);
+  }
+  assert(Counted::live == 0);
+  assert(tracking.stats().live_bytes == 0);
+}
+
+int main(void) {
+  groups();
+  putGetRemove();
+  matchesStdMap();
+  tombstones();
+  collisions();
+  sliceKeys();
+  nonTrivialValues();
+  return 0;
+}
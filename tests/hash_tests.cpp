@@ -0,0 +1,217 @@
+#include "mu/bytes.h"
+#include "mu/hash.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <unordered_set>
+#include <vector>
+
+using namespace mu;
+using internal::bytes::Isa;
+
+/// Fills `buf` with pseudorandom bytes.
+static auto fill(u8* buf, usize len, u64 seed) -> void {
+  u64 rng = seed;
+  for (usize i = 0; i < len; i++) {
+    rng    = rng * 6364136223846793005 + 1442695040888963407;
+    buf[i] = static_cast<u8>(rng >> 56);
+  }
+}
+
+static auto everyIsaAgrees() -> void {
+  std::vector<u8> buf(5000);
+  fill(buf.data(), buf.size(), 1);
+  for (usize len = 0; len <= buf.size(); len += (len < 1200) ? 1 : 61) {
+    for (u64 seed : {u64(0), u64(42), ~u64(0)}) {
+      u64 expected =
+          internal::hash::hash64(Isa::Scalar, buf.data(), len, seed);
+      assert(hash64(buf.data(), len, seed) == expected);
+      for (Isa isa : {Isa::Sse2, Isa::Avx2, Isa::Avx512}) {
+        if (internal::bytes::isSupported(isa)) {
+          assert(internal::hash::hash64(isa, buf.data(), len, seed) ==
+                 expected);
+        }
+      }
+    }
+  }
+}
+
+static auto stableOutput() -> void {
+  // The output is part of the interface (for fingerprints that are stored),
+  // so it must never change
+  u8 buf[1000];
+  fill(buf, sizeof(buf), 7);
+  const u64 expected[][3] = {
+      {0, 0, 0x48362d1c928c66a5},    {3, 0, 0x6efd6bcca167e20d},
+      {8, 0, 0x81544aee03e9b10b},    {16, 0, 0x2b4e5eef86843a98},
+      {100, 0, 0xd59c3e123e702cf0},  {200, 0, 0xf47d5ac2e47f7e18},
+      {1000, 0, 0xac44a504b21e8543}, {0, 1, 0x340a330e7217f1ff},
+      {3, 1, 0x4e911ab440e55492},    {8, 1, 0x3fcb5d82dc842be8},
+      {16, 1, 0x998d3bc72f4e896b},   {100, 1, 0x365c5e3b920bbf8a},
+      {200, 1, 0x2576dce58fa8ab1d},  {1000, 1, 0x6e4d4efbd2d32056},
+  };
+  for (const u64* row : expected) {
+    assert(hash64(buf, row[0], row[1]) == row[2]);
+  }
+}
+
+static auto streamingMatchesOneShot() -> void {
+  std::vector<u8> buf(3000);
+  fill(buf.data(), buf.size(), 2);
+  for (usize len = 0; len <= buf.size(); len += (len < 600) ? 1 : 37) {
+    for (u64 seed : {u64(0), u64(99)}) {
+      u64 expected = hash64(buf.data(), len, seed);
+      for (usize chunk : {1, 7, 63, 64, 65, 200, 256, 257, 1000}) {
+        Hasher hasher{seed};
+        for (usize i = 0; i < len; i += chunk) {
+          hasher.update(buf.data() + i, (len - i < chunk) ? len - i : chunk);
+        }
+        assert(hasher.finish() == expected);
+      }
+
+      // Uneven chunks, which land on every position in the buffer
+      Hasher hasher{seed};
+      usize  chunk = 1;
+      for (usize i = 0; i < len; i += chunk, chunk = chunk * 3 % 257 + 1) {
+        hasher.update(buf.data() + i, (len - i < chunk) ? len - i : chunk);
+      }
+      assert(hasher.finish() == expected);
+    }
+  }
+
+  // `finish` doesn't consume the state
+  Hasher hasher{};
+  hasher.update(buf.data(), 1000);
+  assert(hasher.finish() == hash64(buf.data(), 1000));
+  hasher.update(buf.data() + 1000, 500);
+  assert(hasher.finish() == hash64(buf.data(), 1500));
+  hasher.reset();
+  assert(hasher.finish() == hash64(buf.data(), 0));
+}
+
+static auto typedInputs() -> void {
+  struct Point {
+    i32 x;
+    i32 y;
+  };
+  Point point{3, -4};
+  assert(hash64(point) == hash64(&point, sizeof(point)));
+  assert(hash64(point, 5) != hash64(point));
+
+  u64        nums[] = {1, 2, 3, 4, 5};
+  Slice<u64> slice(nums, 5);
+  assert(hash64(slice) == hash64(nums, sizeof(nums)));
+  assert(hash64(Slice<u8>("hello")) == hash64("hello", 5));
+
+  Hasher hasher{};
+  hasher.update(point);
+  hasher.update(slice);
+  hasher.update(Slice<u8>("hello"));
+  u8 joined[sizeof(point) + sizeof(nums) + 5];
+  std::memcpy(joined, &point, sizeof(point));
+  std::memcpy(joined + sizeof(point), nums, sizeof(nums));
+  std::memcpy(joined + sizeof(point) + sizeof(nums), "hello", 5);
+  assert(hasher.finish() == hash64(joined, sizeof(joined)));
+}
+
+/// Checks that `keys` have no 64-bit collisions, and about as many 32-bit
+/// collisions (of the low half) as a random function would have.
+static auto checkCollisions(const std::vector<u64>& hashes) -> void {
+  std::unordered_set<u64> full;
+  std::unordered_set<u32> low;
+  usize                   low_collisions = 0;
+  for (u64 hash : hashes) {
+    assert(full.insert(hash).second);
+    low_collisions += !low.insert(static_cast<u32>(hash)).second;
+  }
+  f64 n        = static_cast<f64>(hashes.size());
+  f64 expected = n * n / (2.0 * 4294967296.0);
+  assert(static_cast<f64>(low_collisions) <= 2 * expected + 10);
+}
+
+static auto collisions() -> void {
+  constexpr usize KEYS = 200000;
+
+  // Sequential integers, as 8-byte keys
+  std::vector<u64> hashes;
+  for (u64 i = 0; i < KEYS; i++) {
+    hashes.push_back(hash64(i));
+  }
+  checkCollisions(hashes);
+
+  // Short strings that differ in a few characters
+  hashes.clear();
+  char text[32];
+  for (usize i = 0; i < KEYS; i++) {
+    int len = std::snprintf(text, sizeof(text), "user:%zu", i);
+    hashes.push_back(hash64(text, static_cast<usize>(len)));
+  }
+  checkCollisions(hashes);
+
+  // Sparse keys: two bits set in an otherwise zero buffer, at every length
+  // class (short, mid and striped)
+  for (usize len : {16, 64, 200, 512}) {
+    hashes.clear();
+    std::vector<u8> buf(len);
+    for (usize a = 0; a < len * 8; a += (len > 64) ? 3 : 1) {
+      for (usize b = a + 1; b < len * 8; b += (len > 64) ? 5 : 1) {
+        buf[a / 8] ^= u8(1) << (a % 8);
+        buf[b / 8] ^= u8(1) << (b % 8);
+        hashes.push_back(hash64(buf.data(), len));
+        buf[a / 8] = 0;
+        buf[b / 8] = 0;
+      }
+    }
+    checkCollisions(hashes);
+  }
+
+  // The same bytes with different lengths or seeds
+  u8 zeros[1024] = {};
+  hashes.clear();
+  for (usize len = 0; len <= sizeof(zeros); len++) {
+    hashes.push_back(hash64(zeros, len));
+    hashes.push_back(hash64(zeros, len, 1));
+  }
+  checkCollisions(hashes);
+}
+
+/// Checks that flipping any input bit flips each output bit about half the
+/// time.
+static auto avalanche() -> void {
+  for (usize len : {1, 4, 8, 12, 16, 40, 100, 200, 300, 1100}) {
+    constexpr usize TRIALS = 64;
+    std::vector<u8>  buf(len);
+    std::vector<u32> flips(64, 0);
+    usize            samples = 0;
+    for (usize t = 0; t < TRIALS; t++) {
+      fill(buf.data(), len, t + 100);
+      u64 base = hash64(buf.data(), len);
+      for (usize bit = 0; bit < len * 8; bit += (len > 100) ? 7 : 1) {
+        buf[bit / 8] ^= u8(1) << (bit % 8);
+        u64 diff      = base ^ hash64(buf.data(), len);
+        buf[bit / 8] ^= u8(1) << (bit % 8);
+        for (usize out = 0; out < 64; out++) {
+          flips[out] += (diff >> out) & 1;
+        }
+        samples++;
+      }
+    }
+    for (usize out = 0; out < 64; out++) {
+      f64 rate = static_cast<f64>(flips[out]) / static_cast<f64>(samples);
+      assert((rate > 0.4) && (rate < 0.6));
+    }
+  }
+}
+
+auto main() -> int {
+  everyIsaAgrees();
+  stableOutput();
+  streamingMatchesOneShot();
+  typedInputs();
+  collisions();
+  avalanche();
+  return 0;
+}
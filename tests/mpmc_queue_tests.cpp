@@ -0,0 +1,154 @@
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/mpmc_queue.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+static constexpr usize THREADS    = 4;
+static constexpr u64   PER_THREAD = 50000;
+
+static auto basics() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    MpmcQueue<u64, mem::Allocator> queue{&tracking, 5};
+    assert(queue.capacity() == 8);
+    for (u64 i = 0; i < 8; i++) {
+      assert(queue.tryPush(i));
+    }
+    assert(!queue.tryPush(8));
+    assert(queue.len() == 8);
+
+    u64 val = 0;
+    assert(queue.tryPop(val) && (val == 0));
+    assert(queue.tryPush(8));
+
+    // Batches wrap around the end of the ring
+    u64 out[16] = {};
+    assert(queue.popMany(Slice<u64>(out, 16)) == 8);
+    for (u64 i = 0; i < 8; i++) {
+      assert(out[i] == i + 1);
+    }
+    assert(!queue.tryPop(val));
+    assert(queue.popMany(Slice<u64>(out, 16)) == 0);
+
+    u64 in[10] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    assert(queue.pushMany(Slice<u64>(in, 10)) == 8);
+    assert(queue.pushMany(Slice<u64>(in, 10)) == 0);
+    assert(queue.popMany(Slice<u64>(out, 3)) == 3);
+    assert(out[2] == 12);
+    assert(queue.pushMany(Slice<u64>(in + 8, 2)) == 2);
+    assert(queue.tryPop(val) && (val == 13));
+    assert(queue.popMany(Slice<u64>(out, 16)) == 6);
+    assert((out[0] == 14) && (out[5] == 19));
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto nonTrivialItems() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    MpmcQueue<std::string, mem::Allocator> queue{&tracking, 4};
+    std::string                            strs[3] = {std::string(64, 'a'),
+                                                      std::string(64, 'b'),
+                                                      std::string(64, 'c')};
+    assert(queue.pushMany(Slice<std::string>(strs, 3)) == 3);
+
+    std::string out[2];
+    assert(queue.popMany(Slice<std::string>(out, 2)) == 2);
+    assert((out[0] == std::string(64, 'a')) && (out[1][0] == 'b'));
+
+    // The remaining item is destroyed with the queue
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto concurrentUse() -> void {
+  // A small queue, so that it is often full and empty
+  MpmcQueue<u64>               queue{nullptr, 64};
+  std::vector<std::atomic<u8>> seen(THREADS * PER_THREAD);
+  std::atomic<u64>             popped{0};
+
+  // Each item is `producer * PER_THREAD + i`
+  std::vector<std::thread>     workers;
+  for (usize t = 0; t < THREADS; t++) {
+    workers.emplace_back([&queue, t] {
+      u64 batch[8];
+      for (u64 i = 0; i < PER_THREAD;) {
+        usize pushed = 0;
+        if (t % 2 == 0) {
+          pushed = queue.tryPush(t * PER_THREAD + i) ? 1 : 0;
+        } else {
+          usize len = (PER_THREAD - i < 8) ? usize(PER_THREAD - i) : 8;
+          for (usize j = 0; j < len; j++) {
+            batch[j] = t * PER_THREAD + i + j;
+          }
+          pushed = queue.pushMany(Slice<u64>(batch, len));
+        }
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+        i += pushed;
+      }
+    });
+  }
+
+  // Every item is popped exactly once, and each producer's items are popped
+  // in order
+  for (usize t = 0; t < THREADS; t++) {
+    workers.emplace_back([&queue, &seen, &popped, t] {
+      u64 last[THREADS];
+      for (usize p = 0; p < THREADS; p++) {
+        last[p] = p * PER_THREAD;
+      }
+      auto check = [&](u64 val) {
+        usize producer = val / PER_THREAD;
+        assert((producer < THREADS) && (val >= last[producer]));
+        last[producer] = val;
+        assert(seen[val].fetch_add(1) == 0);
+      };
+
+      u64 out[5];
+      while (popped.load() < THREADS * PER_THREAD) {
+        usize len = 0;
+        if (t % 2 == 0) {
+          len = queue.tryPop(out[0]) ? 1 : 0;
+        } else {
+          len = queue.popMany(Slice<u64>(out, 5));
+        }
+        for (usize i = 0; i < len; i++) {
+          check(out[i]);
+        }
+        if (len == 0) {
+          std::this_thread::yield();
+        }
+        popped.fetch_add(len);
+      }
+    });
+  }
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  assert(popped.load() == THREADS * PER_THREAD);
+  for (std::atomic<u8>& count : seen) {
+    assert(count.load() == 1);
+  }
+  assert(queue.len() == 0);
+}
+
+int main(void) {
+  basics();
+  nonTrivialItems();
+  concurrentUse();
+  return 0;
+}
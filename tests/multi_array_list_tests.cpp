@@ -0,0 +1,142 @@
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/multi_array_list.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+using namespace mu;
+
+struct Particle {
+  f32 x;
+  f32 y;
+  u8  flags;
+  f64 mass;
+  u32 id;
+};
+
+struct Named {
+  std::string name;
+  u64         val;
+};
+
+static auto fields() -> void {
+  using List = MultiArrayList<Particle>;
+  static_assert(List::NUM_FIELDS == 5);
+  static_assert(std::is_same_v<List::Field<2>, u8>);
+  static_assert(std::is_same_v<List::Field<3>, f64>);
+  static_assert(MultiArrayList<Named>::NUM_FIELDS == 2);
+}
+
+static auto appendAndGet() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    MultiArrayList<Particle, mem::Allocator> list{&tracking};
+    for (u32 i = 0; i < 100; i++) {
+      list.append(Particle{f32(i), -f32(i), u8(i % 3), f64(i) * 2, i});
+    }
+    assert(list.len() == 100);
+    assert(list.capacity() >= 100);
+    assert(tracking.stats().allocs == 5); // 8, 16, 32, 64, 128
+
+    // Each field is its own, aligned array
+    Slice<f64> masses = list.items<3>();
+    Slice<u8>  flags  = list.items<2>();
+    assert(masses.len() == 100);
+    assert(reinterpret_cast<usize>(masses.ptr()) % 64 == 0);
+    assert(reinterpret_cast<usize>(flags.ptr()) % 64 == 0);
+    f64 total = 0;
+    for (usize i = 0; i < masses.len(); i++) {
+      total += masses[i];
+    }
+    assert(total == 9900);
+    assert(flags.len() == 100);
+
+    Particle p = list.get(42);
+    assert((p.x == 42) && (p.y == -42) && (p.flags == 0) && (p.mass == 84) &&
+           (p.id == 42));
+    list.set(42, Particle{1, 2, 3, 4, 5});
+    assert(list.get(42).id == 5);
+    assert(list.items<0>()[42] == 1);
+
+    bool threw = false;
+    try {
+      list.get(100);
+    } catch (const common::IndexOutOfBounds&) {
+      threw = true;
+    }
+    assert(threw);
+
+    Particle removed = list.swapRemove(0);
+    assert(removed.id == 0);
+    assert(list.len() == 99);
+    assert(list.get(0).id == 99);
+    assert(list.pop().unwrap().id == 98);
+
+    MultiArrayList<Particle, mem::Allocator> moved = std::move(list);
+    assert(list.len() == 0);
+    assert(moved.len() == 98);
+    moved.clear();
+    assert(moved.len() == 0);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto sortBy() -> void {
+  MultiArrayList<Particle> list{};
+  u32                      ids[] = {5, 3, 9, 1, 7, 2, 8, 0, 6, 4};
+  for (u32 id : ids) {
+    list.append(Particle{f32(id), 0, 0, f64(10 - id), id});
+  }
+
+  list.sortBy<4>();
+  for (u32 i = 0; i < 10; i++) {
+    Particle p = list.get(i);
+    assert((p.id == i) && (p.x == f32(i)) && (p.mass == f64(10 - i)));
+  }
+
+  list.sortBy<4>([](u32 lhs, u32 rhs) { return lhs > rhs; });
+  for (u32 i = 0; i < 10; i++) {
+    assert(list.get(i).id == 9 - i);
+  }
+}
+
+static auto nonTrivialFields() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    MultiArrayList<Named, mem::Allocator> list{&tracking};
+    for (u64 i = 0; i < 50; i++) {
+      // Long enough to be heap-allocated
+      list.append(Named{std::string(32, char('a' + i % 26)), 50 - i});
+    }
+    list.sortBy<1>();
+    assert(list.get(0).val == 1);
+    assert(list.get(0).name == std::string(32, char('a' + 49 % 26)));
+
+    Named removed = list.swapRemove(3);
+    assert(removed.val == 4);
+    assert(list.get(3).val == 50);
+    assert(list.swapRemove(list.len() - 1).val == 49);
+    assert(list.len() == 48);
+
+    Named popped = list.pop().unwrap();
+    assert(popped.val == 48);
+    assert(popped.name == std::string(32, 'c'));
+    assert(list.len() == 47);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+int main(void) {
+  fields();
+  appendAndGet();
+  sortBy();
+  nonTrivialFields();
+  return 0;
+}
@@ -0,0 +1,102 @@
+#include "mu/common.h"
+#include "mu/mem/arena_allocator.h"
+#include "mu/mem/page_allocator.h"
+#include "mu/primitives.h"
+#include <cassert>
+
+using namespace mu;
+
+using HugePages = mem::PageAllocator::HugePages;
+
+static auto isAligned(const void* ptr, usize align) -> bool {
+  return (reinterpret_cast<usize>(ptr) % align) == 0;
+}
+
+static auto zeroedPages() -> void {
+  mem::PageAllocator allocator{};
+  usize              page = mem::PageAllocator::pageSize();
+
+  for (usize len : {usize{1}, usize{100}, page, page + 1, 10 * page}) {
+    Slice<u64> slice = allocator.alloc<u64>(len);
+    assert(isAligned(slice.ptr(), page));
+    for (usize i = 0; i < len; i++) {
+      assert(slice[i] == 0);
+      slice[i] = i;
+    }
+    allocator.free(slice);
+  }
+}
+
+static auto alignment() -> void {
+  mem::PageAllocator allocator{};
+  usize              huge = mem::PageAllocator::HUGE_PAGE_SIZE;
+
+  for (usize align = 1; align <= huge; align *= 4) {
+    void* ptr = allocator.rawAlloc(3 * align, align);
+    assert(ptr != nullptr);
+    assert(isAligned(ptr, align));
+    allocator.rawFree(ptr, 3 * align, align);
+  }
+}
+
+static auto resize() -> void {
+  mem::PageAllocator allocator{};
+  usize              page  = mem::PageAllocator::pageSize();
+
+  Slice<char>        slice = allocator.alloc<char>(4 * page);
+  slice[4 * page - 1]      = 'a';
+
+  // Shrinking in place returns the tail pages
+  assert(allocator.resize(slice, page));
+  assert(slice.len() == page);
+  slice[page - 1] = 'b';
+
+  // Growing keeps the contents, even if the mapping has to move
+  slice           = allocator.realloc(slice, 64 * page);
+  assert(slice[page - 1] == 'b');
+  assert(slice[64 * page - 1] == 0);
+  allocator.free(slice);
+}
+
+static auto hugePages() -> void {
+  usize huge = mem::PageAllocator::HUGE_PAGE_SIZE;
+
+  for (HugePages mode : {HugePages::Transparent, HugePages::Explicit}) {
+    mem::PageAllocator allocator{mode};
+
+    Slice<u64> slice = allocator.alloc<u64>(2 * huge / sizeof(u64));
+    assert(isAligned(slice.ptr(), huge));
+    slice[0]               = 1;
+    slice[slice.len() - 1] = 2;
+    mem::PageAllocator::discard(slice.ptr(), huge);
+    assert(slice[0] == 0);
+    assert(slice[slice.len() - 1] == 2);
+    allocator.free(slice);
+
+    // Small allocations still use regular pages
+    Slice<u64> small = allocator.alloc<u64>(16);
+    small[15]        = 3;
+    allocator.free(small);
+  }
+}
+
+static auto arenaBacking() -> void {
+  mem::PageAllocator  pages{};
+  mem::ArenaAllocator arena{&pages, 1024 * 1024};
+
+  for (usize i = 0; i < 4096; i++) {
+    Slice<u64> val = arena.allocZeroed<u64>(4);
+    assert(val[3] == 0);
+    val[3] = i;
+  }
+  arena.release();
+}
+
+int main(void) {
+  zeroedPages();
+  alignment();
+  resize();
+  hugePages();
+  arenaBacking();
+  return 0;
+}
@@ -0,0 +1,71 @@
+#include "mu/common.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/primitives.h"
+#include <cassert>
+
+using namespace mu;
+
+struct Tst {
+  int  x;
+  int  y;
+  int  z;
+  bool b;
+};
+
+struct alignas(32) Wide {
+  u64 vals[4];
+};
+
+static auto reuseBlocks() -> void {
+  mem::CAllocator         backing{};
+  mem::PoolAllocator<Tst> pool{&backing, 4};
+
+  Tst*                    a = pool.create<Tst>();
+  Tst*                    b = pool.create<Tst>();
+  assert(a != b);
+  assert((reinterpret_cast<u8*>(b) - reinterpret_cast<u8*>(a)) == sizeof(Tst));
+
+  // Freed blocks are reused first
+  pool.destroy(a);
+  Tst* c = pool.create<Tst>();
+  assert(c == a);
+
+  // Spill into a second slab
+  for (usize i = 0; i < 4; i++) {
+    Tst* val = pool.create<Tst>();
+    val->x   = static_cast<int>(i);
+  }
+  assert(pool.capacity() == 8);
+}
+
+static auto overAligned() -> void {
+  mem::CAllocator          backing{};
+  mem::PoolAllocator<Wide> pool{&backing, 2};
+
+  for (usize i = 0; i < 5; i++) {
+    Wide* val = pool.create<Wide>();
+    assert((reinterpret_cast<usize>(val) % alignof(Wide)) == 0);
+  }
+}
+
+static auto unsupportedSize() -> void {
+  mem::CAllocator         backing{};
+  mem::PoolAllocator<Tst> pool{&backing};
+
+  bool                    thrown = false;
+  try {
+    Slice<Tst> slice = pool.alloc<Tst>(2);
+    pool.free(slice);
+  } catch (common::OutOfMemoryException& e) {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+int main(void) {
+  reuseBlocks();
+  overAligned();
+  unsupportedSize();
+  return 0;
+}
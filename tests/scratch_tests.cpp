@@ -0,0 +1,93 @@
+#include "mu/mem/scratch.h"
+#include "mu/mem/unique_ptr.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <thread>
+
+using namespace mu;
+
+struct Tst {
+  int x = 1;
+  int y = 2;
+};
+
+using ScratchSlice = UniquePtr<Slice<Tst>, mem::ScratchAllocator>;
+
+static auto scopesRollBack() -> void {
+  mem::ArenaAllocator& arena = mem::scratchArena();
+  u64*                 outer = nullptr;
+  {
+    mem::TempScope scope{};
+    assert(&scope.arenaAllocator() == &arena);
+
+    outer  = arena.create<u64>();
+    *outer = 1;
+    {
+      mem::TempScope inner{};
+      u64*           tmp = arena.create<u64>();
+      assert(tmp != outer);
+    }
+
+    // The inner scope freed its allocations, but not the outer ones
+    u64* reused = arena.create<u64>();
+    assert(reused == outer + 1);
+    assert(*outer == 1);
+  }
+
+  mem::TempScope scope{};
+  assert(arena.create<u64>() == outer);
+}
+
+static auto largeTemporaries() -> void {
+  mem::TempScope scope{};
+  usize          cap = mem::scratchArena().capacity();
+
+  // Temporaries larger than a chunk spill into extra chunks, which are kept
+  for (usize round = 0; round < 4; round++) {
+    mem::TempScope inner{};
+    Slice<char>    buf =
+        inner.arenaAllocator().alloc<char>(2 * mem::SCRATCH_CHUNK_SIZE);
+    buf[buf.len() - 1] = 'x';
+  }
+  assert(mem::scratchArena().capacity() <= cap + 3 * mem::SCRATCH_CHUNK_SIZE);
+}
+
+static auto allocatorAdaptor() -> void {
+  static_assert(mem::StaticAllocator<mem::ScratchAllocator>);
+  static_assert(sizeof(ScratchSlice) == sizeof(Slice<Tst>));
+
+  mem::TempScope scope{};
+  {
+    auto vals = ScratchSlice::create(nullptr, 8);
+    assert(vals[7].y == 2);
+
+    mem::ScratchAllocator allocator{};
+    Slice<int>            ints = allocator.alloc<int>(4);
+    assert(allocator.resize(ints, 64));
+    ints[63] = 3;
+    allocator.free(ints);
+  }
+}
+
+static auto perThread() -> void {
+  mem::ArenaAllocator* main_arena  = &mem::scratchArena();
+  mem::ArenaAllocator* other_arena = nullptr;
+
+  std::thread          thread{[&] {
+    mem::TempScope scope{};
+    other_arena    = &scope.arenaAllocator();
+    Slice<u32> buf = other_arena->alloc<u32>(16);
+    buf[15]        = 1;
+  }};
+  thread.join();
+  assert(other_arena != main_arena);
+}
+
+int main(void) {
+  scopesRollBack();
+  largeTemporaries();
+  allocatorAdaptor();
+  perThread();
+  return 0;
+}
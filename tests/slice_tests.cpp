@@ -0,0 +1,215 @@
+#include "mu/common.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <numeric>
+
+using namespace mu;
+
+static auto iterators() -> void {
+  u32        buf[10];
+  Slice<u32> slice(buf, 10);
+  u32        next = 0;
+  for (u32& val : slice) {
+    val = next++;
+  }
+  assert(slice.end() - slice.begin() == 10);
+  assert(std::accumulate(slice.begin(), slice.end(), u32(0)) == 45);
+  for (usize i = 0; i < slice.len(); i++) {
+    assert(slice.getUnchecked(i) == slice[i]);
+  }
+
+  Slice<u32> empty{};
+  empty = Slice<u32>(buf, 0);
+  assert(empty.begin() == empty.end());
+}
+
+static auto boundsChecks() -> void {
+  u64        buf[4] = {};
+  Slice<u64> slice(buf, 4);
+#ifndef MU_SLICE_UNCHECKED
+  bool threw = false;
+  try {
+    slice[4] = 1;
+  } catch (const common::IndexOutOfBounds& err) {
+    threw = (err.idx == 4) && (err.len == 4);
+  }
+  assert(threw);
+#endif
+
+  // `subslice` is always checked
+  bool threw_range = false;
+  try {
+    (void)slice.subslice(3, 5);
+  } catch (const common::IndexOutOfBounds&) {
+    threw_range = true;
+  }
+  assert(threw_range);
+}
+
+static auto subslices() -> void {
+  alignas(16) u32 buf[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+  Slice<u32>      slice(buf, 8, 16);
+
+  Slice<u32>      mid = slice.subslice(2, 6);
+  assert(mid.len() == 4);
+  assert(mid.ptr() == buf + 2);
+  assert(mid[0] == 2 && mid[3] == 5);
+  assert(mid.align() == 8);
+  assert(slice.subslice(4, 8).align() == 16);
+  assert(slice.subslice(8, 8).len() == 0);
+
+  // Views don't copy
+  mid[0] = 20;
+  assert(buf[2] == 20);
+}
+
+static auto chunks() -> void {
+  u32        buf[10];
+  Slice<u32> slice(buf, 10);
+  std::iota(slice.begin(), slice.end(), u32(0));
+
+  usize count = 0;
+  u32   next  = 0;
+  for (Slice<u32> chunk : slice.chunks(4)) {
+    assert(chunk.len() == ((count < 2) ? 4 : 2));
+    for (u32 val : chunk) {
+      assert(val == next++);
+    }
+    count++;
+  }
+  assert(count == 3);
+  assert(slice.chunks(4).len() == 3);
+  assert(slice.chunks(5).len() == 2);
+  assert(slice.chunks(20).len() == 1);
+  assert(Slice<u32>(buf, 0).chunks(3).len() == 0);
+  assert(Slice<u32>(buf, 0).chunks(3).begin() ==
+         Slice<u32>(buf, 0).chunks(3).end());
+}
+
+static auto windows() -> void {
+  u32        buf[5] = {1, 2, 3, 4, 5};
+  Slice<u32> slice(buf, 5);
+
+  usize      count = 0;
+  for (Slice<u32> window : slice.windows(3)) {
+    assert(window.len() == 3);
+    assert(window[0] == count + 1);
+    assert(window[2] == count + 3);
+    count++;
+  }
+  assert(count == 3);
+  assert(slice.windows(5).len() == 1);
+  assert(slice.windows(6).len() == 0);
+  assert(slice.windows(6).begin() == slice.windows(6).end());
+}
+
+static auto bytes() -> void {
+  char      buf[] = "hello world";
+  Slice<u8> str(buf, std::strlen(buf));
+  assert(str.len() == 11);
+
+  usize os = 0;
+  for (char& c : str) {
+    os += (c == 'o');
+  }
+  assert(os == 2);
+  assert(str.getUnchecked(4) == 'o');
+
+  Slice<u8> world = str.subslice(6, 11);
+  assert(std::memcmp(world.ptr(), "world", 5) == 0);
+
+  usize count = 0;
+  for (Slice<u8> word : str.chunks(6)) {
+    assert(word.len() == ((count == 0) ? 6 : 5));
+    count++;
+  }
+  assert(count == 2);
+  assert(str.windows(2).len() == 10);
+  assert((*str.windows(2).begin())[1] == 'e');
+}
+
+static auto search() -> void {
+  char      buf[] = "key=value;other=thing;;last";
+  Slice<u8> str(buf, std::strlen(buf));
+
+  assert(str.indexOf('=').unwrap() == 3);
+  assert(!str.indexOf('!').isValid());
+  assert(str.indexOfAny(Slice<u8>(";=")).unwrap() == 3);
+  assert(!str.indexOfAny(Slice<u8>("")).isValid());
+  assert(str.count(';') == 3);
+  assert(str.count('!') == 0);
+
+  assert(str.startsWith(Slice<u8>("key=")));
+  assert(!str.startsWith(Slice<u8>("key:")));
+  assert(str.startsWith(Slice<u8>("")));
+  assert(!Slice<u8>("ke").startsWith(Slice<u8>("key")));
+  assert(str.subslice(4, 9).equals(Slice<u8>("value")));
+  assert(!str.subslice(4, 9).equals(Slice<u8>("valu")));
+  assert(Slice<u8>("").equals(Slice<u8>("")));
+}
+
+static auto split() -> void {
+  char       buf[]      = "key=value;other=thing;;last";
+  Slice<u8>  str(buf, std::strlen(buf));
+  const_cstr expected[] = {"key=value", "other=thing", "", "last"};
+
+  usize      count      = 0;
+  for (Slice<u8> piece : str.split(';')) {
+    assert(count < 4);
+    assert(piece.equals(Slice<u8>(expected[count])));
+    count++;
+  }
+  assert(count == 4);
+
+  // There is one more piece than there are delimiters
+  count = 0;
+  for (Slice<u8> piece : Slice<u8>("").split(';')) {
+    assert(piece.len() == 0);
+    count++;
+  }
+  assert(count == 1);
+
+  count = 0;
+  for (Slice<u8> piece : Slice<u8>(";").split(';')) {
+    assert(piece.len() == 0);
+    count++;
+  }
+  assert(count == 2);
+
+  // The pieces point into the slice
+  auto it = str.split('=').begin();
+  ++it;
+  assert((*it).ptr() == buf + 4);
+
+  // Pieces spanning (and ending on) the 64-byte search blocks
+  char text[300];
+  for (usize gap : {1, 2, 5, 63, 64, 65, 200}) {
+    for (usize i = 0; i < sizeof(text); i++) {
+      text[i] = ((i + 1) % gap == 0) ? ',' : 'a';
+    }
+    usize pieces = 0;
+    usize total  = 0;
+    for (Slice<u8> piece : Slice<u8>(text, sizeof(text)).split(',')) {
+      assert(piece.ptr() == text + total);
+      total += piece.len() + 1;
+      pieces++;
+    }
+    assert(total == sizeof(text) + 1);
+    assert(pieces == sizeof(text) / gap + 1);
+  }
+}
+
+auto main() -> int {
+  iterators();
+  boundsChecks();
+  subslices();
+  chunks();
+  windows();
+  bytes();
+  search();
+  split();
+  return 0;
+}
@@ -0,0 +1,156 @@
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slot_map.h"
+#include <cassert>
+#include <utility>
+
+using namespace mu;
+
+/// Counts the live instances, to check that values are destroyed.
+struct Counted {
+  static inline i64 live = 0;
+
+  u64               val;
+
+  explicit Counted(u64 val) : val{val} { live++; }
+  Counted(Counted&& other) noexcept : val{other.val} { live++; }
+  ~Counted() { live--; }
+};
+
+static auto insertGetRemove() -> void {
+  SlotMap<u64> map{};
+  auto         a = map.insert(1);
+  auto         b = map.insert(2);
+  auto         c = map.insert(3);
+  assert(map.len() == 3);
+  assert(*map.get(a) == 1);
+  assert(*map.get(b) == 2);
+  assert(*map.get(c) == 3);
+
+  // Removing swaps the last value into the hole, without breaking keys
+  assert(map.remove(a));
+  assert(map.len() == 2);
+  assert(map.get(a) == nullptr);
+  assert(!map.contains(a));
+  assert(*map.get(b) == 2);
+  assert(*map.get(c) == 3);
+  assert(!map.remove(a));
+
+  *map.get(b) = 20;
+  assert(*map.get(b) == 20);
+
+  // A default key is never valid
+  assert(!map.contains(SlotMap<u64>::Key{}));
+}
+
+static auto staleKeys() -> void {
+  SlotMap<u64> map{};
+  auto         a = map.insert(1);
+  assert(map.remove(a));
+
+  // The slot is reused, but the old key stays stale
+  auto b = map.insert(2);
+  assert(b.idx == a.idx);
+  assert(b.gen != a.gen);
+  assert(map.get(a) == nullptr);
+  assert(*map.get(b) == 2);
+
+  for (usize i = 0; i < 1000; i++) {
+    auto key = map.insert(i);
+    assert(map.remove(key));
+    assert(!map.contains(key));
+  }
+  assert(map.len() == 1);
+  assert(*map.get(b) == 2);
+}
+
+static auto iteration() -> void {
+  SlotMap<u64>      map{};
+  SlotMap<u64>::Key keys[100];
+  for (u64 i = 0; i < 100; i++) {
+    keys[i] = map.insert(i);
+  }
+  for (u64 i = 0; i < 100; i += 2) {
+    assert(map.remove(keys[i]));
+  }
+
+  // Only the (odd) live values are visited, and `keyAt` finds their keys
+  u64 sum = 0;
+  for (u64 val : map) {
+    assert(val % 2 == 1);
+    sum += val;
+  }
+  assert(sum == 2500);
+
+  Slice<u64> vals = map.values();
+  assert(vals.len() == 50);
+  for (usize i = 0; i < vals.len(); i++) {
+    assert(map.keyAt(i) == keys[vals[i]]);
+  }
+
+  bool threw = false;
+  try {
+    map.keyAt(50);
+  } catch (const common::IndexOutOfBounds&) {
+    threw = true;
+  }
+  assert(threw);
+
+  map.clear();
+  assert(map.len() == 0);
+  assert(!map.contains(keys[1]));
+  assert(map.begin() == map.end());
+}
+
+static auto nonTrivialValues() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    using Map = SlotMap<Counted, mem::Allocator>;
+
+    Map      map{&tracking};
+    Map::Key keys[64];
+    for (u64 i = 0; i < 64; i++) {
+      keys[i] = map.emplace(i);
+    }
+    assert(Counted::live == 64);
+    assert(map.capacity() >= 64);
+
+    for (u64 i = 0; i < 64; i += 4) {
+      assert(map.remove(keys[i]));
+    }
+    assert(Counted::live == 48);
+    assert(map.get(keys[5])->val == 5);
+
+    // Moving transfers the values without copying or destroying them
+    auto moved = std::move(map);
+    assert(map.len() == 0);
+    assert(moved.len() == 48);
+    assert(Counted::live == 48);
+    assert(moved.get(keys[63])->val == 63);
+  }
+  assert(Counted::live == 0);
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto reserve() -> void {
+  SlotMap<u32> map{};
+  map.reserve(1000);
+  assert(map.capacity() >= 1000);
+  u32* first = map.begin();
+  for (u32 i = 0; i < 1000; i++) {
+    map.insert(i);
+  }
+  assert(map.begin() == first);
+}
+
+int main(void) {
+  insertGetRemove();
+  staleKeys();
+  iteration();
+  nonTrivialValues();
+  reserve();
+  return 0;
+}
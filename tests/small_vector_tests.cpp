@@ -0,0 +1,136 @@
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/small_vector.h"
+#include <cassert>
+#include <string>
+#include <utility>
+
+using namespace mu;
+
+/// Counts the live instances, to check that items are moved and destroyed.
+struct Counted {
+  static inline i64 live = 0;
+
+  u64               val;
+
+  explicit Counted(u64 val) : val{val} { live++; }
+  Counted(const Counted& other) : val{other.val} { live++; }
+  Counted(Counted&& other) noexcept : val{other.val} { live++; }
+  ~Counted() { live--; }
+};
+
+/// Sums the items of a slice (as an existing API taking a `Slice` would).
+static auto sum(Slice<u64> items) -> u64 {
+  u64 res = 0;
+  for (usize i = 0; i < items.len(); i++) {
+    res += items[i];
+  }
+  return res;
+}
+
+static auto staysInline() -> void {
+  mem::CAllocator                     backing{};
+  mem::TrackingAllocator              tracking{&backing};
+  SmallVector<u64, 4, mem::Allocator> vec{&tracking};
+  for (u64 i = 1; i <= 4; i++) {
+    vec.append(i);
+  }
+  assert(vec.isInline());
+  assert(vec.len() == 4);
+  assert(vec.capacity() == 4);
+  assert(sum(vec.items()) == 10);
+  assert(tracking.stats().allocs == 0);
+
+  assert(vec.pop().unwrap() == 4);
+  vec.clear();
+  assert(vec.len() == 0);
+
+  bool threw = false;
+  try {
+    vec[0];
+  } catch (const common::IndexOutOfBounds&) {
+    threw = true;
+  }
+  assert(threw);
+}
+
+static auto spills() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    SmallVector<u64, 4, mem::Allocator> vec{&tracking};
+    for (u64 i = 1; i <= 100; i++) {
+      vec.append(i);
+    }
+    assert(!vec.isInline());
+    assert(vec.len() == 100);
+    assert(vec.capacity() >= 100);
+    assert(sum(vec.items()) == 5050);
+    assert(tracking.stats().live_bytes == vec.capacity() * sizeof(u64));
+
+    u64 more[] = {1, 2, 3};
+    vec.appendSlice(Slice<u64>(more, 3));
+    assert(vec[102] == 3);
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto moves() -> void {
+  // Inline items are moved one by one, allocated ones are handed over
+  SmallVector<Counted, 4> small{};
+  small.emplace(1);
+  small.emplace(2);
+  SmallVector<Counted, 4> moved_small = std::move(small);
+  assert(small.len() == 0);
+  assert(moved_small.len() == 2);
+  assert(moved_small[1].val == 2);
+  assert(Counted::live == 2);
+
+  SmallVector<Counted, 4> big{};
+  for (u64 i = 0; i < 10; i++) {
+    big.emplace(i);
+  }
+  Counted*                first     = big.begin();
+  SmallVector<Counted, 4> moved_big = std::move(big);
+  assert(moved_big.begin() == first);
+  assert(big.len() == 0);
+  assert(big.isInline());
+  assert(Counted::live == 12);
+
+  moved_small = std::move(moved_big);
+  assert(moved_small.len() == 10);
+  assert(Counted::live == 10);
+
+  // The popped item is destroyed once, by the `Optional`
+  assert(moved_small.pop().unwrap().val == 9);
+  assert(Counted::live == 9);
+}
+
+static auto popStrings() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    SmallVector<std::string, 4, mem::Allocator> vec{&tracking};
+    for (usize i = 0; i < 6; i++) {
+      // Long enough to be heap-allocated
+      vec.append(std::string(32, char('a' + i)));
+    }
+    assert(vec.pop().unwrap() == std::string(32, 'f'));
+    vec.pop();
+    assert(vec.len() == 4);
+    assert(vec[3] == std::string(32, 'd'));
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+int main(void) {
+  staysInline();
+  spills();
+  moves();
+  popStrings();
+  assert(Counted::live == 0);
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/sort.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace mu;
+
+/// The inputs every sort is checked on: random values (with many or few
+/// duplicates) and the usual patterns.
+static auto patterns(usize len, u64 seed) -> std::vector<std::vector<i64>> {
+  std::mt19937_64  rng{seed};
+  std::vector<i64> random(len), few(len), sorted(len), reversed(len);
+  std::vector<i64> equal(len, 7), organ(len), saw(len), nearly(len);
+  for (usize i = 0; i < len; i++) {
+    random[i]   = static_cast<i64>(rng());
+    few[i]      = static_cast<i64>(rng() % 4) - 2;
+    sorted[i]   = static_cast<i64>(i);
+    reversed[i] = static_cast<i64>(len - i);
+    organ[i]    = static_cast<i64>(std::min(i, len - i));
+    saw[i]      = static_cast<i64>(i % 100);
+    nearly[i]   = static_cast<i64>(i);
+  }
+  for (usize i = 0; (len != 0) && (i < 5); i++) {
+    std::swap(nearly[rng() % len], nearly[rng() % len]);
+  }
+  return {random, few, sorted, reversed, equal, organ, saw, nearly};
+}
+
+static auto matchesStdSort() -> void {
+  for (usize len : {0, 1, 2, 3, 23, 24, 25, 100, 129, 1000, 100000}) {
+    for (std::vector<i64>& input : patterns(len, len)) {
+      std::vector<i64> expected = input;
+      std::sort(expected.begin(), expected.end());
+      std::vector<i64> actual = input;
+      sort(Slice<i64>(actual.data(), actual.size()));
+      assert(actual == expected);
+
+      // Branchless partitions, in the other direction
+      std::sort(expected.begin(), expected.end(), std::greater<i64>());
+      actual = input;
+      sort(Slice<i64>(actual.data(), actual.size()), std::greater<i64>());
+      assert(actual == expected);
+
+      // Partitions that branch on each comparison
+      actual = input;
+      sort(Slice<i64>(actual.data(), actual.size()),
+           [](i64 a, i64 b) { return a > b; });
+      assert(actual == expected);
+    }
+  }
+}
+
+static auto nonTrivialItems() -> void {
+  std::mt19937_64          rng{3};
+  std::vector<std::string> strings;
+  for (usize i = 0; i < 5000; i++) {
+    strings.push_back("item " + std::to_string(rng() % 1000));
+  }
+  std::vector<std::string> expected = strings;
+  std::sort(expected.begin(), expected.end());
+  sort(Slice<std::string>(strings.data(), strings.size()));
+  assert(strings == expected);
+}
+
+static auto heapsortFallback() -> void {
+  // Mostly zeros, so the first partition (around a zero) is unbalanced and
+  // runs out of the allowed bad partitions right away
+  std::vector<i64> input = patterns(10000, 5)[0];
+  for (usize i = 0; i < input.size(); i++) {
+    input[i] = (i % 10 == 0) ? input[i] : 0;
+  }
+  std::vector<i64> expected = input;
+  std::sort(expected.begin(), expected.end());
+  std::less<i64> less{};
+  internal::sort::pdqSort(input.data(), input.data() + input.size(), less, 1,
+                          true);
+  assert(input == expected);
+}
+
+template <typename T> static auto radixMatchesStdSort() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  std::mt19937_64        rng{11};
+  for (usize len : {0, 1, 100, 255, 256, 257, 5000, 100000}) {
+    std::vector<T> input(len);
+    for (T& val : input) {
+      if constexpr (std::is_floating_point_v<T>) {
+        val = static_cast<T>(static_cast<i64>(rng() % 2000000) - 1000000) /
+              T(1000);
+      } else {
+        val = static_cast<T>(rng());
+      }
+    }
+    std::vector<T> expected = input;
+    std::sort(expected.begin(), expected.end());
+
+    u64 allocs = tracking.stats().allocs;
+    radixSort(Slice<T>(input.data(), input.size()), &tracking);
+    assert(input == expected);
+    assert(tracking.stats().allocs - allocs ==
+           ((len < internal::sort::RADIX_SORT_THRESHOLD) ? 0 : 1));
+    assert(tracking.stats().live_bytes == 0);
+  }
+}
+
+static auto radixEdgeCases() -> void {
+  // Passes are skipped when all items share a byte
+  std::vector<u64> same_high(1000);
+  for (usize i = 0; i < same_high.size(); i++) {
+    same_high[i] = (u64(0xabcd) << 48) | ((i * 7919) % 1000);
+  }
+  std::vector<u64> expected = same_high;
+  std::sort(expected.begin(), expected.end());
+  radixSort(Slice<u64>(same_high.data(), same_high.size()));
+  assert(same_high == expected);
+
+  std::vector<i32> ints(300);
+  for (usize i = 0; i < ints.size(); i++) {
+    ints[i] = (i % 2 == 0) ? std::numeric_limits<i32>::min() + i32(i)
+                           : std::numeric_limits<i32>::max() - i32(i);
+  }
+  std::vector<i32> expected_ints = ints;
+  std::sort(expected_ints.begin(), expected_ints.end());
+  radixSort(Slice<i32>(ints.data(), ints.size()));
+  assert(ints == expected_ints);
+
+  constexpr f64    INF = std::numeric_limits<f64>::infinity();
+  std::vector<f64> floats(300);
+  for (usize i = 0; i < floats.size(); i++) {
+    f64 vals[] = {-INF, INF, -0.0, 0.0, -1.5, 1.5, 1e-300, -1e300};
+    floats[i]  = vals[(i * 5) % 8];
+  }
+  radixSort(Slice<f64>(floats.data(), floats.size()));
+  assert(std::is_sorted(floats.begin(), floats.end()));
+  assert((floats.front() == -INF) && (floats.back() == INF));
+
+  // Negative zeros come first
+  auto zero = std::find(floats.begin(), floats.end(), 0.0);
+  assert(std::signbit(*zero));
+
+  // `Slice<u8>` stores `char`s, but the bytes are sorted as unsigned
+  std::vector<u8> input(internal::sort::PARALLEL_SORT_THRESHOLD + 1000);
+  for (usize i = 0; i < input.size(); i++) {
+    input[i] = static_cast<u8>(i * 151);
+  }
+  std::vector<u8> expected_bytes = input;
+  std::sort(expected_bytes.begin(), expected_bytes.end());
+  for (usize variant = 0; variant < 3; variant++) {
+    std::vector<u8> bytes = input;
+    Slice<u8> slice(reinterpret_cast<cstr>(bytes.data()), bytes.size());
+    if (variant == 0) {
+      radixSort(slice);
+    } else if (variant == 1) {
+      sort(slice);
+    } else {
+      parallelSort(slice, 2);
+    }
+    assert(bytes == expected_bytes);
+  }
+}
+
+static auto parallelMatchesStdSort() -> void {
+  for (usize threads : {1, 2, 4}) {
+    for (usize len : {1000, 300000}) {
+      for (std::vector<i64>& input : patterns(len, threads)) {
+        std::vector<i64> expected = input;
+        std::sort(expected.begin(), expected.end());
+        parallelSort(Slice<i64>(input.data(), input.size()), threads);
+        assert(input == expected);
+      }
+    }
+  }
+
+  std::mt19937_64          rng{9};
+  std::vector<std::string> strings;
+  for (usize i = 0; i < 100000; i++) {
+    strings.push_back(std::to_string(rng() % 50000));
+  }
+  std::vector<std::string> expected = strings;
+  std::sort(expected.begin(), expected.end(), std::greater<std::string>());
+  parallelSort(Slice<std::string>(strings.data(), strings.size()), 3,
+               std::greater<std::string>());
+  assert(strings == expected);
+}
+
+auto main() -> int {
+  matchesStdSort();
+  nonTrivialItems();
+  heapsortFallback();
+  radixMatchesStdSort<i8>();
+  radixMatchesStdSort<i16>();
+  radixMatchesStdSort<i32>();
+  radixMatchesStdSort<u64>();
+  radixMatchesStdSort<i64>();
+  radixMatchesStdSort<f32>();
+  radixMatchesStdSort<f64>();
+  radixEdgeCases();
+  parallelMatchesStdSort();
+  return 0;
+}
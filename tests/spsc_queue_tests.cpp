@@ -0,0 +1,117 @@
+#include "mu/mem/allocator.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include "mu/spsc_queue.h"
+#include <cassert>
+#include <string>
+#include <thread>
+
+using namespace mu;
+
+static constexpr u64 ITEMS = 100000;
+
+static auto basics() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    SpscQueue<u64, mem::Allocator> queue{&tracking, 5};
+    assert(queue.capacity() == 8);
+    for (u64 i = 0; i < 8; i++) {
+      assert(queue.tryPush(i));
+    }
+    assert(!queue.tryPush(8));
+    assert(queue.len() == 8);
+
+    u64 val = 0;
+    assert(queue.tryPop(val) && (val == 0));
+    assert(queue.tryPush(8));
+
+    // Batches wrap around the end of the ring
+    u64   out[16] = {};
+    usize popped  = queue.popMany(Slice<u64>(out, 16));
+    assert(popped == 8);
+    for (u64 i = 0; i < 8; i++) {
+      assert(out[i] == i + 1);
+    }
+    assert(!queue.tryPop(val));
+
+    u64 in[10] = {10, 11, 12, 13, 14, 15, 16, 17, 18, 19};
+    assert(queue.pushMany(Slice<u64>(in, 10)) == 8);
+    assert(queue.popMany(Slice<u64>(out, 3)) == 3);
+    assert(out[2] == 12);
+    assert(queue.pushMany(Slice<u64>(in + 8, 2)) == 2);
+    assert(queue.popMany(Slice<u64>(out, 16)) == 7);
+    assert((out[0] == 13) && (out[6] == 19));
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto nonTrivialItems() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  {
+    SpscQueue<std::string, mem::Allocator> queue{&tracking, 4};
+    std::string                            long_str(64, 'x');
+    assert(queue.tryPush(long_str));
+    assert(queue.tryPush(std::string(64, 'y')));
+
+    std::string out;
+    assert(queue.tryPop(out) && (out == long_str));
+
+    // The remaining item is destroyed with the queue
+    assert(queue.tryPush(long_str));
+  }
+  assert(tracking.stats().live_bytes == 0);
+}
+
+static auto concurrentUse() -> void {
+  SpscQueue<u64> queue{nullptr, 1024};
+
+  std::thread    producer([&queue] {
+    u64 batch[32];
+    for (u64 i = 0; i < ITEMS;) {
+      if ((i / 32) % 2 == 0) {
+        if (queue.tryPush(i)) {
+          i++;
+        } else {
+          std::this_thread::yield();
+        }
+      } else {
+        usize len = (ITEMS - i < 32) ? usize(ITEMS - i) : 32;
+        for (usize j = 0; j < len; j++) {
+          batch[j] = i + j;
+        }
+        i += queue.pushMany(Slice<u64>(batch, len));
+      }
+    }
+  });
+
+  // Items arrive in order, whether pushed or popped one by one or in batches
+  u64            next = 0;
+  u64            out[17];
+  while (next < ITEMS) {
+    usize popped = queue.popMany(Slice<u64>(out, 17));
+    for (usize i = 0; i < popped; i++) {
+      assert(out[i] == next);
+      next++;
+    }
+    u64 val;
+    if (queue.tryPop(val)) {
+      assert(val == next);
+      next++;
+    } else if (popped == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+  assert(queue.len() == 0);
+}
+
+int main(void) {
+  basics();
+  nonTrivialItems();
+  concurrentUse();
+  return 0;
+}
@@ -0,0 +1,119 @@
+#include "mu/mem/thread_safe_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+static auto isAligned(void* ptr, usize align) -> bool {
+  return (reinterpret_cast<usize>(ptr) % align) == 0;
+}
+
+static auto sizeClasses() -> void {
+  mem::ThreadSafeAllocator allocator{};
+  std::vector<Slice<char>> slices;
+
+  for (usize len = 1; len <= 20000; len += 37) {
+    Slice<char> slice = allocator.alloc<char>(len);
+    assert(isAligned(slice.ptr(), 16));
+    std::memset(slice.ptr(), static_cast<int>(len & 0x7F), len);
+    slices.push_back(slice);
+  }
+  for (Slice<char> slice : slices) {
+    char expected = static_cast<char>(slice.len() & 0x7F);
+    assert(slice[0] == expected);
+    assert(slice[slice.len() - 1] == expected);
+    allocator.free(slice);
+  }
+
+  // Resizing in place keeps blocks in their size class
+  Slice<char> block = allocator.alloc<char>(100);
+  assert(allocator.resize(block, 110));
+  assert(!allocator.resize(block, 20));
+  assert(!allocator.resize(block, 200));
+  allocator.free(block);
+
+  Slice<u64> aligned = allocator.allocAligned<u64>(3, 64);
+  assert(isAligned(aligned.ptr(), 64));
+  allocator.free(aligned);
+}
+
+static auto manyThreads() -> void {
+  constexpr usize          THREADS = 8;
+  constexpr usize          ROUNDS  = 200;
+  constexpr usize          OBJECTS = 256;
+  mem::ThreadSafeAllocator allocator{};
+
+  std::vector<std::thread> threads;
+  for (usize t = 0; t < THREADS; t++) {
+    threads.emplace_back([&allocator, t] {
+      u64* objs[OBJECTS];
+      for (usize r = 0; r < ROUNDS; r++) {
+        for (usize i = 0; i < OBJECTS; i++) {
+          usize len = 1 + ((i * 7 + t) % 64);
+          objs[i]   = allocator.alloc<u64>(len).ptr();
+          objs[i][0] = (t << 32) | i;
+        }
+        for (usize i = 0; i < OBJECTS; i++) {
+          assert(objs[i][0] == ((t << 32) | i));
+          allocator.free(Slice(objs[i], 1 + ((i * 7 + t) % 64)));
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+static auto crossThreadFree() -> void {
+  constexpr usize          OBJECTS = 10000;
+  mem::ThreadSafeAllocator allocator{};
+  std::vector<int*>        objs(OBJECTS);
+
+  std::thread              producer([&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      objs[i]  = allocator.create<int>();
+      *objs[i] = static_cast<int>(i);
+    }
+  });
+  producer.join();
+
+  std::thread consumer([&] {
+    for (usize i = 0; i < OBJECTS; i++) {
+      assert(*objs[i] == static_cast<int>(i));
+      allocator.destroy(objs[i]);
+    }
+  });
+  consumer.join();
+
+  // Blocks freed on the consumer thread are reused by this thread
+  int* val = allocator.create<int>();
+  *val     = 1;
+  allocator.destroy(val);
+}
+
+static auto multipleAllocators() -> void {
+  for (usize i = 0; i < 20; i++) {
+    mem::ThreadSafeAllocator a{};
+    mem::ThreadSafeAllocator b{};
+    int*                     x = a.create<int>();
+    int*                     y = b.create<int>();
+    *x                         = 1;
+    *y                         = 2;
+    assert(*x == 1);
+    a.destroy(x);
+    b.destroy(y);
+  }
+}
+
+int main(void) {
+  sizeClasses();
+  manyThreads();
+  crossThreadFree();
+  multipleAllocators();
+  return 0;
+}
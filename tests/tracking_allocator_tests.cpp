@@ -0,0 +1,173 @@
+#include "mu/io/writer.h"
+#include "mu/mem/c_allocator.h"
+#include "mu/mem/thread_safe_allocator.h"
+#include "mu/mem/tracking_allocator.h"
+#include "mu/primitives.h"
+#include "mu/slice.h"
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+using namespace mu;
+
+/// A writer that collects everything written to it into a string.
+struct StringWriter : public io::Writer {
+  std::vector<char> buf;
+
+  auto write(Slice<u8> data) -> usize override {
+    const_cstr str = reinterpret_cast<const_cstr>(data.ptr());
+    this->buf.insert(this->buf.end(), str, str + data.len());
+    return data.len();
+  }
+
+  auto formatV(const_cstr fmt, va_list args) -> void override {
+    char tmp[256];
+    int  len = std::vsnprintf(tmp, sizeof(tmp), fmt, args);
+    this->buf.insert(this->buf.end(), tmp, tmp + len);
+  }
+
+  auto contains(const_cstr str) -> bool {
+    this->buf.push_back('\0');
+    bool found = std::strstr(this->buf.data(), str) != nullptr;
+    this->buf.pop_back();
+    return found;
+  }
+};
+
+static auto counters() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+
+  u64*                   val   = tracking.create<u64>();
+  Slice<char>            small = tracking.alloc<char>(100);
+  Slice<u64>             big   = tracking.allocZeroed<u64>(1000);
+
+  auto                   stats = tracking.stats();
+  assert(stats.allocs == 3);
+  assert(stats.frees == 0);
+  assert(stats.live_bytes == 8 + 100 + 8000);
+  assert(stats.histogram[3] == 1);  // 8 bytes
+  assert(stats.histogram[6] == 1);  // 100 bytes
+  assert(stats.histogram[12] == 1); // 8000 bytes
+  assert(big[999] == 0);
+
+  tracking.destroy(val);
+  tracking.free(big);
+  stats = tracking.stats();
+  assert(stats.frees == 2);
+  assert(stats.liveAllocs() == 1);
+  assert(stats.live_bytes == 100);
+  assert(stats.peak_bytes == 8 + 100 + 8000);
+
+  // Reallocations move the live bytes and keep the contents
+  small[99] = 'x';
+  small     = tracking.realloc(small, 5000);
+  assert(small[99] == 'x');
+  stats = tracking.stats();
+  assert(stats.resizes == 1);
+  assert(stats.live_bytes == 5000);
+  tracking.free(small);
+
+  // Over-aligned allocations are tracked too
+  Slice<char> aligned = tracking.allocAligned<char>(10, 256);
+  assert((reinterpret_cast<usize>(aligned.ptr()) % 256) == 0);
+  tracking.free(aligned);
+  assert(tracking.stats().live_bytes == 0);
+
+  tracking.reset();
+  stats = tracking.stats();
+  assert((stats.allocs == 0) && (stats.peak_bytes == 0));
+}
+
+/// An allocator that fails every allocation larger than `limit`, counting
+/// the attempts.
+struct LimitedAllocator : public mem::Allocator {
+  mem::CAllocator backing{};
+  usize           limit;
+  usize           attempts = 0;
+
+  explicit LimitedAllocator(usize limit) : limit{limit} {}
+
+private:
+  auto alloc_fn(usize byte_size, usize align) -> void* override {
+    this->attempts++;
+    return byte_size > this->limit ? nullptr
+                                   : this->backing.rawAlloc(byte_size, align);
+  }
+
+  auto free_fn(void* ptr, usize byte_size, usize align) -> void override {
+    this->backing.rawFree(ptr, byte_size, align);
+  }
+};
+
+static auto failedRealloc() -> void {
+  LimitedAllocator       backing{1000};
+  mem::TrackingAllocator tracking{&backing};
+  void*                  ptr = tracking.rawAlloc(100, 8);
+  assert(ptr != nullptr);
+
+  // A failed realloc asks the backing allocator once, and is one failure
+  backing.attempts = 0;
+  assert(tracking.rawRealloc(ptr, 100, 5000, 8) == nullptr);
+  assert(backing.attempts == 1);
+  auto stats = tracking.stats();
+  assert(stats.failures == 1);
+  assert(stats.live_bytes == 100);
+
+  ptr = tracking.rawRealloc(ptr, 100, 500, 8);
+  assert(ptr != nullptr);
+  assert(tracking.stats().failures == 1);
+  assert(tracking.stats().live_bytes == 500);
+  tracking.rawFree(ptr, 500, 8);
+}
+
+static auto dump() -> void {
+  mem::CAllocator        backing{};
+  mem::TrackingAllocator tracking{&backing};
+  Slice<char>            slice = tracking.alloc<char>(1024);
+
+  StringWriter           writer{};
+  tracking.dump(writer);
+  assert(writer.contains("allocs     = 1"));
+  assert(writer.contains("live_bytes = 1024"));
+  assert(writer.contains("[2^10, 2^11) = 1"));
+  tracking.free(slice);
+}
+
+static auto manyThreads() -> void {
+  constexpr usize          THREADS = 4;
+  constexpr usize          ROUNDS  = 1000;
+  mem::ThreadSafeAllocator backing{};
+  mem::TrackingAllocator   tracking{&backing};
+
+  std::vector<std::thread> threads;
+  for (usize t = 0; t < THREADS; t++) {
+    threads.emplace_back([&] {
+      for (usize i = 0; i < ROUNDS; i++) {
+        Slice<char> slice = tracking.alloc<char>(16 + i);
+        slice[0]          = 'a';
+        tracking.free(slice);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  auto stats = tracking.stats();
+  assert(stats.allocs == THREADS * ROUNDS);
+  assert(stats.frees == THREADS * ROUNDS);
+  assert(stats.live_bytes == 0);
+  assert(stats.peak_bytes >= 16 + ROUNDS - 1);
+}
+
+int main(void) {
+  counters();
+  failedRealloc();
+  dump();
+  manyThreads();
+  return 0;
+}
@@ -1,10 +1,16 @@
+#include "mu/cloneable.h"
 #include "mu/common.h"
 #include "mu/io/file.h"
 #include "mu/mem/c_allocator.h"
+#include "mu/mem/pool_allocator.h"
+#include "mu/mem/tracking_allocator.h"
 #include "mu/mem/unique_ptr.h"
 #include <cassert>
 #include <cstdio>
+#include <new>
+#include <string>
 #include <utility>
+#include <vector>
 
 using namespace mu;
 
@@ -68,6 +74,7 @@ static auto sliceObjects() -> void {
   assert(val[1].y == 2);
   assert(val[1].z == 3);
   assert(val[1].b == true);
+#ifndef MU_SLICE_UNCHECKED
   try {
     assert(val[2].x == 1);
     assert(val[2].y == 2);
@@ -76,6 +83,7 @@ static auto sliceObjects() -> void {
   } catch (common::IndexOutOfBounds& e) {
     io::Stdout().format("%s (index: %zu, lenght: %zu)", e.what(), e.idx, e.len);
   }
+#endif
 
   auto cloned = val.clone();
   val[0].x    = 2;
@@ -98,12 +106,113 @@ static auto sliceObjects() -> void {
   allocator.free(released);
 }
 
+static auto pooledObject() -> void {
+  mem::CAllocator         backing{};
+  mem::PoolAllocator<Tst> pool{&backing};
+
+  {
+    auto val = UniquePtr<Tst, mem::PoolAllocator<Tst>>::create(&pool);
+    assert(val->x == 1);
+    assert(val->b == true);
+
+    auto cloned = val.clone();
+    val->x      = 2;
+    assert(cloned->x == 1);
+  }
+  assert(pool.capacity() == mem::PoolAllocator<Tst>::DEFAULT_BLOCKS_PER_SLAB);
+}
+
+static auto staticAllocator() -> void {
+  static_assert(mem::StaticAllocator<mem::CAllocator>);
+  static_assert(!mem::StaticAllocator<mem::PoolAllocator<Tst>>);
+  static_assert(sizeof(UniquePtr<Tst>) == sizeof(Tst*));
+  static_assert(sizeof(UniquePtr<Tst, mem::Allocator>) ==
+                sizeof(Tst*) + sizeof(mem::Allocator*));
+  static_assert(sizeof(UniquePtr<Slice<Tst>, mem::CAllocator>) ==
+                sizeof(Slice<Tst>));
+
+  mem::CAllocator allocator{};
+  auto            val = UniquePtr<Tst, mem::Allocator>::create(&allocator);
+  assert(val->x == 1);
+  auto cloned = val.clone();
+  assert(cloned->z == 3);
+
+  auto slice = UniquePtr<Slice<Tst>, mem::Allocator>::create(&allocator, 3);
+  assert(slice[2].y == 2);
+
+  // Slices allocate from the allocator they are given by default
+  mem::TrackingAllocator tracking{&allocator};
+  {
+    auto tracked = UniquePtr<Slice<Tst>>::create(&tracking, 4);
+    assert(tracking.stats().allocs == 1);
+    assert(tracking.stats().live_bytes == 4 * sizeof(Tst));
+  }
+  assert(tracking.stats().live_bytes == 0);
+
+  // Passing some other allocator for a static one is an error
+  bool threw = false;
+  try {
+    auto wrong = UniquePtr<Tst>::create(&tracking);
+  } catch (common::AllocatorMismatchException&) {
+    threw = true;
+  }
+  assert(threw);
+  assert(tracking.stats().allocs == 1);
+}
+
+/// A type that owns memory (so it must be constructed before it's assigned).
+struct Named : public Clone<Named> {
+  std::string name;
+
+  explicit Named(std::string name) : name{std::move(name)} {}
+
+  auto _cloneImpl() const -> Named { return Named{this->name}; }
+};
+
+static auto nonTrivialObjects() -> void {
+  mem::CAllocator allocator{};
+
+  auto nums = UniquePtr<std::vector<int>>::create(nullptr,
+                                                  std::vector<int>{1, 2, 3});
+  assert(nums->size() == 3);
+  assert((*nums)[2] == 3);
+
+  const std::string long_name(100, 'x');
+  auto              named  = UniquePtr<Named>::create(nullptr, long_name);
+  auto              cloned = named.clone();
+  named->name             += "y";
+  assert(cloned->name == long_name);
+
+  Named* fresh = allocator.create<Named>();
+  new (fresh) Named{"replaced"};
+  cloned.replace(fresh);
+  assert(cloned->name == "replaced");
+
+  auto names = UniquePtr<Slice<Named>>::create(&allocator, 3, long_name);
+  assert(names[0].name == long_name);
+  assert(names[2].name == long_name);
+  names[1].name  = "changed";
+  auto names2    = names.clone();
+  names[1].name += "!";
+  assert(names2[1].name == "changed");
+  assert(names2[2].name == long_name);
+}
+
 int main(void) {
   // Single object
   singleObject();
 
+  // Single object from a pool
+  pooledObject();
+
   // Slice of objects
-  // sliceObjects();
+  sliceObjects();
+
+  // Static vs dynamic allocators
+  staticAllocator();
+
+  // Objects that must be constructed and destroyed
+  nonTrivialObjects();
 
   return 0;
 }